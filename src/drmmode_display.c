@@ -1360,8 +1360,10 @@ drmmode_xf86crtc_resize(ScrnInfoPtr scrn, int width, int height)
 	}
 
 	ppix = screen->GetScreenPixmap(screen);
-	if (pNv->AccelMethod >= NONE)
+	if (pNv->AccelMethod >= NONE) {
 		nouveau_bo_ref(pNv->scanout, &drmmode_pixmap(ppix)->bo);
+		drmmode_pixmap(ppix)->reusable = FALSE;
+	}
 	screen->ModifyPixmapHeader(ppix, width, height, -1, -1, pitch,
 				   (pNv->AccelMethod > NONE || pNv->ShadowPtr) ?
 				   pNv->ShadowPtr : pNv->scanout->map);
@@ -47,9 +47,14 @@ nouveau_copy_init(ScreenPtr pScreen)
 		{ 0x90b5, 4, nouveau_copy90b5_init },
 		{ 0x85b5, 0, nouveau_copy85b5_init },
 		{}
-	}, *method = methods;
+	}, *method;
 	ScrnInfoPtr pScrn = xf86ScreenToScrn(pScreen);
 	NVPtr pNv = NVPTR(pScrn);
+	struct nv04_fifo nv04_data = { .vram = NvDmaFB,
+				       .gart = NvDmaTT };
+	struct nvc0_fifo nvc0_data = { };
+	struct nve0_fifo nve0_data = { .engine = NVE0_FIFO_ENGINE_CE0 |
+						 NVE0_FIFO_ENGINE_CE1 };
 	void *data;
 	int ret, size;
 
@@ -65,21 +70,15 @@ nouveau_copy_init(ScreenPtr pScreen)
 		    pNv->dev->chipset == 0xaa ||
 		    pNv->dev->chipset == 0xac)
 			return FALSE;
-		data = &(struct nv04_fifo) {
-			.vram = NvDmaFB,
-			.gart = NvDmaTT,
-		};
-		size = sizeof(struct nv04_fifo);
+		data = &nv04_data;
+		size = sizeof(nv04_data);
 		break;
 	case NV_FERMI:
-		data = &(struct nvc0_fifo) {};
-		size = sizeof(struct nvc0_fifo);
+		data = &nvc0_data;
+		size = sizeof(nvc0_data);
 		break;
 	case NV_KEPLER:
-		data = &(struct nve0_fifo) {
-			.engine = NVE0_FIFO_ENGINE_CE0 |
-				  NVE0_FIFO_ENGINE_CE1,
-		};
+		data = &nve0_data;
 		size = sizeof(struct nvc0_fifo);
 		break;
 	default:
@@ -104,7 +103,7 @@ nouveau_copy_init(ScreenPtr pScreen)
 		return FALSE;
 	}
 
-	while (method->init) {
+	for (method = methods; method->init; method++) {
 		ret = nouveau_object_new(pNv->ce_channel,
 					 method->engine << 16 | method->oclass,
 					 method->oclass, NULL, 0,
@@ -118,7 +117,6 @@ nouveau_copy_init(ScreenPtr pScreen)
 			}
 			break;
 		}
-		method++;
 	}
 
 	if (ret) {
@@ -95,12 +95,13 @@ nouveau_dri2_create_buffer2(ScreenPtr pScreen, DrawablePtr pDraw, unsigned int a
 
 	if (ppix) {
 		nvpix = nouveau_pixmap(ppix);
-		if (!nvpix || !nvpix->bo ||
+		if (!nvpix || !nvpix->bo || !nouveau_pixmap_unslab(ppix) ||
 		    nouveau_bo_name_get(nvpix->bo, &nvbuf->base.name)) {
 			pScreen->DestroyPixmap(nvbuf->ppix);
 			free(nvbuf);
 			return NULL;
 		}
+		nvpix->reusable = FALSE;
 	}
 	return &nvbuf->base;
 }
@@ -257,11 +258,16 @@ update_front(DrawablePtr draw, DRI2BufferPtr front)
 	pixmap->refcnt++;
 
 	exaMoveInPixmap(pixmap);
+	if (!nouveau_pixmap_unslab(pixmap)) {
+		(*draw->pScreen->DestroyPixmap)(pixmap);
+		return FALSE;
+	}
 	r = nouveau_bo_name_get(nouveau_pixmap_bo(pixmap), &front->name);
 	if (r) {
 		(*draw->pScreen->DestroyPixmap)(pixmap);
 		return FALSE;
 	}
+	nouveau_pixmap(pixmap)->reusable = FALSE;
 
 	if (nvbuf->ppix)
 		(*draw->pScreen->DestroyPixmap)(nvbuf->ppix);
@@ -1089,6 +1095,7 @@ static PixmapPtr nouveau_dri3_pixmap_from_fd(ScreenPtr screen, int fd, CARD16 wi
 	nouveau_bo_ref(NULL, &nvpix->bo);
 	nvpix->bo = bo;
 	nvpix->shared = (bo->flags & NOUVEAU_BO_APER) == NOUVEAU_BO_GART;
+	nvpix->reusable = FALSE;
 	return pixmap;
 
 free_pixmap:
@@ -1098,11 +1105,16 @@ free_pixmap:
 
 static int nouveau_dri3_fd_from_pixmap(ScreenPtr screen, PixmapPtr pixmap, CARD16 *stride, CARD32 *size)
 {
-	struct nouveau_bo *bo = nouveau_pixmap_bo(pixmap);
+	struct nouveau_bo *bo;
 	int fd;
 
+	if (!nouveau_pixmap_unslab(pixmap))
+		return -EINVAL;
+
+	bo = nouveau_pixmap_bo(pixmap);
 	if (!bo || nouveau_bo_set_prime(bo, &fd) < 0)
 		return -EINVAL;
+	nouveau_pixmap(pixmap)->reusable = FALSE;
 
 	*stride = pixmap->devKind;
 	*size = bo->size;
@@ -20,20 +20,27 @@
  * SOFTWARE.
  */
 
+#include <time.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/utsname.h>
+
 #include "nv_include.h"
 #include "exa.h"
+#include "mipict.h"
 
 #include "hwdefs/nv_m2mf.xml.h"
 
 static inline Bool
 NVAccelMemcpyRect(char *dst, const char *src, int height, int dst_pitch,
-		  int src_pitch, int line_len)
+		  int src_pitch, int line_len,
+		  void (*copy)(void *, const void *, size_t))
 {
 	if ((src_pitch == line_len) && (src_pitch == dst_pitch)) {
-		memcpy(dst, src, line_len*height);
+		copy(dst, src, line_len*height);
 	} else {
 		while (height--) {
-			memcpy(dst, src, line_len);
+			copy(dst, src, line_len);
 			src += src_pitch;
 			dst += dst_pitch;
 		}
@@ -42,12 +49,19 @@ NVAccelMemcpyRect(char *dst, const char *src, int height, int dst_pitch,
 	return TRUE;
 }
 
-Bool
-NVAccelM2MF(NVPtr pNv, int w, int h, int cpp, uint32_t srcoff, uint32_t dstoff,
-	    struct nouveau_bo *src, int sd, int sp, int sh, int sx, int sy,
-	    struct nouveau_bo *dst, int dd, int dp, int dh, int dx, int dy)
+static inline Bool
+nouveau_exa_ce(NVPtr pNv)
+{
+	return pNv->ce_rect && pNv->ce_enabled;
+}
+
+static Bool
+NVAccelRectCopy(NVPtr pNv, Bool ce, int w, int h, int cpp,
+		uint32_t srcoff, uint32_t dstoff,
+		struct nouveau_bo *src, int sd, int sp, int sh, int sx, int sy,
+		struct nouveau_bo *dst, int dd, int dp, int dh, int dx, int dy)
 {
-	if (pNv->ce_rect && pNv->ce_enabled)
+	if (ce)
 		return pNv->ce_rect(pNv->ce_pushbuf, pNv->NvCopy, w, h, cpp,
 				    src, srcoff, sd, sp, sh, sx, sy,
 				    dst, dstoff, dd, dp, dh, dx, dy);
@@ -73,34 +87,388 @@ NVAccelM2MF(NVPtr pNv, int w, int h, int cpp, uint32_t srcoff, uint32_t dstoff,
 	return FALSE;
 }
 
+Bool
+NVAccelM2MF(NVPtr pNv, int w, int h, int cpp, uint32_t srcoff, uint32_t dstoff,
+	    struct nouveau_bo *src, int sd, int sp, int sh, int sx, int sy,
+	    struct nouveau_bo *dst, int dd, int dp, int dh, int dx, int dy)
+{
+	return NVAccelRectCopy(pNv, nouveau_exa_ce(pNv), w, h, cpp,
+			       srcoff, dstoff, src, sd, sp, sh, sx, sy,
+			       dst, dd, dp, dh, dx, dy);
+}
+
+/* Pixmap fences
+ *
+ * Each block of commands submitted from the block handler gets a sequence
+ * number, and every pixmap remembers the sequence it was last read and
+ * written by the GPU in.  Commands are executed in order, so once we've
+ * waited on a pixmap, everything submitted before the commands that last
+ * touched it is known to be complete.  That lets PrepareAccess skip the
+ * wait entirely for pixmaps the GPU is done with, and only wait on the
+ * pixmap itself (writes only, for read access) otherwise.
+ *
+ * Anything that has the GPU write to a pixmap must call this (the EXA
+ * Prepare* wrappers below, uploads, Xv), it's also what invalidates the
+ * pixmap's linear mirror.  A missed call means stale CPU reads.
+ */
+void
+nouveau_pixmap_fence(PixmapPtr ppix, uint32_t access)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(ppix->drawable.pScreen));
+	struct nouveau_pixmap *nvpix = nouveau_pixmap(ppix);
+
+	if (!nvpix)
+		return;
+
+	if (access & NOUVEAU_BO_RD)
+		nvpix->rd_seq = pNv->fence_seq;
+	if (access & NOUVEAU_BO_WR) {
+		nvpix->wr_seq = pNv->fence_seq;
+		nvpix->mirror_valid = FALSE;
+	}
+}
+
+/* same, for transfers that may have gone through the copy engine */
+static void
+nouveau_exa_m2mf_fence(NVPtr pNv, PixmapPtr ppix, uint32_t access, Bool ce)
+{
+	struct nouveau_pixmap *nvpix = nouveau_pixmap(ppix);
+
+	if (!ce) {
+		nouveau_pixmap_fence(ppix, access);
+		return;
+	}
+
+	if (access & NOUVEAU_BO_RD)
+		nvpix->rd_seq = NOUVEAU_FENCE_UNKNOWN;
+	if (access & NOUVEAU_BO_WR) {
+		nvpix->wr_seq = NOUVEAU_FENCE_UNKNOWN;
+		nvpix->mirror_valid = FALSE;
+	}
+}
+
 static int
 nouveau_exa_mark_sync(ScreenPtr pScreen)
 {
-	return 0;
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+
+	return pNv->fence_seq;
 }
 
 static void
 nouveau_exa_wait_marker(ScreenPtr pScreen, int marker)
 {
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+
+	/* PrepareAccess does the per-pixmap waiting, all that's needed here
+	 * is to make sure the commands have actually been submitted
+	 */
+	if ((uint32_t)marker == pNv->fence_seq)
+		NVAccelKick(pNv);
+}
+
+static Bool
+nouveau_exa_prepare_solid(PixmapPtr pdpix, int alu, Pixel planemask, Pixel fg)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+
+	nouveau_stats_begin(pNv->pushbuf, NOUVEAU_STATS_SOLID);
+	if (!pNv->exa_prepare_solid(pdpix, alu, planemask, fg)) {
+		nouveau_stats_end(pNv->pushbuf);
+		return FALSE;
+	}
+
+	nouveau_pixmap_fence(pdpix, NOUVEAU_BO_WR);
+	return TRUE;
+}
+
+static Bool
+nouveau_exa_prepare_copy(PixmapPtr pspix, PixmapPtr pdpix, int dx, int dy,
+			 int alu, Pixel planemask)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+
+	nouveau_stats_begin(pNv->pushbuf, NOUVEAU_STATS_COPY);
+	if (!pNv->exa_prepare_copy(pspix, pdpix, dx, dy, alu, planemask)) {
+		nouveau_stats_end(pNv->pushbuf);
+		return FALSE;
+	}
+
+	nouveau_pixmap_fence(pspix, NOUVEAU_BO_RD);
+	nouveau_pixmap_fence(pdpix, NOUVEAU_BO_WR);
+	return TRUE;
+}
+
+static Bool
+nouveau_exa_check_composite(int op, PicturePtr pspict, PicturePtr pmpict,
+			    PicturePtr pdpict)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpict->pDrawable->pScreen));
+
+	nouveau_fallback_last = NULL;
+	if (!pNv->exa_check_composite(op, pspict, pmpict, pdpict)) {
+		nouveau_fallback_composite(nouveau_fallback_last, op,
+					   pspict, pmpict, pdpict);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static Bool
+nouveau_exa_prepare_composite(int op, PicturePtr pspict, PicturePtr pmpict,
+			      PicturePtr pdpict, PixmapPtr pspix,
+			      PixmapPtr pmpix, PixmapPtr pdpix)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+
+	nouveau_stats_begin(pNv->pushbuf, NOUVEAU_STATS_COMPOSITE);
+	nouveau_fallback_last = NULL;
+	if (!pNv->exa_prepare_composite(op, pspict, pmpict, pdpict,
+					pspix, pmpix, pdpix)) {
+		nouveau_fallback_composite(nouveau_fallback_last, op,
+					   pspict, pmpict, pdpict);
+		nouveau_stats_end(pNv->pushbuf);
+		return FALSE;
+	}
+
+	if (pspix)
+		nouveau_pixmap_fence(pspix, NOUVEAU_BO_RD);
+	if (pmpix)
+		nouveau_pixmap_fence(pmpix, NOUVEAU_BO_RD);
+	nouveau_pixmap_fence(pdpix, NOUVEAU_BO_WR);
+	return TRUE;
+}
+
+static void
+nouveau_exa_done_solid(PixmapPtr pdpix)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+
+	pNv->exa_done_solid(pdpix);
+	nouveau_stats_end(pNv->pushbuf);
+}
+
+static void
+nouveau_exa_done_copy(PixmapPtr pdpix)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+
+	pNv->exa_done_copy(pdpix);
+	nouveau_stats_end(pNv->pushbuf);
+}
+
+static void
+nouveau_exa_done_composite(PixmapPtr pdpix)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+
+	pNv->exa_done_composite(pdpix);
+	nouveau_stats_end(pNv->pushbuf);
+}
+
+/* Linear mirrors
+ *
+ * Without wfb the CPU can't access tiled pixmaps directly.  Instead, the
+ * pixmap is detiled into a linear GART buffer with the same pitch, and
+ * the CPU works on that.  After write access the whole mirror is tiled
+ * back: EXA doesn't say what was touched, and the copy is cheaper than
+ * working it out on the CPU.
+ *
+ * Mirrors of private pixmaps are kept around, and stay valid until the
+ * GPU next writes to the pixmap.  They're on a list, most recently used
+ * first, and the least recently used ones are dropped to keep them under
+ * NOUVEAU_MIRROR_MAX_SIZE.  Scanout and shared pixmaps can change behind
+ * our back, so their mirrors are dropped after each access.
+ *
+ * A valid mirror relies on every GPU write to the pixmap going through
+ * nouveau_pixmap_fence(), see there.
+ */
+#define NOUVEAU_MIRROR_MAX_SIZE(pNv) ((pNv)->dev->gart_size / 8)
+
+static void
+nouveau_exa_mirror_unlink(NVPtr pNv, struct nouveau_pixmap *nvpix)
+{
+	struct nouveau_pixmap **pp;
+
+	for (pp = &pNv->mirrors; *pp; pp = &(*pp)->mirror_next) {
+		if (*pp == nvpix) {
+			*pp = nvpix->mirror_next;
+			break;
+		}
+	}
+	nvpix->mirror_next = NULL;
+}
+
+static void
+nouveau_exa_mirror_drop(NVPtr pNv, struct nouveau_pixmap *nvpix)
+{
+	if (!nvpix->mirror)
+		return;
+
+	nouveau_exa_mirror_unlink(pNv, nvpix);
+	pNv->mirror_size -= nvpix->mirror->size;
+	nouveau_bo_ref(NULL, &nvpix->mirror);
+	nvpix->mirror_valid = FALSE;
+}
+
+/* make room for size more bytes of mirrors, the ones in use stay */
+static void
+nouveau_exa_mirror_evict(NVPtr pNv, uint64_t size)
+{
+	while (pNv->mirror_size + size > NOUVEAU_MIRROR_MAX_SIZE(pNv)) {
+		struct nouveau_pixmap *nvpix, *lru = NULL;
+
+		for (nvpix = pNv->mirrors; nvpix; nvpix = nvpix->mirror_next) {
+			if (!nvpix->mirror_access)
+				lru = nvpix;
+		}
+
+		if (!lru)
+			break;
+		nouveau_exa_mirror_drop(pNv, lru);
+	}
+}
+
+static Bool
+nouveau_exa_mirror_copy(NVPtr pNv, PixmapPtr ppix, int y, int h, Bool detile)
+{
+	struct nouveau_pixmap *nvpix = nouveau_pixmap(ppix);
+	int pitch = exaGetPixmapPitch(ppix);
+	int cpp = ppix->drawable.bitsPerPixel >> 3;
+	int ph = ppix->drawable.height;
+
+	while (h) {
+		const int lines = (h > 2047) ? 2047 : h;
+		Bool ret;
+
+		if (detile)
+			ret = NVAccelM2MF(pNv, pitch / cpp, lines, cpp,
+					  nvpix->offset, 0,
+					  nvpix->bo, NOUVEAU_BO_VRAM, pitch,
+					  ph, 0, y, nvpix->mirror,
+					  NOUVEAU_BO_GART, pitch, ph, 0, y);
+		else
+			ret = NVAccelM2MF(pNv, pitch / cpp, lines, cpp,
+					  0, nvpix->offset,
+					  nvpix->mirror, NOUVEAU_BO_GART, pitch,
+					  ph, 0, y, nvpix->bo,
+					  NOUVEAU_BO_VRAM, pitch, ph, 0, y);
+		if (!ret)
+			return FALSE;
+
+		h -= lines;
+		y += lines;
+	}
+
+	nouveau_exa_m2mf_fence(pNv, ppix, detile ? NOUVEAU_BO_RD :
+				NOUVEAU_BO_WR, nouveau_exa_ce(pNv));
+	nvpix->mirror_valid = TRUE;
+	return TRUE;
+}
+
+static Bool
+nouveau_exa_mirror_prepare(NVPtr pNv, PixmapPtr ppix, Bool read)
+{
+	struct nouveau_pixmap *nvpix = nouveau_pixmap(ppix);
+	int size = exaGetPixmapPitch(ppix) * ppix->drawable.height;
+
+	if (nvpix->mirror) {
+		nouveau_exa_mirror_unlink(pNv, nvpix);
+	} else {
+		nouveau_exa_mirror_evict(pNv, size);
+		if (nouveau_bo_new(pNv->dev, NOUVEAU_BO_GART | NOUVEAU_BO_MAP,
+				   0, size, NULL, &nvpix->mirror))
+			return FALSE;
+		pNv->mirror_size += nvpix->mirror->size;
+		nvpix->mirror_valid = FALSE;
+	}
+	nvpix->mirror_next = pNv->mirrors;
+	pNv->mirrors = nvpix;
+
+	if (!nvpix->mirror_valid) {
+		if (!nouveau_exa_mirror_copy(pNv, ppix, 0,
+					     ppix->drawable.height, TRUE))
+			goto fail;
+	}
+
+	/* waits for the detile, or for a previous copy back to finish */
+	if (nouveau_bo_map(nvpix->mirror, NOUVEAU_BO_RDWR, pNv->client))
+		goto fail;
+
+	nvpix->mirror_access = read ? NOUVEAU_BO_RD : NOUVEAU_BO_RDWR;
+	ppix->devPrivate.ptr = nvpix->mirror->map;
+	return TRUE;
+
+fail:
+	nouveau_exa_mirror_drop(pNv, nvpix);
+	return FALSE;
+}
+
+static void
+nouveau_exa_mirror_finish(NVPtr pNv, PixmapPtr ppix)
+{
+	struct nouveau_pixmap *nvpix = nouveau_pixmap(ppix);
+
+	if ((nvpix->mirror_access & NOUVEAU_BO_WR) &&
+	    !nouveau_exa_mirror_copy(pNv, ppix, 0, ppix->drawable.height,
+				     FALSE))
+		ErrorF("%s: failed to copy back mirror\n", __func__);
+
+	nvpix->mirror_access = 0;
+	if (!(nvpix->reusable || nvpix->slab))
+		nouveau_exa_mirror_drop(pNv, nvpix);
 }
 
 static Bool
 nouveau_exa_prepare_access(PixmapPtr ppix, int index)
 {
-	struct nouveau_bo *bo = nouveau_pixmap_bo(ppix);
+	struct nouveau_pixmap *nvpix = nouveau_pixmap(ppix);
+	struct nouveau_bo *bo = nvpix->bo;
 	NVPtr pNv = NVPTR(xf86ScreenToScrn(ppix->drawable.pScreen));
+	Bool read = (index == EXA_PREPARE_SRC || index == EXA_PREPARE_MASK);
+	uint32_t access = read ? NOUVEAU_BO_RD : NOUVEAU_BO_RDWR;
+	uint32_t seq;
+
+	if (nv50_style_tiled_pixmap(ppix) && !pNv->wfb_enabled) {
+		if (!pNv->linear_mirror)
+			return FALSE;
+		return nouveau_exa_mirror_prepare(pNv, ppix, read);
+	}
 
-	if (nv50_style_tiled_pixmap(ppix) && !pNv->wfb_enabled)
-		return FALSE;
-	if (nouveau_bo_map(bo, NOUVEAU_BO_RDWR, pNv->client))
+	/* reading only has to wait for GPU writes */
+	seq = nvpix->wr_seq;
+	if (!read && nvpix->rd_seq > seq)
+		seq = nvpix->rd_seq;
+
+	/* we can't know what other processes do with exported BOs */
+	if (seq <= pNv->fence_done && (nvpix->reusable || nvpix->slab))
+		access = 0;
+
+	if (nouveau_bo_map(bo, access, pNv->client))
 		return FALSE;
-	ppix->devPrivate.ptr = bo->map;
+
+	if (access) {
+		if (seq && seq != NOUVEAU_FENCE_UNKNOWN &&
+		    seq - 1 > pNv->fence_done)
+			pNv->fence_done = seq - 1;
+		nvpix->wr_seq = 0;
+		if (!read)
+			nvpix->rd_seq = 0;
+	}
+
+	ppix->devPrivate.ptr = (char *)bo->map + nvpix->offset;
 	return TRUE;
 }
 
 static void
 nouveau_exa_finish_access(PixmapPtr ppix, int index)
 {
+	struct nouveau_pixmap *nvpix = nouveau_pixmap(ppix);
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(ppix->drawable.pScreen));
+
+	if (nvpix && nvpix->mirror_access)
+		nouveau_exa_mirror_finish(pNv, ppix);
 }
 
 static Bool
@@ -128,6 +496,13 @@ nouveau_exa_create_pixmap(ScreenPtr pScreen, int width, int height, int depth,
 	if (!nvpix)
 		return NULL;
 
+	/* recycled storage may still be busy with the previous owner */
+	nvpix->rd_seq = nvpix->wr_seq = pNv->fence_seq;
+
+	if (nouveau_allocate_surface_slab(scrn, width, height, bitsPerPixel,
+					  usage_hint, new_pitch, nvpix))
+		return nvpix;
+
 	ret = nouveau_allocate_surface(scrn, width, height, bitsPerPixel,
 				       usage_hint, new_pitch, &nvpix->bo);
 	if (!ret) {
@@ -139,6 +514,8 @@ nouveau_exa_create_pixmap(ScreenPtr pScreen, int width, int height, int depth,
 	if ((usage_hint & 0xffff) == CREATE_PIXMAP_USAGE_SHARED)
 		nvpix->shared = TRUE;
 #endif
+	nvpix->reusable = !nvpix->shared &&
+			  !(usage_hint & NOUVEAU_CREATE_PIXMAP_SCANOUT);
 
 	return nvpix;
 }
@@ -151,7 +528,14 @@ nouveau_exa_destroy_pixmap(ScreenPtr pScreen, void *priv)
 	if (!nvpix)
 		return;
 
-	nouveau_bo_ref(NULL, &nvpix->bo);
+	nouveau_exa_mirror_drop(NVPTR(xf86ScreenToScrn(pScreen)), nvpix);
+	if (nvpix->slab)
+		nouveau_slab_free(xf86ScreenToScrn(pScreen), nvpix);
+	else
+	if (nvpix->bo && nvpix->reusable)
+		nouveau_bo_cache_put(xf86ScreenToScrn(pScreen), nvpix->bo);
+	else
+		nouveau_bo_ref(NULL, &nvpix->bo);
 	free(nvpix);
 }
 
@@ -159,17 +543,22 @@ nouveau_exa_destroy_pixmap(ScreenPtr pScreen, void *priv)
 static Bool
 nouveau_exa_share_pixmap_backing(PixmapPtr ppix, ScreenPtr slave, void **handle_p)
 {
-	struct nouveau_bo *bo = nouveau_pixmap_bo(ppix);
 	struct nouveau_pixmap *nvpix = nouveau_pixmap(ppix);
+	struct nouveau_bo *bo;
 	int ret;
 	int handle;
 
+	if (!nouveau_pixmap_unslab(ppix))
+		return FALSE;
+
+	bo = nouveau_pixmap_bo(ppix);
 	ret = nouveau_bo_set_prime(bo, &handle);
 	if (ret != 0) {
 		ErrorF("%s: ret is %d errno is %d\n", __func__, ret, errno);
 		return FALSE;
 	}
 	nvpix->shared = TRUE;
+	nvpix->reusable = FALSE;
 	*handle_p = (void *)(long)handle;
 	return TRUE;
 }
@@ -189,8 +578,12 @@ nouveau_exa_set_shared_pixmap_backing(PixmapPtr ppix, void *handle)
 		ErrorF("failed to get BO with handle %d\n", ihandle);
 		return FALSE;
 	}
+	if (nvpix->slab)
+		nouveau_slab_free(pScrn, nvpix);
+	nouveau_exa_mirror_drop(pNv, nvpix);
 	nvpix->bo = bo;
 	nvpix->shared = TRUE;
+	nvpix->reusable = FALSE;
 	close(ihandle);
 	return TRUE;
 }
@@ -206,46 +599,103 @@ nv50_style_tiled_pixmap(PixmapPtr ppix)
 	       nouveau_pixmap_bo(ppix)->config.nv50.memtype;
 }
 
-static int
-nouveau_exa_scratch(NVPtr pNv, int size, struct nouveau_bo **pbo, int *off)
+int
+nouveau_exa_scratch(NVPtr pNv, int size, Bool own_slot,
+		    struct nouveau_bo **pbo, int *off)
 {
 	struct nouveau_bo *bo;
+	int slot = pNv->transfer_slot;
 	int ret;
 
-	if (!pNv->transfer ||
-	     pNv->transfer->size <= pNv->transfer_offset + size) {
-		ret = nouveau_bo_new(pNv->dev, NOUVEAU_BO_GART | NOUVEAU_BO_MAP,
-				     0, NOUVEAU_ALIGN(size, 1 * 1024 * 1024),
-				     NULL, &bo);
-		if (ret != 0)
-			return ret;
-
-		ret = nouveau_bo_map(bo, NOUVEAU_BO_RDWR, pNv->client);
-		if (ret != 0) {
-			nouveau_bo_ref(NULL, &bo);
-			return ret;
-		}
+	if (!own_slot && pNv->transfer[slot].bo &&
+	    pNv->transfer[slot].bo->size >= pNv->transfer[slot].offset + size)
+		goto done;
+
+	/* current slot is full (or the caller wants a fence of its own),
+	 * move on to the oldest one and wait for the GPU to finish with any
+	 * transfers still using it
+	 */
+	slot = (slot + 1) % NOUVEAU_TRANSFER_SLOTS;
+	pNv->transfer_slot = slot;
+	pNv->transfer[slot].offset = 0;
+
+	bo = pNv->transfer[slot].bo;
+	if (bo && bo->size >= size) {
+		ret = nouveau_bo_wait(bo, NOUVEAU_BO_RDWR, pNv->client);
+		if (ret == 0)
+			goto done;
+	}
 
-		nouveau_bo_ref(bo, &pNv->transfer);
+	ret = nouveau_bo_new(pNv->dev, NOUVEAU_BO_GART | NOUVEAU_BO_MAP,
+			     0, NOUVEAU_ALIGN(size, 1 * 1024 * 1024),
+			     NULL, &bo);
+	if (ret != 0)
+		return ret;
+
+	ret = nouveau_bo_map(bo, NOUVEAU_BO_RDWR, pNv->client);
+	if (ret != 0) {
 		nouveau_bo_ref(NULL, &bo);
-		pNv->transfer_offset = 0;
+		return ret;
 	}
 
-	*off = pNv->transfer_offset;
-	*pbo = pNv->transfer;
+	nouveau_bo_ref(bo, &pNv->transfer[slot].bo);
+	nouveau_bo_ref(NULL, &bo);
 
-	pNv->transfer_offset += size;
+done:
+	*off = pNv->transfer[slot].offset;
+	*pbo = pNv->transfer[slot].bo;
+
+	pNv->transfer[slot].offset += size;
 	return 0;
 }
 
+struct nouveau_exa_chunk {
+	struct nouveau_bo *bo;
+	int offset;
+	int lines;
+};
+
 static Bool
-nouveau_exa_download_from_screen(PixmapPtr pspix, int x, int y, int w, int h,
-				 char *dst, int dst_pitch)
+nouveau_exa_download_queue(NVPtr pNv, PixmapPtr pspix, int x, int y, int w,
+			   int lines, struct nouveau_exa_chunk *chunk)
+{
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+	int cpp = pspix->drawable.bitsPerPixel >> 3;
+
+	if (nouveau_exa_ce(pNv))
+		push = pNv->ce_pushbuf;
+
+	/* each chunk gets a slot to itself, so waiting on it doesn't also
+	 * wait for the copies queued behind it
+	 */
+	if (nouveau_exa_scratch(pNv, lines * w * cpp, TRUE,
+				&chunk->bo, &chunk->offset))
+		return FALSE;
+
+	if (!NVAccelM2MF(pNv, w, lines, cpp,
+			 nouveau_pixmap_offset(pspix), chunk->offset,
+			 nouveau_pixmap_bo(pspix), NOUVEAU_BO_VRAM,
+			 exaGetPixmapPitch(pspix), pspix->drawable.height,
+			 x, y, chunk->bo, NOUVEAU_BO_GART, w * cpp,
+			 lines, 0, 0)) {
+		chunk->bo = NULL;
+		return FALSE;
+	}
+
+	PUSH_KICK(push);
+	chunk->lines = lines;
+	return TRUE;
+}
+
+static Bool
+nouveau_exa_download(PixmapPtr pspix, int x, int y, int w, int h,
+		     char *dst, int dst_pitch)
 {
 	ScrnInfoPtr pScrn = xf86ScreenToScrn(pspix->drawable.pScreen);
 	NVPtr pNv = NVPTR(pScrn);
+	struct nouveau_exa_chunk cur, next;
 	struct nouveau_bo *bo;
-	int src_pitch, tmp_pitch, cpp, i;
+	int src_pitch, tmp_pitch, cpp, max_lines;
 	const char *src;
 	Bool ret;
 
@@ -253,61 +703,89 @@ nouveau_exa_download_from_screen(PixmapPtr pspix, int x, int y, int w, int h,
 	src_pitch  = exaGetPixmapPitch(pspix);
 	tmp_pitch = w * cpp;
 
-	while (h) {
-		const int lines = (h > 2047) ? 2047 : h;
-		struct nouveau_bo *tmp;
-		int tmp_offset;
+	/* keep chunks small enough that the GPU copy of the next one
+	 * overlaps the memcpy out of the current one
+	 */
+	max_lines = (1 * 1024 * 1024) / tmp_pitch;
+	if (max_lines > 2047)
+		max_lines = 2047;
+	if (max_lines < 1)
+		max_lines = 1;
 
-		if (nouveau_exa_scratch(pNv, lines * tmp_pitch,
-					&tmp, &tmp_offset))
-			goto memcpy;
+	if (!nouveau_exa_download_queue(pNv, pspix, x, y, w,
+					h > max_lines ? max_lines : h, &cur))
+		goto memcpy;
 
-		if (!NVAccelM2MF(pNv, w, lines, cpp, 0, tmp_offset,
-				 nouveau_pixmap_bo(pspix), NOUVEAU_BO_VRAM,
-				 src_pitch, pspix->drawable.height, x, y,
-				 tmp, NOUVEAU_BO_GART, tmp_pitch,
-				 lines, 0, 0))
-			goto memcpy;
+	while (h) {
+		int left = h - cur.lines;
 
-		nouveau_bo_wait(tmp, NOUVEAU_BO_RD, pNv->client);
-		if (dst_pitch == tmp_pitch) {
-			memcpy(dst, tmp->map + tmp_offset, dst_pitch * lines);
-			dst += dst_pitch * lines;
-		} else {
-			src = tmp->map + tmp_offset;
-			for (i = 0; i < lines; i++) {
-				memcpy(dst, src, tmp_pitch);
-				src += tmp_pitch;
-				dst += dst_pitch;
-			}
-		}
+		/* queue the copy of the next chunk before waiting on this one */
+		next.bo = NULL;
+		if (left)
+			nouveau_exa_download_queue(pNv, pspix, x, y + cur.lines,
+						   w, left > max_lines ?
+						   max_lines : left, &next);
+
+		nouveau_bo_wait(cur.bo, NOUVEAU_BO_RD, pNv->client);
+		NVAccelMemcpyRect(dst, (char *)cur.bo->map + cur.offset,
+				  cur.lines, dst_pitch, tmp_pitch, tmp_pitch,
+				  nouveau_memcpy_from_wc);
 
 		/* next! */
-		h -= lines;
-		y += lines;
+		dst += dst_pitch * cur.lines;
+		h -= cur.lines;
+		y += cur.lines;
+
+		if (h && !next.bo)
+			goto memcpy;
+		cur = next;
 	}
 	return TRUE;
 
 memcpy:
-	bo = nouveau_pixmap_bo(pspix);
+	/* let EXA go through PrepareAccess, which knows about tiling */
 	if (nv50_style_tiled_pixmap(pspix))
-		ErrorF("%s:%d - falling back to memcpy ignores tiling\n",
-		       __func__, __LINE__);
+		return FALSE;
+
+	bo = nouveau_pixmap_bo(pspix);
 
 	if (nouveau_bo_map(bo, NOUVEAU_BO_RD, pNv->client))
 		return FALSE;
-	src = (char *)bo->map + (y * src_pitch) + (x * cpp);
-	ret = NVAccelMemcpyRect(dst, src, h, dst_pitch, src_pitch, w*cpp);
+	src = (char *)bo->map + nouveau_pixmap_offset(pspix) +
+	      (y * src_pitch) + (x * cpp);
+	ret = NVAccelMemcpyRect(dst, src, h, dst_pitch, src_pitch, w*cpp,
+				nouveau_memcpy_from_wc);
 	return ret;
 }
 
 static Bool
-nouveau_exa_upload_to_screen(PixmapPtr pdpix, int x, int y, int w, int h,
-			     char *src, int src_pitch)
+nouveau_exa_download_from_screen(PixmapPtr pspix, int x, int y, int w, int h,
+				 char *dst, int dst_pitch)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pspix->drawable.pScreen));
+	Bool ret;
+
+	nouveau_stats_begin(pNv->pushbuf, NOUVEAU_STATS_DOWNLOAD);
+	ret = nouveau_exa_download(pspix, x, y, w, h, dst, dst_pitch);
+	nouveau_stats_end(pNv->pushbuf);
+	return ret;
+}
+
+enum {
+	NOUVEAU_UPLOAD_INLINE = 0,
+	NOUVEAU_UPLOAD_M2MF,
+	NOUVEAU_UPLOAD_COPY,
+	NOUVEAU_UPLOAD_METHODS
+};
+
+static Bool
+nouveau_exa_upload(PixmapPtr pdpix, int method, int x, int y, int w, int h,
+		   char *src, int src_pitch)
 {
 	ScrnInfoPtr pScrn = xf86ScreenToScrn(pdpix->drawable.pScreen);
 	NVPtr pNv = NVPTR(pScrn);
-	int dst_pitch, tmp_pitch, cpp, i;
+	int dst_pitch, tmp_pitch, cpp;
+	Bool ce = (method == NOUVEAU_UPLOAD_COPY);
 	struct nouveau_bo *bo;
 	char *dst;
 	Bool ret;
@@ -317,22 +795,24 @@ nouveau_exa_upload_to_screen(PixmapPtr pdpix, int x, int y, int w, int h,
 	tmp_pitch = w * cpp;
 
 	/* try hostdata transfer */
-	if (w * h * cpp < 16*1024) /* heuristic */
-	{
+	if (method == NOUVEAU_UPLOAD_INLINE) {
 		if (pNv->Architecture < NV_TESLA) {
 			if (NV04EXAUploadIFC(pScrn, src, src_pitch, pdpix,
 					     x, y, w, h, cpp)) {
+				nouveau_pixmap_fence(pdpix, NOUVEAU_BO_WR);
 				return TRUE;
 			}
 		} else
 		if (pNv->Architecture < NV_FERMI) {
 			if (NV50EXAUploadSIFC(src, src_pitch, pdpix,
 					      x, y, w, h, cpp)) {
+				nouveau_pixmap_fence(pdpix, NOUVEAU_BO_WR);
 				return TRUE;
 			}
 		} else {
 			if (NVC0EXAUploadSIFC(src, src_pitch, pdpix,
 					      x, y, w, h, cpp)) {
+				nouveau_pixmap_fence(pdpix, NOUVEAU_BO_WR);
 				return TRUE;
 			}
 		}
@@ -343,27 +823,22 @@ nouveau_exa_upload_to_screen(PixmapPtr pdpix, int x, int y, int w, int h,
 		struct nouveau_bo *tmp;
 		int tmp_offset;
 
-		if (nouveau_exa_scratch(pNv, lines * tmp_pitch,
+		if (nouveau_exa_scratch(pNv, lines * tmp_pitch, FALSE,
 					&tmp, &tmp_offset))
 			goto memcpy;
 
-		if (src_pitch == tmp_pitch) {
-			memcpy(tmp->map + tmp_offset, src, src_pitch * lines);
-			src += src_pitch * lines;
-		} else {
-			dst = tmp->map + tmp_offset;
-			for (i = 0; i < lines; i++) {
-				memcpy(dst, src, tmp_pitch);
-				src += src_pitch;
-				dst += tmp_pitch;
-			}
-		}
+		NVAccelMemcpyRect((char *)tmp->map + tmp_offset, src, lines,
+				  tmp_pitch, src_pitch, tmp_pitch,
+				  nouveau_memcpy_to_wc);
+		src += src_pitch * lines;
 
-		if (!NVAccelM2MF(pNv, w, lines, cpp, tmp_offset, 0, tmp,
-				 NOUVEAU_BO_GART, tmp_pitch, lines, 0, 0,
-				 nouveau_pixmap_bo(pdpix), NOUVEAU_BO_VRAM,
-				 dst_pitch, pdpix->drawable.height, x, y))
+		if (!NVAccelRectCopy(pNv, ce, w, lines, cpp, tmp_offset,
+				     nouveau_pixmap_offset(pdpix), tmp,
+				     NOUVEAU_BO_GART, tmp_pitch, lines, 0, 0,
+				     nouveau_pixmap_bo(pdpix), NOUVEAU_BO_VRAM,
+				     dst_pitch, pdpix->drawable.height, x, y))
 			goto memcpy;
+		nouveau_exa_m2mf_fence(pNv, pdpix, NOUVEAU_BO_WR, ce);
 
 		/* next! */
 		h -= lines;
@@ -374,34 +849,1724 @@ nouveau_exa_upload_to_screen(PixmapPtr pdpix, int x, int y, int w, int h,
 
 	/* fallback to memcpy-based transfer */
 memcpy:
-	bo = nouveau_pixmap_bo(pdpix);
+	/* let EXA go through PrepareAccess, which knows about tiling */
 	if (nv50_style_tiled_pixmap(pdpix))
-		ErrorF("%s:%d - falling back to memcpy ignores tiling\n",
-		       __func__, __LINE__);
+		return FALSE;
 
+	bo = nouveau_pixmap_bo(pdpix);
 	if (nouveau_bo_map(bo, NOUVEAU_BO_WR, pNv->client))
 		return FALSE;
-	dst = (char *)bo->map + (y * dst_pitch) + (x * cpp);
-	ret = NVAccelMemcpyRect(dst, src, h, dst_pitch, src_pitch, w*cpp);
+	dst = (char *)bo->map + nouveau_pixmap_offset(pdpix) +
+	      (y * dst_pitch) + (x * cpp);
+	ret = NVAccelMemcpyRect(dst, src, h, dst_pitch, src_pitch, w*cpp,
+				nouveau_memcpy_to_wc);
 	return ret;
 }
 
-Bool
-nouveau_exa_pixmap_is_onscreen(PixmapPtr ppix)
+/* Upload path selection
+ *
+ * Which of pushing the data inline, staging it for M2MF or staging it for
+ * the copy engine is fastest depends a lot on the chipset, the bus and
+ * the shape of the upload.  Rather than guess, each path is timed for a
+ * range of sizes at startup, for narrow and wide rectangles, and the
+ * winners are remembered per GPU model (and kernel, the copy engine and
+ * the bus setup depend on it) so later server starts don't have to do it
+ * again.  The file lives in Option "UploadCache".
+ */
+#ifndef NOUVEAU_CACHE_DIR
+#define NOUVEAU_CACHE_DIR "/var/cache/xorg"
+#endif
+#define NOUVEAU_UPLOAD_CACHE "%s/nouveau-upload-%02x-%04x"
+#define NOUVEAU_UPLOAD_NARROW 512 /* bytes per line */
+#define NOUVEAU_UPLOAD_MIN_SHIFT 10
+#define NOUVEAU_UPLOAD_MAX_INLINE (256 * 1024)
+#define NOUVEAU_UPLOAD_CAL_W 1024
+#define NOUVEAU_UPLOAD_CAL_H 1024
+
+static int
+nouveau_exa_upload_bucket(int size)
 {
-	ScrnInfoPtr pScrn = xf86ScreenToScrn(ppix->drawable.pScreen);
+	int bucket = size > 1 ? log2i(size - 1) + 1 - NOUVEAU_UPLOAD_MIN_SHIFT : 0;
 
-	if (pScrn->pScreen->GetScreenPixmap(pScrn->pScreen) == ppix)
-		return TRUE;
+	if (bucket < 0)
+		return 0;
+	if (bucket >= NOUVEAU_UPLOAD_BUCKETS)
+		return NOUVEAU_UPLOAD_BUCKETS - 1;
+	return bucket;
+}
 
-	return FALSE;
+static Bool
+nouveau_exa_upload_usable(NVPtr pNv, int method, int size)
+{
+	switch (method) {
+	case NOUVEAU_UPLOAD_INLINE:
+		return size <= NOUVEAU_UPLOAD_MAX_INLINE;
+	case NOUVEAU_UPLOAD_COPY:
+		return nouveau_exa_ce(pNv);
+	default:
+		return TRUE;
+	}
 }
 
+/* the fixed heuristic used before calibration, or if it fails */
 static void
-nouveau_exa_flush(ScrnInfoPtr pScrn)
+nouveau_exa_upload_defaults(NVPtr pNv)
 {
-	NVPtr pNv = NVPTR(pScrn);
-	nouveau_pushbuf_kick(pNv->pushbuf, pNv->pushbuf->channel);
+	int shape, bucket;
+
+	for (shape = 0; shape < 2; shape++) {
+		for (bucket = 0; bucket < NOUVEAU_UPLOAD_BUCKETS; bucket++) {
+			int size = 1 << (bucket + NOUVEAU_UPLOAD_MIN_SHIFT);
+
+			if (size <= 16 * 1024)
+				pNv->upload_method[shape][bucket] =
+					NOUVEAU_UPLOAD_INLINE;
+			else
+			if (nouveau_exa_ce(pNv))
+				pNv->upload_method[shape][bucket] =
+					NOUVEAU_UPLOAD_COPY;
+			else
+				pNv->upload_method[shape][bucket] =
+					NOUVEAU_UPLOAD_M2MF;
+		}
+	}
+}
+
+static Bool
+nouveau_exa_upload_load(NVPtr pNv, const char *path, const char *kernel)
+{
+	int shape, bucket, method, ce, fd;
+	char release[65];
+	Bool ret = FALSE;
+	FILE *f;
+
+	fd = open(path, O_RDONLY | O_NOFOLLOW);
+	if (fd < 0)
+		return FALSE;
+
+	f = fdopen(fd, "r");
+	if (!f) {
+		close(fd);
+		return FALSE;
+	}
+
+	if (fscanf(f, "nouveau-upload 2 ce=%d kernel=%64s\n",
+		   &ce, release) != 2 ||
+	    ce != nouveau_exa_ce(pNv) || strcmp(release, kernel))
+		goto out;
+
+	for (shape = 0; shape < 2; shape++) {
+		for (bucket = 0; bucket < NOUVEAU_UPLOAD_BUCKETS; bucket++) {
+			if (fscanf(f, "%d", &method) != 1 ||
+			    method < 0 || method >= NOUVEAU_UPLOAD_METHODS ||
+			    !nouveau_exa_upload_usable(pNv, method, 0))
+				goto out;
+			pNv->upload_method[shape][bucket] = method;
+		}
+	}
+
+	ret = TRUE;
+out:
+	fclose(f);
+	return ret;
+}
+
+/* written to a new file that's renamed over the old one, the directory
+ * may well be writable by others
+ */
+static Bool
+nouveau_exa_upload_save(NVPtr pNv, const char *path, const char *kernel)
+{
+	char tmp[PATH_MAX];
+	int shape, bucket, fd;
+	Bool ret;
+	FILE *f;
+
+	if (snprintf(tmp, sizeof(tmp), "%s.%ld", path,
+		     (long)getpid()) >= sizeof(tmp))
+		return FALSE;
+
+	fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW, 0644);
+	if (fd < 0)
+		return FALSE;
+
+	f = fdopen(fd, "w");
+	if (!f) {
+		close(fd);
+		unlink(tmp);
+		return FALSE;
+	}
+
+	fprintf(f, "nouveau-upload 2 ce=%d kernel=%s\n",
+		nouveau_exa_ce(pNv), kernel);
+	for (shape = 0; shape < 2; shape++) {
+		for (bucket = 0; bucket < NOUVEAU_UPLOAD_BUCKETS; bucket++)
+			fprintf(f, "%d ", pNv->upload_method[shape][bucket]);
+		fprintf(f, "\n");
+	}
+
+	ret = !ferror(f);
+	if (fclose(f))
+		ret = FALSE;
+	if (ret && rename(tmp, path))
+		ret = FALSE;
+	if (!ret) {
+		int err = errno;
+		unlink(tmp);
+		errno = err;
+	}
+	return ret;
+}
+
+static CARD64
+nouveau_exa_upload_time(PixmapPtr ppix, int method, int w, int h, char *src)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(ppix->drawable.pScreen));
+	int pitch = w * (ppix->drawable.bitsPerPixel >> 3);
+	int reps = (1024 * 1024) / (pitch * h);
+	struct timespec t0, t1;
+	int i;
+
+	if (reps < 2)
+		reps = 2;
+	if (reps > 64)
+		reps = 64;
+
+	/* warm up, and make sure nothing else is still queued */
+	if (!nouveau_exa_upload(ppix, method, 0, 0, w, h, src, pitch) ||
+	    nouveau_bo_wait(nouveau_pixmap_bo(ppix), NOUVEAU_BO_RDWR,
+			    pNv->client))
+		return ~0ULL;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0; i < reps; i++) {
+		if (!nouveau_exa_upload(ppix, method, 0, 0, w, h, src, pitch))
+			return ~0ULL;
+	}
+	if (nouveau_bo_wait(nouveau_pixmap_bo(ppix), NOUVEAU_BO_RDWR,
+			    pNv->client))
+		return ~0ULL;
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	return ((t1.tv_sec - t0.tv_sec) * 1000000000ULL +
+		t1.tv_nsec - t0.tv_nsec) / reps;
+}
+
+static Bool
+nouveau_exa_upload_calibrate(ScreenPtr pScreen)
+{
+	ScrnInfoPtr pScrn = xf86ScreenToScrn(pScreen);
+	NVPtr pNv = NVPTR(pScrn);
+	PixmapPtr ppix;
+	int shape, bucket, method;
+	char *src;
+
+	src = malloc(NOUVEAU_UPLOAD_CAL_W * NOUVEAU_UPLOAD_CAL_H * 4);
+	if (!src)
+		return FALSE;
+	memset(src, 0x55, NOUVEAU_UPLOAD_CAL_W * NOUVEAU_UPLOAD_CAL_H * 4);
+
+	ppix = pScreen->CreatePixmap(pScreen, NOUVEAU_UPLOAD_CAL_W,
+				     NOUVEAU_UPLOAD_CAL_H, 24, 0);
+	if (!ppix) {
+		free(src);
+		return FALSE;
+	}
+
+	exaMoveInPixmap(ppix);
+	if (!nouveau_pixmap_bo(ppix) || ppix->drawable.bitsPerPixel != 32) {
+		pScreen->DestroyPixmap(ppix);
+		free(src);
+		return FALSE;
+	}
+
+	/* wide rectangles first, narrow ones may borrow their results */
+	for (shape = 1; shape >= 0; shape--) {
+		for (bucket = 0; bucket < NOUVEAU_UPLOAD_BUCKETS; bucket++) {
+			int size = 1 << (bucket + NOUVEAU_UPLOAD_MIN_SHIFT);
+			int w = shape ? NOUVEAU_UPLOAD_CAL_W :
+					NOUVEAU_UPLOAD_NARROW / 8;
+			int h = size / (w * 4);
+			CARD64 best = ~0ULL;
+
+			if (h < 1) {
+				w = size / 4;
+				h = 1;
+			}
+
+			/* tall narrow uploads look just like tall wide ones
+			 * once the rectangle doesn't fit our pixmap anymore
+			 */
+			if (h > NOUVEAU_UPLOAD_CAL_H) {
+				pNv->upload_method[shape][bucket] =
+					pNv->upload_method[1][bucket];
+				continue;
+			}
+
+			for (method = 0; method < NOUVEAU_UPLOAD_METHODS;
+			     method++) {
+				CARD64 t;
+
+				if (!nouveau_exa_upload_usable(pNv, method,
+							       size))
+					continue;
+
+				t = nouveau_exa_upload_time(ppix, method,
+							    w, h, src);
+				if (t < best) {
+					pNv->upload_method[shape][bucket] =
+						method;
+					best = t;
+				}
+			}
+		}
+	}
+
+	pScreen->DestroyPixmap(ppix);
+	free(src);
+	return TRUE;
+}
+
+void
+nouveau_exa_upload_init(ScreenPtr pScreen)
+{
+	ScrnInfoPtr pScrn = xf86ScreenToScrn(pScreen);
+	NVPtr pNv = NVPTR(pScrn);
+	const char *dir = pNv->upload_cache;
+	static Bool warned = FALSE;
+	struct utsname uts;
+	char path[PATH_MAX];
+	Bool cache;
+
+	nouveau_exa_upload_defaults(pNv);
+
+	if (!dir)
+		dir = NOUVEAU_CACHE_DIR;
+
+	cache = dir[0] && !uname(&uts) &&
+		snprintf(path, sizeof(path), NOUVEAU_UPLOAD_CACHE,
+			 dir, pNv->dev->chipset,
+			 pNv->PciInfo ? pNv->PciInfo->device_id : 0) <
+		sizeof(path);
+	if (cache && nouveau_exa_upload_load(pNv, path, uts.release))
+		return;
+
+	if (!nouveau_exa_upload_calibrate(pScreen)) {
+		xf86DrvMsg(pScrn->scrnIndex, X_WARNING,
+			   "Upload calibration failed, using defaults\n");
+		nouveau_exa_upload_defaults(pNv);
+		return;
+	}
+
+	xf86DrvMsg(pScrn->scrnIndex, X_INFO, "Upload paths calibrated\n");
+	if (cache && !nouveau_exa_upload_save(pNv, path, uts.release) &&
+	    !warned) {
+		xf86DrvMsg(pScrn->scrnIndex, X_WARNING,
+			   "Couldn't save upload calibration to %s: %s\n",
+			   path, strerror(errno));
+		warned = TRUE;
+	}
+}
+
+static Bool
+nouveau_exa_upload_to_screen(PixmapPtr pdpix, int x, int y, int w, int h,
+			     char *src, int src_pitch)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+	int pitch = w * (pdpix->drawable.bitsPerPixel >> 3);
+	int shape = pitch >= NOUVEAU_UPLOAD_NARROW;
+	int size = pitch * h;
+	int method;
+	Bool ret;
+
+	method = pNv->upload_method[shape][nouveau_exa_upload_bucket(size)];
+	if (!nouveau_exa_upload_usable(pNv, method, size))
+		method = NOUVEAU_UPLOAD_M2MF;
+
+	nouveau_stats_begin(pNv->pushbuf, NOUVEAU_STATS_UPLOAD);
+	ret = nouveau_exa_upload(pdpix, method, x, y, w, h, src, src_pitch);
+	nouveau_stats_end(pNv->pushbuf);
+	return ret;
+}
+
+static uint32_t
+nouveau_exa_gradient_texel(const xRenderColor *c0, const xRenderColor *c1,
+			   double f)
+{
+	double a = (c0->alpha + (c1->alpha - c0->alpha) * f) / 65535.0;
+	double r = (c0->red   + (c1->red   - c0->red  ) * f) / 65535.0;
+	double g = (c0->green + (c1->green - c0->green) * f) / 65535.0;
+	double b = (c0->blue  + (c1->blue  - c0->blue ) * f) / 65535.0;
+
+	/* stops are specified unpremultiplied, the ramp must not be */
+	return ((uint32_t)(a * 255.0 + 0.5) << 24) |
+	       ((uint32_t)(r * a * 255.0 + 0.5) << 16) |
+	       ((uint32_t)(g * a * 255.0 + 0.5) << 8) |
+	       ((uint32_t)(b * a * 255.0 + 0.5));
+}
+
+/* texel i holds the colour at t = (i + 0.5) / NOUVEAU_GRADIENT_TEXELS, or
+ * at 1 - t for a reversed ramp
+ */
+static void
+nouveau_exa_gradient_ramp(PictGradient *grad, uint32_t *ramp, Bool reverse)
+{
+	int i, s = -1;
+
+	for (i = 0; i < NOUVEAU_GRADIENT_TEXELS; i++) {
+		xFixed pos = ((2 * i + 1) * (xFixed)0x10000) /
+			     (2 * NOUVEAU_GRADIENT_TEXELS);
+		PictGradientStop *s0, *s1;
+		uint32_t texel;
+
+		while (s + 1 < grad->nstops && grad->stops[s + 1].x <= pos)
+			s++;
+
+		if (s < 0) {
+			s0 = s1 = &grad->stops[0];
+		} else
+		if (s == grad->nstops - 1) {
+			s0 = s1 = &grad->stops[s];
+		} else {
+			s0 = &grad->stops[s + 0];
+			s1 = &grad->stops[s + 1];
+		}
+
+		texel = nouveau_exa_gradient_texel(&s0->color, &s1->color,
+				(s0 == s1) ? 0.0 : (double)(pos - s0->x) /
+						   (s1->x - s0->x));
+		if (reverse)
+			ramp[NOUVEAU_GRADIENT_TEXELS - 1 - i] = texel;
+		else
+			ramp[i] = texel;
+	}
+}
+
+/* Radial gradients, from the circle c1 at t = 0 to c2 at t = 1, where
+ * one circle lies strictly inside the other.  Every point is then on
+ * exactly one of the circles with a radius >= 0, and t solves
+ *
+ *   |p - c1 - t (c2 - c1)| = r1 + t (r2 - r1)
+ *
+ * with r2 > r1 (otherwise the circles are swapped, and the ramp reversed).
+ * In coordinates u along c2 - c1 and v across it, scaled so that
+ * a = |c2 - c1|^2 - (r2 - r1)^2 (< 0) drops out, that's
+ *
+ *   t = alpha u + beta + sqrt(u^2 + v^2)
+ *
+ * The VP interpolates u and v as the texture coordinates of the unit,
+ * and the PFP_R* fragment programs solve for t with alpha and beta from
+ * PFP_RADIAL in the FP constants, then sample the ramp at (t, v): it has
+ * a single row clamped to the edge, so only t matters.
+ *
+ * Other radial gradients have points that no circle reaches, or reaches
+ * twice, and conical ones need an atan per pixel; those still fall back.
+ */
+static Bool
+nouveau_exa_gradient_radial(SourcePictPtr sp, uint32_t *ramp,
+			    double g[2][3], float *k)
+{
+	PictRadialGradient *rg = &sp->radial;
+	PictCircle *c1 = &rg->c1, *c2 = &rg->c2;
+	double x1, y1, r1, dx, dy, dr, l, a, s, ux, uy;
+
+	if (c2->radius < c1->radius) {
+		c1 = &rg->c2;
+		c2 = &rg->c1;
+	}
+
+	x1 = xFixedToDouble(c1->x);
+	y1 = xFixedToDouble(c1->y);
+	r1 = xFixedToDouble(c1->radius);
+	dx = xFixedToDouble(c2->x) - x1;
+	dy = xFixedToDouble(c2->y) - y1;
+	dr = xFixedToDouble(c2->radius) - r1;
+	l = sqrt(dx * dx + dy * dy);
+	a = l * l - dr * dr;
+	if (r1 < 0.0 || a >= 0.0)
+		return FALSE;
+
+	nouveau_exa_gradient_ramp(&sp->gradient, ramp, c1 != &rg->c1);
+
+	ux = (l > 0.0) ? dx / l : 1.0;
+	uy = (l > 0.0) ? dy / l : 0.0;
+	s = sqrt(-a);
+
+	/* u = (dr ((p - c1) . (ux, uy)) + l r1) / -a */
+	g[0][0] = dr * ux / -a;
+	g[0][1] = dr * uy / -a;
+	g[0][2] = (l * r1 - dr * (x1 * ux + y1 * uy)) / -a;
+	/* v = ((p - c1) . (-uy, ux)) / sqrt(-a) */
+	g[1][0] = -uy / s;
+	g[1][1] =  ux / s;
+	g[1][2] = (x1 * uy - y1 * ux) / s;
+
+	k[0] = -l / dr;
+	k[1] = -r1 / dr;
+	return TRUE;
+}
+
+/* Bake a gradient into a 1D ARGB ramp of NOUVEAU_GRADIENT_TEXELS texels,
+ * and compute the matrix that takes destination coordinates to the
+ * coordinates the ramp is sampled at (in the first two rows).  For linear
+ * gradients that's (t, 0.5), so the ramp can be sampled as a Nx1 2D
+ * texture.  Radial gradients need the fragment program to finish the job,
+ * see nouveau_exa_gradient_radial(), it takes the constants in k.
+ *
+ * The repeat mode of the picture maps directly onto the sampler wrap mode
+ * for the t axis, so the caller doesn't need to care about t in [0, 1].
+ * The ramp must be sampled nearest: filtering would smear hard stops over
+ * a texel, and with RepeatNone blend the ends with the (transparent)
+ * border colour instead of cutting off at t = 0 and t = 1.  Nearest keeps
+ * the stops within half a texel of where they belong.
+ */
+Bool
+nouveau_exa_gradient(PicturePtr ppict, uint32_t *ramp, float *m, float *k)
+{
+	SourcePictPtr sp = ppict->pSourcePict;
+	double g[2][3], t[3][3];
+	int i, j;
+
+	if (sp->gradient.nstops < 1)
+		return FALSE;
+
+	switch (sp->type) {
+	case SourcePictTypeLinear: {
+		PictLinearGradient *lg = &sp->linear;
+		double x1 = xFixedToDouble(lg->p1.x);
+		double y1 = xFixedToDouble(lg->p1.y);
+		double dx = xFixedToDouble(lg->p2.x) - x1;
+		double dy = xFixedToDouble(lg->p2.y) - y1;
+		double l = dx * dx + dy * dy;
+
+		if (l == 0.0)
+			return FALSE;
+
+		nouveau_exa_gradient_ramp(&sp->gradient, ramp, FALSE);
+
+		/* t = ((p - p1) . (p2 - p1)) / |p2 - p1|^2 */
+		g[0][0] = dx / l;
+		g[0][1] = dy / l;
+		g[0][2] = -(x1 * dx + y1 * dy) / l;
+		g[1][0] = 0.0;
+		g[1][1] = 0.0;
+		g[1][2] = 0.5;
+		break;
+	}
+	case SourcePictTypeRadial:
+		if (!nouveau_exa_gradient_radial(sp, ramp, g, k))
+			return FALSE;
+		break;
+	default:
+		return FALSE;
+	}
+
+	for (i = 0; i < 3; i++) {
+		for (j = 0; j < 3; j++) {
+			if (ppict->transform)
+				t[i][j] = xFixedToDouble(ppict->transform->matrix[i][j]);
+			else
+				t[i][j] = (i == j) ? 1.0 : 0.0;
+		}
+	}
+
+	for (j = 0; j < 3; j++) {
+		for (i = 0; i < 2; i++) {
+			m[i * 3 + j] = g[i][0] * t[0][j] + g[i][1] * t[1][j] +
+				       g[i][2] * t[2][j];
+		}
+		m[6 + j] = t[2][j];
+	}
+
+	return TRUE;
+}
+
+/* Ramps stay resident in the scratch bo's gradient slots after use, keyed
+ * by their texels, so redrawing the same gradient (toolkits do that for
+ * every button and header) only costs baking it, not uploading it.
+ * Returns the slot to sample, and whether the ramp still has to be
+ * uploaded there.  The least recently used slot is replaced when there's
+ * no match.
+ */
+int
+nouveau_exa_gradient_slot(NVPtr pNv, const uint32_t *ramp, Bool *upload)
+{
+	int i, lru = 0;
+
+	for (i = 0; i < NOUVEAU_GRADIENT_SLOTS; i++) {
+		if (pNv->gradient_slot[i].stamp &&
+		    !memcmp(pNv->gradient_slot[i].ramp, ramp,
+			    sizeof(pNv->gradient_slot[i].ramp)))
+			break;
+		if (pNv->gradient_slot[i].stamp <
+		    pNv->gradient_slot[lru].stamp)
+			lru = i;
+	}
+
+	*upload = (i == NOUVEAU_GRADIENT_SLOTS);
+	if (*upload) {
+		i = lru;
+		memcpy(pNv->gradient_slot[i].ramp, ramp,
+		       sizeof(pNv->gradient_slot[i].ramp));
+	}
+
+	pNv->gradient_slot[i].stamp = ++pNv->gradient_stamp;
+	return i;
+}
+
+/* Whether a composite is a plain copy of scaled source texels, which the
+ * 2D engine can do as a scaled blit without any of the 3D state: Src, or
+ * Over from an opaque source, with no mask and a source that's only
+ * scaled and translated, sampled nearest or bilinear and not repeated.
+ * The steps are kept in pNv->blit for nouveau_exa_blit_rect().
+ */
+Bool
+nouveau_exa_blit(NVPtr pNv, int op, PicturePtr pspict, PicturePtr pmpict,
+		 PicturePtr pdpict, PixmapPtr pspix)
+{
+	PictTransformPtr t = pspict->transform;
+
+	if (pmpict || !pspict->pDrawable || !t || pspict->repeat)
+		return FALSE;
+	if (pspict->filter != PictFilterNearest &&
+	    pspict->filter != PictFilterBilinear)
+		return FALSE;
+
+	if (op != PictOpSrc &&
+	    !(op == PictOpOver && !PICT_FORMAT_A(pspict->format)))
+		return FALSE;
+
+	/* texels are copied as-is, alpha can only be dropped */
+	if (pspict->format != pdpict->format &&
+	    !(pspict->format == PICT_a8r8g8b8 &&
+	      pdpict->format == PICT_x8r8g8b8))
+		return FALSE;
+
+	/* scale factors are limited to keep the 32.32 maths in range */
+	if (t->matrix[0][1] || t->matrix[1][0] ||
+	    t->matrix[2][0] || t->matrix[2][1] ||
+	    t->matrix[2][2] != xFixed1)
+		return FALSE;
+	if (t->matrix[0][0] <= 0 || t->matrix[0][0] > IntToxFixed(256) ||
+	    t->matrix[1][1] <= 0 || t->matrix[1][1] > IntToxFixed(256))
+		return FALSE;
+
+	pNv->blit.bilinear = pspict->filter == PictFilterBilinear;
+	pNv->blit.du = (int64_t)t->matrix[0][0] << 16;
+	pNv->blit.dv = (int64_t)t->matrix[1][1] << 16;
+	pNv->blit.tx = (int64_t)t->matrix[0][2] << 16;
+	pNv->blit.ty = (int64_t)t->matrix[1][2] << 16;
+	pNv->blit.width = pspix->drawable.width;
+	pNv->blit.height = pspix->drawable.height;
+	return TRUE;
+}
+
+/* first source position along one axis, or FALSE if the samples of
+ * n pixels from s on don't all stay where they only read the source
+ */
+static Bool
+nouveau_exa_blit_axis(int64_t step, int64_t t, int s, int n, int size,
+		      Bool bilinear, int64_t *pos)
+{
+	int64_t lo = bilinear ? (1LL << 31) : 0;
+	int64_t hi = ((int64_t)size << 32) - (bilinear ? (1LL << 31) : 1);
+	int64_t p0 = step * s + t;
+
+	/* pixel i samples at p0 + (i + 0.5) * step, bilinear filtering
+	 * reaches half a texel further
+	 */
+	if (p0 + step / 2 < lo || p0 + step * n - step / 2 > hi)
+		return FALSE;
+
+	*pos = p0;
+	return TRUE;
+}
+
+/* BLIT_DU_DX_FRACT to BLIT_SRC_Y_INT for the rect at (sx, sy) in source
+ * picture space.  FALSE if it samples outside the source, where Render
+ * wants transparent texels (or a blend with them) the 2D engine can't do.
+ */
+Bool
+nouveau_exa_blit_rect(NVPtr pNv, int sx, int sy, int w, int h, uint32_t *data)
+{
+	struct nouveau_blit *blit = &pNv->blit;
+	int64_t x, y;
+
+	if (!nouveau_exa_blit_axis(blit->du, blit->tx, sx, w, blit->width,
+				   blit->bilinear, &x) ||
+	    !nouveau_exa_blit_axis(blit->dv, blit->ty, sy, h, blit->height,
+				   blit->bilinear, &y))
+		return FALSE;
+
+	data[0] = blit->du;
+	data[1] = blit->du >> 32;
+	data[2] = blit->dv;
+	data[3] = blit->dv >> 32;
+	data[4] = x;
+	data[5] = x >> 32;
+	data[6] = y;
+	data[7] = y >> 32;
+	return TRUE;
+}
+
+Bool
+nouveau_exa_pixmap_is_onscreen(PixmapPtr ppix)
+{
+	ScrnInfoPtr pScrn = xf86ScreenToScrn(ppix->drawable.pScreen);
+
+	if (pScrn->pScreen->GetScreenPixmap(pScrn->pScreen) == ppix)
+		return TRUE;
+
+	return FALSE;
+}
+
+/* PolyFillRect
+ *
+ * EXA turns a solid PolyFillRect into one Solid() call per clipped box.
+ * Sit on top of EXA's GC ops and hand the whole box list to the chipset
+ * code in one go instead, it can pack many boxes into a single method
+ * group.  Anything that isn't a plain solid fill to a pixmap with a GPU
+ * copy goes down to EXA as before.
+ */
+struct nouveau_gc {
+	const GCFuncs *funcs;
+	const GCOps *ops;
+	GCOps wrap_ops;
+};
+
+static DevPrivateKeyRec nouveau_gc_key;
+
+#define nouveau_gc(pGC)                                                        \
+	((struct nouveau_gc *)dixLookupPrivate(&(pGC)->devPrivates,            \
+					       &nouveau_gc_key))
+
+static const GCFuncs nouveau_gc_funcs;
+
+static void
+nouveau_exa_poly_fill_rect(DrawablePtr pDrawable, GCPtr pGC, int nrect,
+			   xRectangle *prect)
+{
+	struct nouveau_gc *priv = nouveau_gc(pGC);
+	ScreenPtr pScreen = pDrawable->pScreen;
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+	ExaDriverPtr exa = pNv->EXADriverPtr;
+	PixmapPtr ppix = NVGetDrawablePixmap(pDrawable);
+	RegionPtr pReg;
+
+	if (pGC->fillStyle != FillSolid || nrect <= 0)
+		goto fallback;
+
+	exaMoveInPixmap(ppix);
+	if (!exaDrawableIsOffscreen(pDrawable) || !nouveau_pixmap_bo(ppix))
+		goto fallback;
+
+	pReg = RegionFromRects(nrect, prect, CT_UNSORTED);
+	if (!pReg)
+		goto fallback;
+	RegionTranslate(pReg, pDrawable->x, pDrawable->y);
+	RegionIntersect(pReg, pReg, fbGetCompositeClip(pGC));
+	if (!RegionNotEmpty(pReg)) {
+		RegionDestroy(pReg);
+		return;
+	}
+
+	if (!exa->PrepareSolid(ppix, pGC->alu, pGC->planemask, pGC->fgPixel)) {
+		RegionDestroy(pReg);
+		goto fallback;
+	}
+
+#ifdef COMPOSITE
+	if (pDrawable->type == DRAWABLE_WINDOW)
+		RegionTranslate(pReg, -ppix->screen_x, -ppix->screen_y);
+#endif
+	pNv->exa_solid_boxes(ppix, RegionRects(pReg), RegionNumRects(pReg));
+	exa->DoneSolid(ppix);
+	exaMarkSync(pScreen);
+
+	RegionDestroy(pReg);
+	return;
+
+fallback:
+	pGC->ops = (GCOps *)priv->ops;
+	pGC->ops->PolyFillRect(pDrawable, pGC, nrect, prect);
+	pGC->ops = &priv->wrap_ops;
+}
+
+static void
+nouveau_gc_wrap(GCPtr pGC)
+{
+	struct nouveau_gc *priv = nouveau_gc(pGC);
+
+	priv->funcs = pGC->funcs;
+	priv->ops = pGC->ops;
+	priv->wrap_ops = *pGC->ops;
+	priv->wrap_ops.PolyFillRect = nouveau_exa_poly_fill_rect;
+	pGC->funcs = &nouveau_gc_funcs;
+	pGC->ops = &priv->wrap_ops;
+}
+
+static void
+nouveau_gc_unwrap(GCPtr pGC)
+{
+	struct nouveau_gc *priv = nouveau_gc(pGC);
+
+	pGC->funcs = priv->funcs;
+	pGC->ops = (GCOps *)priv->ops;
+}
+
+static void
+nouveau_gc_validate(GCPtr pGC, unsigned long changes, DrawablePtr pDrawable)
+{
+	nouveau_gc_unwrap(pGC);
+	pGC->funcs->ValidateGC(pGC, changes, pDrawable);
+	nouveau_gc_wrap(pGC);
+}
+
+static void
+nouveau_gc_change(GCPtr pGC, unsigned long mask)
+{
+	nouveau_gc_unwrap(pGC);
+	pGC->funcs->ChangeGC(pGC, mask);
+	nouveau_gc_wrap(pGC);
+}
+
+static void
+nouveau_gc_copy(GCPtr pGCSrc, unsigned long mask, GCPtr pGCDst)
+{
+	nouveau_gc_unwrap(pGCDst);
+	pGCDst->funcs->CopyGC(pGCSrc, mask, pGCDst);
+	nouveau_gc_wrap(pGCDst);
+}
+
+static void
+nouveau_gc_destroy(GCPtr pGC)
+{
+	nouveau_gc_unwrap(pGC);
+	pGC->funcs->DestroyGC(pGC);
+}
+
+static void
+nouveau_gc_change_clip(GCPtr pGC, int type, void *pvalue, int nrects)
+{
+	nouveau_gc_unwrap(pGC);
+	pGC->funcs->ChangeClip(pGC, type, pvalue, nrects);
+	nouveau_gc_wrap(pGC);
+}
+
+static void
+nouveau_gc_destroy_clip(GCPtr pGC)
+{
+	nouveau_gc_unwrap(pGC);
+	pGC->funcs->DestroyClip(pGC);
+	nouveau_gc_wrap(pGC);
+}
+
+static void
+nouveau_gc_copy_clip(GCPtr pGCDst, GCPtr pGCSrc)
+{
+	nouveau_gc_unwrap(pGCDst);
+	pGCDst->funcs->CopyClip(pGCDst, pGCSrc);
+	nouveau_gc_wrap(pGCDst);
+}
+
+static const GCFuncs nouveau_gc_funcs = {
+	nouveau_gc_validate,
+	nouveau_gc_change,
+	nouveau_gc_copy,
+	nouveau_gc_destroy,
+	nouveau_gc_change_clip,
+	nouveau_gc_destroy_clip,
+	nouveau_gc_copy_clip,
+};
+
+static Bool
+nouveau_exa_create_gc(GCPtr pGC)
+{
+	ScreenPtr pScreen = pGC->pScreen;
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+	Bool ret;
+
+	pScreen->CreateGC = pNv->CreateGC;
+	ret = pScreen->CreateGC(pGC);
+	pScreen->CreateGC = nouveau_exa_create_gc;
+
+	if (ret)
+		nouveau_gc_wrap(pGC);
+	return ret;
+}
+
+/* Trapezoids, Triangles, AddTraps
+ *
+ * EXA rasterizes trapezoids into its a8 mask on the CPU, which then has
+ * to be uploaded before the final Composite.  Render them on the 3D
+ * engine instead, each trapezoid is one Add'ing quad over its bounds
+ * into a mask pixmap that never leaves VRAM.
+ *
+ * Coverage is approximated per pixel as the product of the coverage of
+ * each edge's half-plane, clamp(d + 0.5) for a pixel centre at signed
+ * distance d inside the edge.  The distances are affine in screen space,
+ * so they're passed as source (top/bottom) and mask (left/right) texture
+ * coordinates into a 2x2 ramp that's 0 except for the bottom-right
+ * texel.  Bilinear filtering with pad repeat then hands back exactly
+ * clamp(u) * clamp(v) for each unit, and the usual src IN mask program
+ * multiplies the two together.
+ *
+ * That's only close to the real area when no pixel is crossed by both
+ * edges of a pair, a 0.5 pixel wide stroke comes out at 0.56 rather than
+ * 0.5.  Trapezoids under a pixel tall, or under a pixel wide along their
+ * whole height, are left to software.
+ */
+#define NOUVEAU_TRAP_FRAC 256
+
+static PicturePtr
+nouveau_exa_trap_edge(ScreenPtr pScreen)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+	static const CARD8 ramp[2][4] = { { 0x00, 0x00 }, { 0x00, 0xff } };
+	PictFormatPtr format;
+	PictTransform transform;
+	PicturePtr ppict;
+	PixmapPtr ppix;
+	GCPtr pGC;
+	XID repeat = RepeatPad;
+	int error;
+
+	if (pNv->trap_edge)
+		return pNv->trap_edge;
+
+	format = PictureMatchFormat(pScreen, 8, PICT_a8);
+	if (!format)
+		return NULL;
+
+	ppix = pScreen->CreatePixmap(pScreen, 2, 2, 8, 0);
+	if (!ppix)
+		return NULL;
+
+	pGC = GetScratchGC(8, pScreen);
+	if (!pGC) {
+		pScreen->DestroyPixmap(ppix);
+		return NULL;
+	}
+	ValidateGC(&ppix->drawable, pGC);
+	pGC->ops->PutImage(&ppix->drawable, pGC, 8, 0, 0, 2, 2, 0, ZPixmap,
+			   (char *)ramp);
+	FreeScratchGC(pGC);
+
+	ppict = CreatePicture(0, &ppix->drawable, format, CPRepeat, &repeat,
+			      serverClient, &error);
+	pScreen->DestroyPixmap(ppix);
+	if (!ppict)
+		return NULL;
+
+	/* coordinates are passed in 1/NOUVEAU_TRAP_FRAC texel units */
+	memset(&transform, 0, sizeof(transform));
+	transform.matrix[0][0] = pixman_fixed_1 / NOUVEAU_TRAP_FRAC;
+	transform.matrix[1][1] = pixman_fixed_1 / NOUVEAU_TRAP_FRAC;
+	transform.matrix[2][2] = pixman_fixed_1;
+	if (SetPictureTransform(ppict, &transform) ||
+	    SetPictureFilter(ppict, FilterBilinear, strlen(FilterBilinear),
+			     NULL, 0)) {
+		FreePicture(ppict, 0);
+		return NULL;
+	}
+
+	pNv->trap_edge = ppict;
+	return ppict;
+}
+
+/* signed distance a * x + b * y + c from the line, positive on its right
+ * when looking down the y axis
+ */
+static void
+nouveau_exa_trap_line(const xLineFixed *l, double *a, double *b, double *c)
+{
+	double x1 = xFixedToDouble(l->p1.x), y1 = xFixedToDouble(l->p1.y);
+	double dx = xFixedToDouble(l->p2.x) - x1;
+	double dy = xFixedToDouble(l->p2.y) - y1;
+	double len;
+
+	if (dy < 0) {
+		dx = -dx;
+		dy = -dy;
+	}
+
+	len = sqrt(dx * dx + dy * dy);
+	*a = dy / len;
+	*b = -dx / len;
+	*c = (y1 * dx - x1 * dy) / len;
+}
+
+/* whether both edges of a pair cross the same pixels, see above */
+static Bool
+nouveau_exa_trap_thin(const xTrapezoid *trap)
+{
+	const xLineFixed *r = &trap->right;
+	double top = xFixedToDouble(trap->top);
+	double bot = xFixedToDouble(trap->bottom);
+	double x1 = xFixedToDouble(r->p1.x), y1 = xFixedToDouble(r->p1.y);
+	double dx = xFixedToDouble(r->p2.x) - x1;
+	double dy = xFixedToDouble(r->p2.y) - y1;
+	double la, lb, lc, xt, xb;
+
+	if (bot - top < 1.0)
+		return TRUE;
+
+	/* distance of the right edge's ends from the left edge */
+	nouveau_exa_trap_line(&trap->left, &la, &lb, &lc);
+	xt = x1 + (top - y1) * dx / dy;
+	xb = x1 + (bot - y1) * dx / dy;
+	return la * xt + lb * top + lc < 1.0 && la * xb + lb * bot + lc < 1.0;
+}
+
+/* ramp coordinate for distance d, the first texel centre is at d = -0.5 */
+static int32_t
+nouveau_exa_trap_coord(double a, double b, double c, int x, int y)
+{
+	return lround((a * x + b * y + c + 1.0) * NOUVEAU_TRAP_FRAC);
+}
+
+/* Add the coverage of each trapezoid, offset by (ox, oy), into pmask */
+static Bool
+nouveau_exa_trap_rasterize(PicturePtr pmask, int ox, int oy,
+			   int ntrap, xTrapezoid *traps)
+{
+	ScreenPtr pScreen = pmask->pDrawable->pScreen;
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+	ExaDriverPtr exa = pNv->EXADriverPtr;
+	PixmapPtr pdpix = NVGetDrawablePixmap(pmask->pDrawable);
+	PicturePtr pedge;
+	PixmapPtr pepix;
+	int i;
+
+	for (i = 0; i < ntrap; i++) {
+		if (xTrapezoidValid(&traps[i]) &&
+		    nouveau_exa_trap_thin(&traps[i]))
+			NOUVEAU_FALLBACK("trapezoid under a pixel wide\n");
+	}
+
+	pedge = nouveau_exa_trap_edge(pScreen);
+	if (!pedge)
+		return FALSE;
+	pepix = NVGetDrawablePixmap(pedge->pDrawable);
+
+	exaMoveInPixmap(pepix);
+	exaMoveInPixmap(pdpix);
+	if (!nouveau_pixmap_bo(pepix) || !nouveau_pixmap_bo(pdpix))
+		return FALSE;
+
+	if (!exa->CheckComposite(PictOpAdd, pedge, pedge, pmask) ||
+	    !exa->PrepareComposite(PictOpAdd, pedge, pedge, pmask,
+				   pepix, pepix, pdpix))
+		return FALSE;
+
+	for (; ntrap; ntrap--, traps++) {
+		double la, lb, lc, ra, rb, rc;
+		double top, bot;
+		int32_t s[6], m[6];
+		int x[3], y[3], i;
+		BoxRec box;
+
+		if (!xTrapezoidValid(traps))
+			continue;
+
+		/* partially covered pixels can hang off the exact bounds */
+		miTrapezoidBounds(1, traps, &box);
+		box.x1 = max(box.x1 + ox - 1, 0);
+		box.y1 = max(box.y1 + oy - 1, 0);
+		box.x2 = min(box.x2 + ox + 1, pdpix->drawable.width);
+		box.y2 = min(box.y2 + oy + 1, pdpix->drawable.height);
+		if (box.x1 >= box.x2 || box.y1 >= box.y2)
+			continue;
+
+		nouveau_exa_trap_line(&traps->left, &la, &lb, &lc);
+		nouveau_exa_trap_line(&traps->right, &ra, &rb, &rc);
+		top = xFixedToDouble(traps->top);
+		bot = xFixedToDouble(traps->bottom);
+
+		/* top-left, top-right, bottom-left, in trapezoid space */
+		x[0] = x[2] = box.x1 - ox;
+		x[1] = box.x2 - ox;
+		y[0] = y[1] = box.y1 - oy;
+		y[2] = box.y2 - oy;
+
+		for (i = 0; i < 3; i++) {
+			s[i * 2 + 0] = nouveau_exa_trap_coord(0, 1, -top,
+							      x[i], y[i]);
+			s[i * 2 + 1] = nouveau_exa_trap_coord(0, -1, bot,
+							      x[i], y[i]);
+			m[i * 2 + 0] = nouveau_exa_trap_coord(la, lb, lc,
+							      x[i], y[i]);
+			m[i * 2 + 1] = nouveau_exa_trap_coord(-ra, -rb, -rc,
+							      x[i], y[i]);
+		}
+
+		pNv->exa_composite_affine(pdpix, box.x1, box.y1,
+					  box.x2 - box.x1, box.y2 - box.y1,
+					  s, m);
+	}
+
+	exa->DoneComposite(pdpix);
+	exaMarkSync(pScreen);
+	return TRUE;
+}
+
+/* Composite through an a8 mask of the trapezoids, as miTrapezoids() */
+static Bool
+nouveau_exa_trap_composite(CARD8 op, PicturePtr pSrc, PicturePtr pDst,
+			   PictFormatPtr maskFormat, INT16 xSrc, INT16 ySrc,
+			   INT16 xDst, INT16 yDst, int ntrap, xTrapezoid *traps)
+{
+	ScreenPtr pScreen = pDst->pDrawable->pScreen;
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+	ExaDriverPtr exa = pNv->EXADriverPtr;
+	PicturePtr pmask;
+	PixmapPtr ppix;
+	BoxRec bounds;
+	int width, height, error;
+
+	miTrapezoidBounds(ntrap, traps, &bounds);
+	if (bounds.y1 >= bounds.y2 || bounds.x1 >= bounds.x2)
+		return TRUE;
+
+	width = bounds.x2 - bounds.x1;
+	height = bounds.y2 - bounds.y1;
+	if (width > exa->maxX || height > exa->maxY)
+		return FALSE;
+
+	ppix = pScreen->CreatePixmap(pScreen, width, height, 8,
+				     CREATE_PIXMAP_USAGE_SCRATCH);
+	if (!ppix)
+		return FALSE;
+
+	pmask = CreatePicture(0, &ppix->drawable, maskFormat, 0, 0,
+			      serverClient, &error);
+	if (!pmask) {
+		pScreen->DestroyPixmap(ppix);
+		return FALSE;
+	}
+
+	exaMoveInPixmap(ppix);
+	if (!nouveau_pixmap_bo(ppix) ||
+	    !exa->PrepareSolid(ppix, GXcopy, ~0, 0)) {
+		FreePicture(pmask, 0);
+		pScreen->DestroyPixmap(ppix);
+		return FALSE;
+	}
+	exa->Solid(ppix, 0, 0, width, height);
+	exa->DoneSolid(ppix);
+
+	if (!nouveau_exa_trap_rasterize(pmask, -bounds.x1, -bounds.y1,
+					ntrap, traps)) {
+		FreePicture(pmask, 0);
+		pScreen->DestroyPixmap(ppix);
+		return FALSE;
+	}
+
+	CompositePicture(op, pSrc, pmask, pDst,
+			 bounds.x1 + xSrc - xDst, bounds.y1 + ySrc - yDst,
+			 0, 0, bounds.x1, bounds.y1, width, height);
+	FreePicture(pmask, 0);
+	pScreen->DestroyPixmap(ppix);
+	return TRUE;
+}
+
+static void
+nouveau_exa_trapezoids(CARD8 op, PicturePtr pSrc, PicturePtr pDst,
+		       PictFormatPtr maskFormat, INT16 xSrc, INT16 ySrc,
+		       int ntrap, xTrapezoid *traps)
+{
+	ScreenPtr pScreen = pDst->pDrawable->pScreen;
+	PictureScreenPtr ps = GetPictureScreen(pScreen);
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+
+	if (maskFormat && maskFormat->format == PICT_a8 && ntrap > 0 &&
+	    nouveau_exa_trap_composite(op, pSrc, pDst, maskFormat, xSrc, ySrc,
+				       traps[0].left.p1.x >> 16,
+				       traps[0].left.p1.y >> 16,
+				       ntrap, traps))
+		return;
+
+	ps->Trapezoids = pNv->Trapezoids;
+	ps->Trapezoids(op, pSrc, pDst, maskFormat, xSrc, ySrc, ntrap, traps);
+	ps->Trapezoids = nouveau_exa_trapezoids;
+}
+
+/* split a triangle into (up to) two trapezoids at its middle vertex */
+static int
+nouveau_exa_tri_traps(const xTriangle *tri, xTrapezoid *trap)
+{
+	const xPointFixed *a = &tri->p1, *b = &tri->p2, *c = &tri->p3, *t;
+	xLineFixed ac, ab, bc;
+	int64_t side;
+	int n = 0;
+
+	if (b->y < a->y) { t = a; a = b; b = t; }
+	if (c->y < a->y) { t = a; a = c; c = t; }
+	if (c->y < b->y) { t = b; b = c; c = t; }
+
+	side = (int64_t)(c->x - a->x) * (b->y - a->y) -
+	       (int64_t)(c->y - a->y) * (b->x - a->x);
+	if (!side)
+		return 0;
+
+	ac.p1 = *a; ac.p2 = *c;
+	ab.p1 = *a; ab.p2 = *b;
+	bc.p1 = *b; bc.p2 = *c;
+
+	/* side < 0: b is right of the long edge */
+	if (b->y > a->y) {
+		trap[n].top = a->y;
+		trap[n].bottom = b->y;
+		trap[n].left = side < 0 ? ac : ab;
+		trap[n].right = side < 0 ? ab : ac;
+		n++;
+	}
+
+	if (c->y > b->y) {
+		trap[n].top = b->y;
+		trap[n].bottom = c->y;
+		trap[n].left = side < 0 ? ac : bc;
+		trap[n].right = side < 0 ? bc : ac;
+		n++;
+	}
+
+	return n;
+}
+
+static void
+nouveau_exa_triangles(CARD8 op, PicturePtr pSrc, PicturePtr pDst,
+		      PictFormatPtr maskFormat, INT16 xSrc, INT16 ySrc,
+		      int ntri, xTriangle *tris)
+{
+	ScreenPtr pScreen = pDst->pDrawable->pScreen;
+	PictureScreenPtr ps = GetPictureScreen(pScreen);
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+	xTrapezoid *traps;
+	int ntrap = 0, i;
+	Bool ret;
+
+	if (!maskFormat || maskFormat->format != PICT_a8 || ntri <= 0)
+		goto fallback;
+
+	traps = malloc(ntri * 2 * sizeof(*traps));
+	if (!traps)
+		goto fallback;
+
+	for (i = 0; i < ntri; i++)
+		ntrap += nouveau_exa_tri_traps(&tris[i], &traps[ntrap]);
+
+	ret = nouveau_exa_trap_composite(op, pSrc, pDst, maskFormat,
+					 xSrc, ySrc,
+					 tris[0].p1.x >> 16, tris[0].p1.y >> 16,
+					 ntrap, traps);
+	free(traps);
+	if (ret)
+		return;
+
+fallback:
+	ps->Triangles = pNv->Triangles;
+	ps->Triangles(op, pSrc, pDst, maskFormat, xSrc, ySrc, ntri, tris);
+	ps->Triangles = nouveau_exa_triangles;
+}
+
+static void
+nouveau_exa_add_traps(PicturePtr pPicture, INT16 xOff, INT16 yOff,
+		      int ntrap, xTrap *traps)
+{
+	ScreenPtr pScreen = pPicture->pDrawable->pScreen;
+	PictureScreenPtr ps = GetPictureScreen(pScreen);
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+	xTrapezoid *trapz;
+	int i;
+	Bool ret;
+
+	if (pPicture->format != PICT_a8 || ntrap <= 0 ||
+	    pPicture->pDrawable->type != DRAWABLE_PIXMAP ||
+	    pPicture->clientClip)
+		goto fallback;
+
+	trapz = malloc(ntrap * sizeof(*trapz));
+	if (!trapz)
+		goto fallback;
+
+	for (i = 0; i < ntrap; i++) {
+		trapz[i].top = traps[i].top.y;
+		trapz[i].bottom = traps[i].bot.y;
+		trapz[i].left.p1.x = traps[i].top.l;
+		trapz[i].left.p1.y = traps[i].top.y;
+		trapz[i].left.p2.x = traps[i].bot.l;
+		trapz[i].left.p2.y = traps[i].bot.y;
+		trapz[i].right.p1.x = traps[i].top.r;
+		trapz[i].right.p1.y = traps[i].top.y;
+		trapz[i].right.p2.x = traps[i].bot.r;
+		trapz[i].right.p2.y = traps[i].bot.y;
+	}
+
+	ret = nouveau_exa_trap_rasterize(pPicture, xOff, yOff, ntrap, trapz);
+	free(trapz);
+	if (ret)
+		return;
+
+fallback:
+	ps->AddTraps = pNv->AddTraps;
+	ps->AddTraps(pPicture, xOff, yOff, ntrap, traps);
+	ps->AddTraps = nouveau_exa_add_traps;
+}
+
+/* Glyphs
+ *
+ * EXA's glyph cache only takes glyphs up to 32x32, in fixed size cells
+ * it evicts at random, and finds them again by hashing their contents.
+ * Glyphs are packed into one atlas per class (a8 for the alpha-only
+ * formats, a8r8g8b8 otherwise) instead, on shelves a multiple of
+ * NOUVEAU_GLYPH_SHELF rows high, and the atlas positions are kept in a
+ * glyph private, one per screen as each screen has its own atlases.
+ * Once an atlas is full, the least recently drawn shelf is recycled.
+ *
+ * A glyph string is then Add'ed into a mask one batch at a time, the
+ * atlas as the source of a single composite each, and the mask is
+ * composited as miGlyphs() does.  Without a mask format that's only
+ * the same as compositing each glyph in turn when they don't overlap,
+ * and for operators that leave the destination alone where the mask
+ * is empty.
+ */
+#define NOUVEAU_GLYPH_ATLAS 1024
+#define NOUVEAU_GLYPH_SHELF 8
+#define NOUVEAU_GLYPH_MAX 64
+#define NOUVEAU_GLYPH_BATCH 256
+
+struct nouveau_glyph_shelf {
+	int y, height;
+	int x;			/* first free column */
+	uint32_t gen;		/* changes whenever the shelf is recycled */
+	uint32_t age;		/* last batch that drew from the shelf */
+};
+
+struct nouveau_glyph_atlas {
+	PicturePtr ppict;
+	int nshelf, top;
+	uint32_t serial;
+	struct nouveau_glyph_shelf
+		shelf[NOUVEAU_GLYPH_ATLAS / NOUVEAU_GLYPH_SHELF];
+};
+
+struct nouveau_glyph {
+	uint32_t gen;
+	uint16_t shelf;
+	uint16_t x;
+};
+
+struct nouveau_glyph_rect {
+	int sx, sy;
+	int dx, dy;
+	int w, h;
+};
+
+static DevPrivateKeyRec nouveau_glyph_key;
+
+#define nouveau_glyph(glyph, pScreen)                                          \
+	(&((struct nouveau_glyph *)dixGetPrivateAddr(&(glyph)->devPrivates,    \
+						     &nouveau_glyph_key))      \
+	  [(pScreen)->myNum])
+
+/* shelf generations are unique across atlases (and screens) */
+static uint32_t nouveau_glyph_gen;
+
+static struct nouveau_glyph_atlas *
+nouveau_exa_glyph_atlas(ScreenPtr pScreen, int argb)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+	struct nouveau_glyph_atlas *atlas = pNv->glyph_atlas[argb];
+	int depth = argb ? 32 : 8;
+	PixmapPtr ppix;
+	int error;
+
+	if (atlas)
+		return atlas;
+
+	atlas = calloc(1, sizeof(*atlas));
+	if (!atlas)
+		return NULL;
+
+	ppix = pScreen->CreatePixmap(pScreen, NOUVEAU_GLYPH_ATLAS,
+				     NOUVEAU_GLYPH_ATLAS, depth, 0);
+	if (!ppix) {
+		free(atlas);
+		return NULL;
+	}
+
+	atlas->ppict = CreatePicture(0, &ppix->drawable,
+				     PictureMatchFormat(pScreen, depth,
+						argb ? PICT_a8r8g8b8 : PICT_a8),
+				     0, 0, serverClient, &error);
+	pScreen->DestroyPixmap(ppix);
+	if (!atlas->ppict) {
+		free(atlas);
+		return NULL;
+	}
+
+	atlas->serial = 1;
+	pNv->glyph_atlas[argb] = atlas;
+	return atlas;
+}
+
+void
+nouveau_exa_glyphs_fini(ScreenPtr pScreen)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		if (!pNv->glyph_atlas[i])
+			continue;
+
+		FreePicture(pNv->glyph_atlas[i]->ppict, 0);
+		free(pNv->glyph_atlas[i]);
+		pNv->glyph_atlas[i] = NULL;
+	}
+}
+
+/* Room for a w x h glyph: a shelf of its height with space left, a new
+ * shelf, or the least recently drawn one of its height (or failing that,
+ * taller) to recycle.  Shelves the pending batch draws from are kept.
+ */
+static struct nouveau_glyph_shelf *
+nouveau_exa_glyph_shelf(struct nouveau_glyph_atlas *atlas, int w, int h)
+{
+	struct nouveau_glyph_shelf *shelf, *lru = NULL;
+	int i, pass;
+
+	h = NOUVEAU_ALIGN(h, NOUVEAU_GLYPH_SHELF);
+
+	for (i = 0; i < atlas->nshelf; i++) {
+		shelf = &atlas->shelf[i];
+		if (shelf->height == h && shelf->x + w <= NOUVEAU_GLYPH_ATLAS)
+			return shelf;
+	}
+
+	if (atlas->top + h <= NOUVEAU_GLYPH_ATLAS) {
+		shelf = &atlas->shelf[atlas->nshelf++];
+		shelf->y = atlas->top;
+		shelf->height = h;
+		atlas->top += h;
+	} else {
+		for (pass = 0; pass < 2 && !lru; pass++) {
+			for (i = 0; i < atlas->nshelf; i++) {
+				shelf = &atlas->shelf[i];
+				if (pass ? shelf->height <= h :
+					   shelf->height != h)
+					continue;
+				if (shelf->age == atlas->serial)
+					continue;
+				if (!lru || shelf->age < lru->age)
+					lru = shelf;
+			}
+		}
+
+		if (!(shelf = lru))
+			return NULL;
+	}
+
+	shelf->x = 0;
+	shelf->age = atlas->serial;
+	if (!++nouveau_glyph_gen)
+		nouveau_glyph_gen++;
+	shelf->gen = nouveau_glyph_gen;
+	return shelf;
+}
+
+/* Add the pending glyphs from the atlas into pmask, a new batch starts */
+static Bool
+nouveau_exa_glyph_flush(struct nouveau_glyph_atlas *atlas, PicturePtr pmask,
+			struct nouveau_glyph_rect *rect, int nrect)
+{
+	ScreenPtr pScreen = pmask->pDrawable->pScreen;
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+	ExaDriverPtr exa = pNv->EXADriverPtr;
+	PixmapPtr pspix = NVGetDrawablePixmap(atlas->ppict->pDrawable);
+	PixmapPtr pdpix = NVGetDrawablePixmap(pmask->pDrawable);
+	int i;
+
+	atlas->serial++;
+	if (!nrect)
+		return TRUE;
+
+	exaMoveInPixmap(pspix);
+	exaMoveInPixmap(pdpix);
+	if (!nouveau_pixmap_bo(pspix) || !nouveau_pixmap_bo(pdpix))
+		return FALSE;
+
+	if (!exa->CheckComposite(PictOpAdd, atlas->ppict, NULL, pmask) ||
+	    !exa->PrepareComposite(PictOpAdd, atlas->ppict, NULL, pmask,
+				   pspix, NULL, pdpix))
+		return FALSE;
+
+	for (i = 0; i < nrect; i++, rect++) {
+		exa->Composite(pdpix, rect->sx, rect->sy, 0, 0,
+			       rect->dx, rect->dy, rect->w, rect->h);
+	}
+
+	exa->DoneComposite(pdpix);
+	exaMarkSync(pScreen);
+	return TRUE;
+}
+
+/* Add every glyph, offset by (ox, oy), into pmask through the atlas */
+static Bool
+nouveau_exa_glyph_rasterize(PicturePtr pmask, int argb, int ox, int oy,
+			    int nlist, GlyphListPtr list, GlyphPtr *glyphs)
+{
+	ScreenPtr pScreen = pmask->pDrawable->pScreen;
+	struct nouveau_glyph_rect rect[NOUVEAU_GLYPH_BATCH];
+	struct nouveau_glyph_atlas *atlas;
+	int x = ox, y = oy, nrect = 0, n;
+
+	atlas = nouveau_exa_glyph_atlas(pScreen, argb);
+	if (!atlas)
+		return FALSE;
+
+	for (; nlist; nlist--, list++) {
+		x += list->xOff;
+		y += list->yOff;
+
+		for (n = list->len; n; n--, glyphs++) {
+			GlyphPtr glyph = *glyphs;
+			struct nouveau_glyph *priv =
+				nouveau_glyph(glyph, pScreen);
+			struct nouveau_glyph_shelf *shelf = NULL;
+			PicturePtr ppict = GetGlyphPicture(glyph, pScreen);
+			int w = glyph->info.width, h = glyph->info.height;
+
+			if (!ppict || !w || !h)
+				goto next;
+
+			if (priv->gen && priv->shelf < atlas->nshelf &&
+			    atlas->shelf[priv->shelf].gen == priv->gen)
+				shelf = &atlas->shelf[priv->shelf];
+
+			if (!shelf) {
+				shelf = nouveau_exa_glyph_shelf(atlas, w, h);
+				if (!shelf) {
+					if (!nouveau_exa_glyph_flush(atlas, pmask,
+								     rect, nrect))
+						return FALSE;
+					nrect = 0;
+
+					shelf = nouveau_exa_glyph_shelf(atlas,
+									w, h);
+				}
+				if (!shelf) {
+					/* nothing tall enough, start over */
+					atlas->nshelf = 0;
+					atlas->top = 0;
+					shelf = nouveau_exa_glyph_shelf(atlas,
+									w, h);
+				}
+
+				priv->gen = shelf->gen;
+				priv->shelf = shelf - atlas->shelf;
+				priv->x = shelf->x;
+				shelf->x += w;
+
+				CompositePicture(PictOpSrc, ppict, NULL,
+						 atlas->ppict, 0, 0, 0, 0,
+						 priv->x, shelf->y, w, h);
+			}
+
+			shelf->age = atlas->serial;
+			rect[nrect].sx = priv->x;
+			rect[nrect].sy = shelf->y;
+			rect[nrect].dx = x - glyph->info.x;
+			rect[nrect].dy = y - glyph->info.y;
+			rect[nrect].w = w;
+			rect[nrect].h = h;
+			if (++nrect == NOUVEAU_GLYPH_BATCH) {
+				if (!nouveau_exa_glyph_flush(atlas, pmask,
+							     rect, nrect))
+					return FALSE;
+				nrect = 0;
+			}
+next:
+			x += glyph->info.xOff;
+			y += glyph->info.yOff;
+		}
+	}
+
+	return nouveau_exa_glyph_flush(atlas, pmask, rect, nrect);
+}
+
+/* The atlas all the glyphs can go through (0 for a8, 1 for a8r8g8b8),
+ * or -1.  Also whether any glyph's bounds meet those of the glyphs
+ * before it, which is conservative but cheap.
+ */
+static int
+nouveau_exa_glyphs_check(ScreenPtr pScreen, int nlist, GlyphListPtr list,
+			 GlyphPtr *glyphs, Bool *overlap)
+{
+	BoxRec extents = { MAXSHORT, MAXSHORT, MINSHORT, MINSHORT };
+	int x = 0, y = 0, argb = -1, n;
+
+	*overlap = FALSE;
+
+	for (; nlist; nlist--, list++) {
+		x += list->xOff;
+		y += list->yOff;
+
+		for (n = list->len; n; n--, glyphs++) {
+			GlyphPtr glyph = *glyphs;
+			PicturePtr ppict = GetGlyphPicture(glyph, pScreen);
+			int w = glyph->info.width, h = glyph->info.height;
+			BoxRec box;
+
+			if (ppict && w && h) {
+				int which;
+
+				if (w > NOUVEAU_GLYPH_MAX ||
+				    h > NOUVEAU_GLYPH_MAX)
+					return -1;
+
+				if (!PICT_FORMAT_RGB(ppict->format))
+					which = 0;
+				else
+				if (ppict->format == PICT_a8r8g8b8)
+					which = 1;
+				else
+					return -1;
+
+				if (argb >= 0 && argb != which)
+					return -1;
+				argb = which;
+
+				box.x1 = x - glyph->info.x;
+				box.y1 = y - glyph->info.y;
+				box.x2 = box.x1 + w;
+				box.y2 = box.y1 + h;
+
+				if (box.x1 < extents.x2 &&
+				    box.x2 > extents.x1 &&
+				    box.y1 < extents.y2 &&
+				    box.y2 > extents.y1)
+					*overlap = TRUE;
+
+				extents.x1 = min(extents.x1, box.x1);
+				extents.y1 = min(extents.y1, box.y1);
+				extents.x2 = max(extents.x2, box.x2);
+				extents.y2 = max(extents.y2, box.y2);
+			}
+
+			x += glyph->info.xOff;
+			y += glyph->info.yOff;
+		}
+	}
+
+	return argb;
+}
+
+static Bool
+nouveau_exa_glyph_composite(CARD8 op, PicturePtr pSrc, PicturePtr pDst,
+			    PictFormatPtr maskFormat, INT16 xSrc, INT16 ySrc,
+			    int nlist, GlyphListPtr list, GlyphPtr *glyphs)
+{
+	ScreenPtr pScreen = pDst->pDrawable->pScreen;
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+	ExaDriverPtr exa = pNv->EXADriverPtr;
+	PicturePtr pmask;
+	PixmapPtr ppix;
+	BoxRec extents;
+	XID component_alpha;
+	Bool overlap;
+	int width, height, argb, error;
+
+	argb = nouveau_exa_glyphs_check(pScreen, nlist, list, glyphs,
+					&overlap);
+	if (argb < 0)
+		return FALSE;
+
+	if (!maskFormat) {
+		if (overlap || (op != PictOpOver && op != PictOpAdd))
+			return FALSE;
+
+		maskFormat = PictureMatchFormat(pScreen, argb ? 32 : 8,
+						argb ? PICT_a8r8g8b8 : PICT_a8);
+		if (!maskFormat)
+			return FALSE;
+	}
+
+	GlyphExtents(nlist, list, glyphs, &extents);
+	if (extents.x2 <= extents.x1 || extents.y2 <= extents.y1)
+		return TRUE;
+
+	width = extents.x2 - extents.x1;
+	height = extents.y2 - extents.y1;
+	if (width > exa->maxX || height > exa->maxY)
+		return FALSE;
+
+	ppix = pScreen->CreatePixmap(pScreen, width, height, maskFormat->depth,
+				     CREATE_PIXMAP_USAGE_SCRATCH);
+	if (!ppix)
+		return FALSE;
+
+	component_alpha = PICT_FORMAT_A(maskFormat->format) &&
+			  PICT_FORMAT_RGB(maskFormat->format);
+	pmask = CreatePicture(0, &ppix->drawable, maskFormat,
+			      CPComponentAlpha, &component_alpha,
+			      serverClient, &error);
+	if (!pmask) {
+		pScreen->DestroyPixmap(ppix);
+		return FALSE;
+	}
+
+	exaMoveInPixmap(ppix);
+	if (!nouveau_pixmap_bo(ppix) ||
+	    !exa->PrepareSolid(ppix, GXcopy, ~0, 0)) {
+		FreePicture(pmask, 0);
+		pScreen->DestroyPixmap(ppix);
+		return FALSE;
+	}
+	exa->Solid(ppix, 0, 0, width, height);
+	exa->DoneSolid(ppix);
+
+	if (!nouveau_exa_glyph_rasterize(pmask, argb, -extents.x1, -extents.y1,
+					 nlist, list, glyphs)) {
+		FreePicture(pmask, 0);
+		pScreen->DestroyPixmap(ppix);
+		return FALSE;
+	}
+
+	CompositePicture(op, pSrc, pmask, pDst,
+			 xSrc + extents.x1 - list->xOff,
+			 ySrc + extents.y1 - list->yOff,
+			 0, 0, extents.x1, extents.y1, width, height);
+	FreePicture(pmask, 0);
+	pScreen->DestroyPixmap(ppix);
+	return TRUE;
+}
+
+static void
+nouveau_exa_glyphs(CARD8 op, PicturePtr pSrc, PicturePtr pDst,
+		   PictFormatPtr maskFormat, INT16 xSrc, INT16 ySrc,
+		   int nlist, GlyphListPtr list, GlyphPtr *glyphs)
+{
+	ScreenPtr pScreen = pDst->pDrawable->pScreen;
+	PictureScreenPtr ps = GetPictureScreen(pScreen);
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+
+	if (nlist > 0 &&
+	    nouveau_exa_glyph_composite(op, pSrc, pDst, maskFormat, xSrc, ySrc,
+					nlist, list, glyphs))
+		return;
+
+	ps->Glyphs = pNv->Glyphs;
+	ps->Glyphs(op, pSrc, pDst, maskFormat, xSrc, ySrc, nlist, list, glyphs);
+	ps->Glyphs = nouveau_exa_glyphs;
+}
+
+static void
+nouveau_exa_flush(ScrnInfoPtr pScrn)
+{
+	NVPtr pNv = NVPTR(pScrn);
+	NVAccelKick(pNv);
+	pNv->fence_seq++;
 }
 
 Bool
@@ -414,6 +2579,8 @@ nouveau_exa_init(ScreenPtr pScreen)
 	if (!xf86LoadSubModule(pScrn, "exa"))
 		return FALSE;
 
+	nouveau_memcpy_init(pScrn);
+
 	exa = exaDriverAlloc();
 	if (!exa)
 		return FALSE;
@@ -441,6 +2608,10 @@ nouveau_exa_init(ScreenPtr pScreen)
 	exa->SetSharedPixmapBacking = nouveau_exa_set_shared_pixmap_backing;
 #endif
 
+	if (pNv->Architecture >= NV_FERMI) {
+		exa->maxX = 16384;
+		exa->maxY = 16384;
+	} else
 	if (pNv->Architecture >= NV_TESLA) {
 		exa->maxX = 8192;
 		exa->maxY = 8192;
@@ -476,6 +2647,7 @@ nouveau_exa_init(ScreenPtr pScreen)
 		exa->PrepareSolid = NV50EXAPrepareSolid;
 		exa->Solid = NV50EXASolid;
 		exa->DoneSolid = NV50EXADoneSolid;
+		pNv->exa_solid_boxes = NV50EXASolidBoxes;
 	} else {
 		exa->PrepareCopy = NVC0EXAPrepareCopy;
 		exa->Copy        = NVC0EXACopy;
@@ -484,6 +2656,7 @@ nouveau_exa_init(ScreenPtr pScreen)
 		exa->PrepareSolid = NVC0EXAPrepareSolid;
 		exa->Solid        = NVC0EXASolid;
 		exa->DoneSolid    = NVC0EXADoneSolid;
+		pNv->exa_solid_boxes = NVC0EXASolidBoxes;
 	}
 
 	switch (pNv->Architecture) {	
@@ -511,23 +2684,83 @@ nouveau_exa_init(ScreenPtr pScreen)
 		exa->PrepareComposite = NV50EXAPrepareComposite;
 		exa->Composite        = NV50EXAComposite;
 		exa->DoneComposite    = NV50EXADoneComposite;
+		pNv->exa_composite_affine = NV50EXACompositeAffine;
 		break;
 	case NV_FERMI:
 	case NV_KEPLER:
+	case NV_MAXWELL:
 		exa->CheckComposite   = NVC0EXACheckComposite;
 		exa->PrepareComposite = NVC0EXAPrepareComposite;
 		exa->Composite        = NVC0EXAComposite;
 		exa->DoneComposite    = NVC0EXADoneComposite;
+		pNv->exa_composite_affine = NVC0EXACompositeAffine;
 		break;
-	case NV_MAXWELL:
 	default:
 		break;
 	}
 
+	pNv->exa_prepare_solid = exa->PrepareSolid;
+	exa->PrepareSolid = nouveau_exa_prepare_solid;
+	pNv->exa_prepare_copy = exa->PrepareCopy;
+	exa->PrepareCopy = nouveau_exa_prepare_copy;
+	if (exa->PrepareComposite) {
+		pNv->exa_check_composite = exa->CheckComposite;
+		exa->CheckComposite = nouveau_exa_check_composite;
+		pNv->exa_prepare_composite = exa->PrepareComposite;
+		exa->PrepareComposite = nouveau_exa_prepare_composite;
+	}
+
+	if (pNv->push_stats) {
+		pNv->exa_done_solid = exa->DoneSolid;
+		exa->DoneSolid = nouveau_exa_done_solid;
+		pNv->exa_done_copy = exa->DoneCopy;
+		exa->DoneCopy = nouveau_exa_done_copy;
+		if (exa->DoneComposite) {
+			pNv->exa_done_composite = exa->DoneComposite;
+			exa->DoneComposite = nouveau_exa_done_composite;
+		}
+	}
+
+	pNv->fence_seq = 1;
+	pNv->fence_done = 0;
+	nouveau_exa_upload_defaults(pNv);
+
 	if (!exaDriverInit(pScreen, exa))
 		return FALSE;
 
 	pNv->EXADriverPtr = exa;
+
+	if (pNv->exa_solid_boxes) {
+		if (!dixPrivateKeyRegistered(&nouveau_gc_key) &&
+		    !dixRegisterPrivateKey(&nouveau_gc_key, PRIVATE_GC,
+					   sizeof(struct nouveau_gc)))
+			return FALSE;
+
+		pNv->CreateGC = pScreen->CreateGC;
+		pScreen->CreateGC = nouveau_exa_create_gc;
+	}
+
+	if (pNv->exa_composite_affine) {
+		PictureScreenPtr ps = GetPictureScreenIfSet(pScreen);
+
+		if (ps) {
+			pNv->Trapezoids = ps->Trapezoids;
+			ps->Trapezoids = nouveau_exa_trapezoids;
+			pNv->Triangles = ps->Triangles;
+			ps->Triangles = nouveau_exa_triangles;
+			pNv->AddTraps = ps->AddTraps;
+			ps->AddTraps = nouveau_exa_add_traps;
+
+			if (!dixPrivateKeyRegistered(&nouveau_glyph_key) &&
+			    !dixRegisterPrivateKey(&nouveau_glyph_key,
+						   PRIVATE_GLYPH, MAXSCREENS *
+						   sizeof(struct nouveau_glyph)))
+				return FALSE;
+			pNv->Glyphs = ps->Glyphs;
+			ps->Glyphs = nouveau_exa_glyphs;
+		}
+	}
+
 	pNv->Flush = nouveau_exa_flush;
 	return TRUE;
 }
@@ -32,14 +32,43 @@
 #define NOUVEAU_MSG(fmt,args...) ErrorF(fmt, ##args)
 #define NOUVEAU_ERR(fmt,args...) \
 	ErrorF("%s:%d - "fmt, __func__, __LINE__, ##args)
+
+/* Every fallback site counts its hits, see nouveau_stats.c */
+struct nouveau_fallback_site {
+	const char *func;
+	int line;
+	const char *reason;
+	uint64_t count;
+	struct nouveau_fallback_site *next;
+};
+
+extern struct nouveau_fallback_site *nouveau_fallback_sites;
+extern struct nouveau_fallback_site *nouveau_fallback_last;
+extern uint64_t nouveau_fallback_total;
+
+static inline void
+nouveau_fallback_hit(struct nouveau_fallback_site *site)
+{
+	if (!site->count++) {
+		site->next = nouveau_fallback_sites;
+		nouveau_fallback_sites = site;
+	}
+	nouveau_fallback_last = site;
+	nouveau_fallback_total++;
+}
+
 #if 0
-#define NOUVEAU_FALLBACK(fmt,args...) do {    \
-	NOUVEAU_ERR("FALLBACK: "fmt, ##args); \
-	return FALSE;                         \
+#define NOUVEAU_FALLBACK(fmt,args...) do {                                  \
+	static struct nouveau_fallback_site site = { __func__, __LINE__, fmt }; \
+	nouveau_fallback_hit(&site);                                        \
+	NOUVEAU_ERR("FALLBACK: "fmt, ##args);                               \
+	return FALSE;                                                       \
 } while(0)
 #else
-#define NOUVEAU_FALLBACK(fmt,args...) do {    \
-	return FALSE;                         \
+#define NOUVEAU_FALLBACK(fmt,args...) do {                                  \
+	static struct nouveau_fallback_site site = { __func__, __LINE__, fmt }; \
+	nouveau_fallback_hit(&site);                                        \
+	return FALSE;                                                       \
 } while(0)
 #endif
 
@@ -101,11 +130,129 @@ PUSH_AVAIL(struct nouveau_pushbuf *push)
 	return push->end - push->cur;
 }
 
+/* Command submission accounting, only active with Option "PushbufStats",
+ * see nouveau_stats.c
+ */
+enum {
+	NOUVEAU_STATS_OTHER = 0,
+	NOUVEAU_STATS_SOLID,
+	NOUVEAU_STATS_COPY,
+	NOUVEAU_STATS_COMPOSITE,
+	NOUVEAU_STATS_UPLOAD,
+	NOUVEAU_STATS_DOWNLOAD,
+	NOUVEAU_STATS_XV,
+	NOUVEAU_STATS_OPS
+};
+
+enum {
+	NOUVEAU_STATS_CALLS = 0,
+	NOUVEAU_STATS_DWORDS,
+	NOUVEAU_STATS_KICKS,
+	NOUVEAU_STATS_VALIDATES,
+	NOUVEAU_STATS_RELOCS,
+	NOUVEAU_STATS_COUNTERS
+};
+
+struct nouveau_stats {
+	uint32_t *mark;
+	int op;
+	uint64_t count[NOUVEAU_STATS_OPS][NOUVEAU_STATS_COUNTERS];
+	struct nouveau_stats_decoder *dec;
+};
+
+void nouveau_stats_decode(struct nouveau_stats *, const uint32_t *start,
+			  const uint32_t *end);
+
+/* what pushbuf->user_priv points at, one per screen's main pushbuf */
+struct nouveau_push_priv {
+	struct nouveau_bufctx *bufctx;
+	struct nouveau_stats *stats;
+	struct _NVRec *pNv;
+};
+
+static inline struct nouveau_stats *
+nouveau_stats_get(struct nouveau_pushbuf *push)
+{
+	struct nouveau_push_priv *priv = push->user_priv;
+
+	return priv ? priv->stats : NULL;
+}
+
+static inline void
+nouveau_stats_count(struct nouveau_pushbuf *push, int counter)
+{
+	struct nouveau_stats *stats = nouveau_stats_get(push);
+
+	if (stats)
+		stats->count[stats->op][counter]++;
+}
+
+/* charge what's been emitted since the last call to the current op */
+static inline void
+nouveau_stats_sync(struct nouveau_pushbuf *push)
+{
+	struct nouveau_stats *stats = nouveau_stats_get(push);
+
+	if (!stats)
+		return;
+
+	/* libdrm may have switched buffers behind our back */
+	if (stats->mark && push->cur >= stats->mark && push->cur <= push->end) {
+		stats->count[stats->op][NOUVEAU_STATS_DWORDS] +=
+			push->cur - stats->mark;
+		nouveau_stats_decode(stats, stats->mark, push->cur);
+	} else {
+		nouveau_stats_decode(stats, NULL, NULL);
+	}
+	stats->mark = push->cur;
+}
+
+static inline void
+nouveau_stats_begin(struct nouveau_pushbuf *push, int op)
+{
+	struct nouveau_stats *stats = nouveau_stats_get(push);
+
+	if (stats) {
+		nouveau_stats_sync(push);
+		stats->op = op;
+		nouveau_stats_count(push, NOUVEAU_STATS_CALLS);
+	}
+}
+
+static inline void
+nouveau_stats_end(struct nouveau_pushbuf *push)
+{
+	struct nouveau_stats *stats = nouveau_stats_get(push);
+
+	if (stats) {
+		nouveau_stats_sync(push);
+		stats->op = NOUVEAU_STATS_OTHER;
+	}
+}
+
+/* the buffer may have been switched, start counting afresh; kicks
+ * themselves are counted from pushbuf->kick_notify
+ */
+static inline void
+nouveau_stats_remark(struct nouveau_pushbuf *push)
+{
+	struct nouveau_stats *stats = nouveau_stats_get(push);
+
+	if (stats)
+		stats->mark = push->cur;
+}
+
 static inline Bool
 PUSH_SPACE(struct nouveau_pushbuf *push, uint32_t size)
 {
-	if (PUSH_AVAIL(push) < size)
-		return nouveau_pushbuf_space(push, size, 0, 0) == 0;
+	if (PUSH_AVAIL(push) < size) {
+		Bool ret;
+
+		nouveau_stats_sync(push);
+		ret = nouveau_pushbuf_space(push, size, 0, 0) == 0;
+		nouveau_stats_remark(push);
+		return ret;
+	}
 	return TRUE;
 }
 
@@ -126,21 +273,41 @@ static inline void
 PUSH_RELOC(struct nouveau_pushbuf *push, struct nouveau_bo *bo, uint32_t offset,
 	   uint32_t flags, uint32_t vor, uint32_t tor)
 {
+	nouveau_stats_count(push, NOUVEAU_STATS_RELOCS);
 	nouveau_pushbuf_reloc(push, bo, offset, flags, vor, tor);
 }
 
 static inline void
 PUSH_KICK(struct nouveau_pushbuf *push)
 {
+	nouveau_stats_sync(push);
 	nouveau_pushbuf_kick(push, push->channel);
+	nouveau_stats_remark(push);
+}
+
+static inline int
+PUSH_VAL(struct nouveau_pushbuf *push)
+{
+	nouveau_stats_count(push, NOUVEAU_STATS_VALIDATES);
+	return nouveau_pushbuf_validate(push);
 }
 
 static inline struct nouveau_bufctx *
 BUFCTX(struct nouveau_pushbuf *push)
 {
-	return push->user_priv;
+	struct nouveau_push_priv *priv = push->user_priv;
+
+	return priv->bufctx;
 }
 
+/* Bin 0 holds the buffers of the op being set up and is emptied by
+ * PUSH_RESET.  Buffers that stay in use across ops go in bins of their
+ * own, like the composite vertex array.  Either way they're revalidated
+ * after every kick for as long as the bufctx is bound.
+ */
+#define NOUVEAU_BIN_VTX 1
+#define NOUVEAU_BINS 2
+
 static inline void
 PUSH_RESET(struct nouveau_pushbuf *push)
 {
@@ -157,6 +324,7 @@ static inline void
 PUSH_MTHDl(struct nouveau_pushbuf *push, int subc, int mthd,
 	   struct nouveau_bo *bo, uint32_t offset, uint32_t access)
 {
+	nouveau_stats_count(push, NOUVEAU_STATS_RELOCS);
 	nouveau_bufctx_mthd(BUFCTX(push), 0, (1 << 18) | (subc << 13) | mthd,
 			    bo, offset, access | NOUVEAU_BO_LOW, 0, 0);
 	PUSH_DATA (push, bo->offset + offset);
@@ -166,6 +334,7 @@ static inline void
 PUSH_MTHDo(struct nouveau_pushbuf *push, int subc, int mthd,
 	   struct nouveau_bo *bo, uint32_t access, uint32_t vor, uint32_t tor)
 {
+	nouveau_stats_count(push, NOUVEAU_STATS_RELOCS);
 	nouveau_bufctx_mthd(BUFCTX(push), 0, (1 << 18) | (subc << 13) | mthd,
 			    bo, 0, access | NOUVEAU_BO_OR, vor, tor);
 	if (bo->flags & NOUVEAU_BO_VRAM)
@@ -179,6 +348,7 @@ PUSH_MTHDs(struct nouveau_pushbuf *push, int subc, int mthd,
 	   struct nouveau_bo *bo, uint32_t data, uint32_t access,
 	   uint32_t vor, uint32_t tor)
 {
+	nouveau_stats_count(push, NOUVEAU_STATS_RELOCS);
 	nouveau_bufctx_mthd(BUFCTX(push), 0, (1 << 18) | (subc << 13) | mthd,
 			    bo, data, access | NOUVEAU_BO_OR, vor, tor);
 	if (bo->flags & NOUVEAU_BO_VRAM)
@@ -192,6 +362,7 @@ PUSH_MTHD(struct nouveau_pushbuf *push, int subc, int mthd,
 	  struct nouveau_bo *bo, uint32_t data, uint32_t access,
 	  uint32_t vor, uint32_t tor)
 {
+	nouveau_stats_count(push, NOUVEAU_STATS_RELOCS);
 	nouveau_bufctx_mthd(BUFCTX(push), 0, (1 << 18) | (subc << 13) | mthd,
 			    bo, data, access | NOUVEAU_BO_OR, vor, tor);
 	if (access & NOUVEAU_BO_LOW)
@@ -0,0 +1,310 @@
+/*
+ * Copyright 2014 Nouveau Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "nv_include.h"
+
+/* Copy routines for moving data in and out of write-combined/uncached
+ * buffer mappings (GART staging buffers, VRAM through the BAR).
+ *
+ * Writes to WC memory want full-line non-temporal stores so the CPU never
+ * has to read the destination back.  Reads from WC memory are uncached,
+ * and a plain memcpy() fetches them a few bytes at a time, which is
+ * painfully slow.  MOVNTDQA pulls a whole line into the streaming load
+ * buffers instead.
+ *
+ * The variant is chosen at runtime from the CPU features, and every
+ * candidate is checked against memcpy() before it is used.
+ */
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define NOUVEAU_MEMCPY_X86 1
+#include <immintrin.h>
+#endif
+
+typedef void (*nouveau_memcpy_func)(void *, const void *, size_t);
+
+static void
+nouveau_memcpy_scalar(void *dst, const void *src, size_t n)
+{
+	memcpy(dst, src, n);
+}
+
+#ifdef NOUVEAU_MEMCPY_X86
+__attribute__((target("sse2"))) static void
+nouveau_memcpy_to_wc_sse2(void *dst, const void *src, size_t n)
+{
+	char *d = dst;
+	const char *s = src;
+	size_t head = -(uintptr_t)d & 15;
+
+	if (n < 64 + head) {
+		memcpy(d, s, n);
+		return;
+	}
+
+	memcpy(d, s, head);
+	d += head;
+	s += head;
+	n -= head;
+
+	while (n >= 64) {
+		__m128i r0 = _mm_loadu_si128((const __m128i *)(s +  0));
+		__m128i r1 = _mm_loadu_si128((const __m128i *)(s + 16));
+		__m128i r2 = _mm_loadu_si128((const __m128i *)(s + 32));
+		__m128i r3 = _mm_loadu_si128((const __m128i *)(s + 48));
+		_mm_stream_si128((__m128i *)(d +  0), r0);
+		_mm_stream_si128((__m128i *)(d + 16), r1);
+		_mm_stream_si128((__m128i *)(d + 32), r2);
+		_mm_stream_si128((__m128i *)(d + 48), r3);
+		d += 64;
+		s += 64;
+		n -= 64;
+	}
+
+	_mm_sfence();
+	memcpy(d, s, n);
+}
+
+__attribute__((target("avx2"))) static void
+nouveau_memcpy_to_wc_avx2(void *dst, const void *src, size_t n)
+{
+	char *d = dst;
+	const char *s = src;
+	size_t head = -(uintptr_t)d & 31;
+
+	if (n < 128 + head) {
+		memcpy(d, s, n);
+		return;
+	}
+
+	memcpy(d, s, head);
+	d += head;
+	s += head;
+	n -= head;
+
+	while (n >= 128) {
+		__m256i r0 = _mm256_loadu_si256((const __m256i *)(s +  0));
+		__m256i r1 = _mm256_loadu_si256((const __m256i *)(s + 32));
+		__m256i r2 = _mm256_loadu_si256((const __m256i *)(s + 64));
+		__m256i r3 = _mm256_loadu_si256((const __m256i *)(s + 96));
+		_mm256_stream_si256((__m256i *)(d +  0), r0);
+		_mm256_stream_si256((__m256i *)(d + 32), r1);
+		_mm256_stream_si256((__m256i *)(d + 64), r2);
+		_mm256_stream_si256((__m256i *)(d + 96), r3);
+		d += 128;
+		s += 128;
+		n -= 128;
+	}
+
+	_mm_sfence();
+	memcpy(d, s, n);
+}
+
+__attribute__((target("sse4.1"))) static void
+nouveau_memcpy_from_wc_sse41(void *dst, const void *src, size_t n)
+{
+	char *d = dst;
+	const char *s = src;
+	size_t head = -(uintptr_t)s & 15;
+
+	if (n < 64 + head) {
+		memcpy(d, s, n);
+		return;
+	}
+
+	memcpy(d, s, head);
+	d += head;
+	s += head;
+	n -= head;
+
+	while (n >= 64) {
+		__m128i r0 = _mm_stream_load_si128((__m128i *)(s +  0));
+		__m128i r1 = _mm_stream_load_si128((__m128i *)(s + 16));
+		__m128i r2 = _mm_stream_load_si128((__m128i *)(s + 32));
+		__m128i r3 = _mm_stream_load_si128((__m128i *)(s + 48));
+		_mm_storeu_si128((__m128i *)(d +  0), r0);
+		_mm_storeu_si128((__m128i *)(d + 16), r1);
+		_mm_storeu_si128((__m128i *)(d + 32), r2);
+		_mm_storeu_si128((__m128i *)(d + 48), r3);
+		d += 64;
+		s += 64;
+		n -= 64;
+	}
+
+	memcpy(d, s, n);
+}
+
+__attribute__((target("avx2"))) static void
+nouveau_memcpy_from_wc_avx2(void *dst, const void *src, size_t n)
+{
+	char *d = dst;
+	const char *s = src;
+	size_t head = -(uintptr_t)s & 31;
+
+	if (n < 128 + head) {
+		memcpy(d, s, n);
+		return;
+	}
+
+	memcpy(d, s, head);
+	d += head;
+	s += head;
+	n -= head;
+
+	while (n >= 128) {
+		__m256i r0 = _mm256_stream_load_si256((__m256i *)(s +  0));
+		__m256i r1 = _mm256_stream_load_si256((__m256i *)(s + 32));
+		__m256i r2 = _mm256_stream_load_si256((__m256i *)(s + 64));
+		__m256i r3 = _mm256_stream_load_si256((__m256i *)(s + 96));
+		_mm256_storeu_si256((__m256i *)(d +  0), r0);
+		_mm256_storeu_si256((__m256i *)(d + 32), r1);
+		_mm256_storeu_si256((__m256i *)(d + 64), r2);
+		_mm256_storeu_si256((__m256i *)(d + 96), r3);
+		d += 128;
+		s += 128;
+		n -= 128;
+	}
+
+	memcpy(d, s, n);
+}
+#endif
+
+static nouveau_memcpy_func nouveau_memcpy_to_wc_func = nouveau_memcpy_scalar;
+static nouveau_memcpy_func nouveau_memcpy_from_wc_func = nouveau_memcpy_scalar;
+
+void
+nouveau_memcpy_to_wc(void *dst, const void *src, size_t n)
+{
+	nouveau_memcpy_to_wc_func(dst, src, n);
+}
+
+void
+nouveau_memcpy_from_wc(void *dst, const void *src, size_t n)
+{
+	nouveau_memcpy_from_wc_func(dst, src, n);
+}
+
+/* compare a copy routine against memcpy() over a range of sizes and
+ * (mis)alignments, this catches broken head/tail handling as well as
+ * compilers/assemblers that mangle the intrinsics
+ */
+static Bool
+nouveau_memcpy_check(nouveau_memcpy_func func)
+{
+	static const int size[] = { 0, 1, 15, 63, 64, 127, 128, 129, 1000,
+				    4096 };
+	const size_t len = 4096 + 64;
+	char *src, *dst, *ref;
+	Bool ret = TRUE;
+	size_t i;
+	int so, dof;
+
+	src = malloc(len);
+	dst = malloc(len);
+	ref = malloc(len);
+	if (!src || !dst || !ref) {
+		ret = FALSE;
+		goto out;
+	}
+
+	for (i = 0; i < len; i++)
+		src[i] = (i * 7) ^ (i >> 8);
+
+	for (i = 0; ret && i < sizeof(size) / sizeof(size[0]); i++) {
+		for (so = 0; ret && so < 32; so += 7) {
+			for (dof = 0; ret && dof < 32; dof += 5) {
+				memset(dst, 0xa5, len);
+				memset(ref, 0xa5, len);
+				func(dst + dof, src + so, size[i]);
+				memcpy(ref + dof, src + so, size[i]);
+				if (memcmp(dst, ref, len))
+					ret = FALSE;
+			}
+		}
+	}
+
+out:
+	free(src);
+	free(dst);
+	free(ref);
+	return ret;
+}
+
+static nouveau_memcpy_func
+nouveau_memcpy_pick(ScrnInfoPtr pScrn, const char *dir,
+		    const char **name, nouveau_memcpy_func *func, int nr)
+{
+	int i;
+
+	for (i = 0; i < nr; i++) {
+		if (!func[i])
+			continue;
+
+		if (nouveau_memcpy_check(func[i])) {
+			xf86DrvMsg(pScrn->scrnIndex, X_INFO,
+				   "Using %s copy %s WC mappings\n",
+				   name[i], dir);
+			return func[i];
+		}
+
+		xf86DrvMsg(pScrn->scrnIndex, X_WARNING,
+			   "%s copy %s WC mappings failed self-check\n",
+			   name[i], dir);
+	}
+
+	return nouveau_memcpy_scalar;
+}
+
+void
+nouveau_memcpy_init(ScrnInfoPtr pScrn)
+{
+	const char *to_name[3] = { NULL, NULL, "memcpy" };
+	const char *from_name[3] = { NULL, NULL, "memcpy" };
+	nouveau_memcpy_func to[3] = { NULL, NULL, nouveau_memcpy_scalar };
+	nouveau_memcpy_func from[3] = { NULL, NULL, nouveau_memcpy_scalar };
+
+#ifdef NOUVEAU_MEMCPY_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		to_name[0] = from_name[0] = "AVX2";
+		to[0] = nouveau_memcpy_to_wc_avx2;
+		from[0] = nouveau_memcpy_from_wc_avx2;
+	}
+	if (__builtin_cpu_supports("sse2")) {
+		to_name[1] = "SSE2";
+		to[1] = nouveau_memcpy_to_wc_sse2;
+	}
+	if (__builtin_cpu_supports("sse4.1")) {
+		from_name[1] = "SSE4.1";
+		from[1] = nouveau_memcpy_from_wc_sse41;
+	}
+#endif
+
+	nouveau_memcpy_to_wc_func =
+		nouveau_memcpy_pick(pScrn, "to", to_name, to, 3);
+	nouveau_memcpy_from_wc_func =
+		nouveau_memcpy_pick(pScrn, "from", from_name, from, 3);
+}
@@ -0,0 +1,527 @@
+/*
+ * Copyright 2014 Nouveau Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "nv_include.h"
+#include "property.h"
+#include <X11/Xatom.h>
+
+#include "hwdefs/nv01_2d.xml.h"
+#include "hwdefs/nv10_3d.xml.h"
+#include "hwdefs/nv30-40_3d.xml.h"
+#include "hwdefs/nv50_3d.xml.h"
+#include "hwdefs/nvc0_3d.xml.h"
+
+/* Command submission accounting
+ *
+ * With Option "PushbufStats", every acceleration hook is charged for the
+ * pushbuf dwords it emits, and the kicks, validates and relocations it
+ * causes.  The totals are logged when the screen is closed, which makes
+ * it possible to compare the CPU-side cost of submission paths between
+ * changes without any GPU-side measurement.
+ *
+ * Only the main channel is tracked, each screen has its own counters
+ * hanging off its pushbuf.  Kicks are counted from the pushbuf's
+ * kick_notify, so the ones libdrm does by itself are included.
+ *
+ * The dwords are also decoded back into method writes, counting how often
+ * each method is written, and how often it's written with the value it
+ * already had, which points at redundant state emission.  Image data,
+ * constant uploads and immediate vertices aren't state, repeats there are
+ * expected; those writes are counted as payload instead.  That's anything
+ * sent with a non-incrementing packet, plus the data arrays below.
+ *
+ * This only decodes, nothing is executed here.  test/emu.c has a CPU model
+ * of the engines EXA uses, for checking what the stream does rather than
+ * what it costs.
+ */
+
+#define NOUVEAU_STATS_MTHDS (8 << 13) /* subchannel, method / 4 */
+#define NOUVEAU_STATS_TOP 24
+
+struct nouveau_stats_mthd {
+	uint64_t writes;
+	uint64_t redundant;
+	uint64_t payload;
+	uint32_t last;
+	Bool valid;
+};
+
+/* method ranges written with incrementing packets that carry data */
+struct nouveau_stats_data {
+	int subc;
+	uint32_t start;
+	uint32_t end;
+};
+
+static const struct nouveau_stats_data
+nouveau_stats_data_nv04[] = {
+	{ 5, NV01_IFC_COLOR(0), NV01_IFC_COLOR(NV04_IFC_COLOR__LEN) },
+	{ 7, NV10_3D_VERTEX_POS_3F, NV10_3D_VERTEX_WGH_1F + 4 },
+	{ 7, NV30_3D_VTX_ATTR_3I_XY(0), NV30_3D_VTX_ATTR_3I_XY(16) },
+	{ 7, NV30_3D_VTX_ATTR_3F(0), NV30_3D_VTX_ATTR_3F(16) },
+	{ 7, NV30_3D_VTX_ATTR_2F(0), NV30_3D_VTX_ATTR_4I(16) },
+	{ 7, NV30_3D_VTX_ATTR_4F(0), NV30_3D_VTX_ATTR_4F(16) },
+	{ 7, NV30_3D_VTX_ATTR_1F(0), NV30_3D_VTX_ATTR_1F(16) },
+	{}
+};
+
+static const struct nouveau_stats_data
+nouveau_stats_data_nv50[] = {
+	{ 7, NV50_3D_VTX_ATTR_1F(0), NV50_3D_VTX_ATTR_4NB(16) },
+	{}
+};
+
+static const struct nouveau_stats_data
+nouveau_stats_data_nvc0[] = {
+	{ 0, NVC0_3D_CB_DATA(0), NVC0_3D_CB_DATA(16) },
+	{}
+};
+
+struct nouveau_stats_decoder {
+	Bool nvc0;
+	const struct nouveau_stats_data *data;
+	/* packet currently being decoded */
+	int subc;
+	uint32_t mthd;
+	uint32_t left;
+	enum { DEC_INCR, DEC_NONINCR, DEC_ONEINCR } mode;
+	struct nouveau_stats_mthd mthds[NOUVEAU_STATS_MTHDS];
+};
+
+static Bool
+nouveau_stats_payload(struct nouveau_stats_decoder *dec, int subc,
+		      uint32_t mthd)
+{
+	const struct nouveau_stats_data *d;
+
+	if (dec->mode == DEC_NONINCR)
+		return TRUE;
+
+	for (d = dec->data; d->end; d++) {
+		if (d->subc == subc && mthd >= d->start && mthd < d->end)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+static void
+nouveau_stats_write(struct nouveau_stats_decoder *dec, int subc,
+		    uint32_t mthd, uint32_t data)
+{
+	struct nouveau_stats_mthd *m = &dec->mthds[(subc << 13) | (mthd >> 2)];
+
+	m->writes++;
+	if (nouveau_stats_payload(dec, subc, mthd)) {
+		m->payload++;
+		return;
+	}
+
+	if (m->valid && m->last == data)
+		m->redundant++;
+	m->last = data;
+	m->valid = TRUE;
+}
+
+static void
+nouveau_stats_header(struct nouveau_stats_decoder *dec, uint32_t hdr)
+{
+	if (dec->nvc0) {
+		dec->subc = (hdr >> 13) & 7;
+		dec->mthd = (hdr & 0x1fff) << 2;
+		dec->left = (hdr >> 16) & 0x1fff;
+
+		switch (hdr >> 29) {
+		case 1: dec->mode = DEC_INCR; break;
+		case 3: dec->mode = DEC_NONINCR; break;
+		case 5: dec->mode = DEC_ONEINCR; break;
+		case 4:
+			dec->mode = DEC_INCR;
+			nouveau_stats_write(dec, dec->subc, dec->mthd,
+					    dec->left);
+			dec->left = 0;
+			break;
+		default:
+			dec->left = 0;
+			break;
+		}
+	} else {
+		dec->subc = (hdr >> 13) & 7;
+		dec->mthd = hdr & 0x1ffc;
+		dec->left = (hdr >> 18) & 0x7ff;
+
+		/* anything else is a jump/call/return */
+		switch (hdr & 0xe0000003) {
+		case 0x00000000: dec->mode = DEC_INCR; break;
+		case 0x40000000: dec->mode = DEC_NONINCR; break;
+		default:
+			dec->left = 0;
+			break;
+		}
+	}
+}
+
+void
+nouveau_stats_decode(struct nouveau_stats *stats, const uint32_t *p,
+		     const uint32_t *end)
+{
+	struct nouveau_stats_decoder *dec = stats->dec;
+
+	if (!dec)
+		return;
+
+	/* lost track of the stream, resync on the next header */
+	if (!p) {
+		dec->left = 0;
+		return;
+	}
+
+	while (p < end) {
+		uint32_t data = *p++;
+
+		if (!dec->left) {
+			nouveau_stats_header(dec, data);
+			continue;
+		}
+
+		nouveau_stats_write(dec, dec->subc, dec->mthd, data);
+		dec->left--;
+		if (dec->mode == DEC_INCR)
+			dec->mthd += 4;
+		else
+		if (dec->mode == DEC_ONEINCR) {
+			dec->mthd += 4;
+			dec->mode = DEC_NONINCR;
+		}
+	}
+}
+
+/* qsort() has no context argument */
+static const struct nouveau_stats_mthd *nouveau_stats_sorting;
+
+static int
+nouveau_stats_mthd_cmp(const void *a, const void *b)
+{
+	const struct nouveau_stats_mthd *m = nouveau_stats_sorting;
+	uint64_t wa = m[*(const int *)a].writes;
+	uint64_t wb = m[*(const int *)b].writes;
+
+	return (wa < wb) - (wa > wb);
+}
+
+static void
+nouveau_stats_report_mthds(ScrnInfoPtr pScrn, struct nouveau_stats *stats)
+{
+	struct nouveau_stats_decoder *dec = stats->dec;
+	int *idx, i;
+
+	idx = malloc(NOUVEAU_STATS_MTHDS * sizeof(*idx));
+	if (!idx)
+		return;
+
+	/* busiest methods first */
+	for (i = 0; i < NOUVEAU_STATS_MTHDS; i++)
+		idx[i] = i;
+	nouveau_stats_sorting = dec->mthds;
+	qsort(idx, NOUVEAU_STATS_MTHDS, sizeof(*idx), nouveau_stats_mthd_cmp);
+
+	xf86DrvMsg(pScrn->scrnIndex, X_INFO, "%-4s %-6s %12s %12s %12s\n",
+		   "subc", "mthd", "writes", "redundant", "payload");
+	for (i = 0; i < NOUVEAU_STATS_TOP; i++) {
+		struct nouveau_stats_mthd *m = &dec->mthds[idx[i]];
+
+		if (!m->writes)
+			break;
+
+		xf86DrvMsg(pScrn->scrnIndex, X_INFO,
+			   "%-4d 0x%04x %12llu %12llu %12llu\n", idx[i] >> 13,
+			   (idx[i] & 0x1fff) << 2,
+			   (unsigned long long)m->writes,
+			   (unsigned long long)m->redundant,
+			   (unsigned long long)m->payload);
+	}
+
+	free(idx);
+}
+
+static const char *
+nouveau_stats_op_name[NOUVEAU_STATS_OPS] = {
+	[NOUVEAU_STATS_OTHER]     = "other",
+	[NOUVEAU_STATS_SOLID]     = "solid",
+	[NOUVEAU_STATS_COPY]      = "copy",
+	[NOUVEAU_STATS_COMPOSITE] = "composite",
+	[NOUVEAU_STATS_UPLOAD]    = "upload",
+	[NOUVEAU_STATS_DOWNLOAD]  = "download",
+	[NOUVEAU_STATS_XV]        = "xv",
+};
+
+void
+nouveau_stats_init(ScrnInfoPtr pScrn)
+{
+	NVPtr pNv = NVPTR(pScrn);
+	struct nouveau_stats *stats;
+
+	if (!pNv->push_stats || pNv->push_priv.stats)
+		return;
+
+	stats = calloc(1, sizeof(*stats));
+	if (!stats)
+		return;
+
+	stats->mark = pNv->pushbuf->cur;
+
+	/* not fatal, the method breakdown just won't be available */
+	stats->dec = calloc(1, sizeof(*stats->dec));
+	if (stats->dec) {
+		stats->dec->nvc0 = pNv->Architecture >= NV_FERMI;
+		if (pNv->Architecture >= NV_FERMI)
+			stats->dec->data = nouveau_stats_data_nvc0;
+		else
+		if (pNv->Architecture == NV_TESLA)
+			stats->dec->data = nouveau_stats_data_nv50;
+		else
+			stats->dec->data = nouveau_stats_data_nv04;
+	}
+	pNv->push_priv.stats = stats;
+	xf86DrvMsg(pScrn->scrnIndex, X_CONFIG,
+		   "Collecting pushbuf statistics\n");
+}
+
+void
+nouveau_stats_fini(ScrnInfoPtr pScrn)
+{
+	NVPtr pNv = NVPTR(pScrn);
+	struct nouveau_stats *stats = pNv->push_priv.stats;
+	int op;
+
+	if (!stats)
+		return;
+
+	nouveau_stats_sync(pNv->pushbuf);
+
+	xf86DrvMsg(pScrn->scrnIndex, X_INFO,
+		   "%-10s %10s %12s %8s %10s %10s %10s\n", "op", "calls",
+		   "dwords", "dw/call", "kicks", "validates", "relocs");
+	for (op = 0; op < NOUVEAU_STATS_OPS; op++) {
+		uint64_t *c = stats->count[op];
+
+		xf86DrvMsg(pScrn->scrnIndex, X_INFO,
+			   "%-10s %10llu %12llu %8llu %10llu %10llu %10llu\n",
+			   nouveau_stats_op_name[op],
+			   (unsigned long long)c[NOUVEAU_STATS_CALLS],
+			   (unsigned long long)c[NOUVEAU_STATS_DWORDS],
+			   (unsigned long long)(c[NOUVEAU_STATS_CALLS] ?
+				c[NOUVEAU_STATS_DWORDS] /
+				c[NOUVEAU_STATS_CALLS] : 0),
+			   (unsigned long long)c[NOUVEAU_STATS_KICKS],
+			   (unsigned long long)c[NOUVEAU_STATS_VALIDATES],
+			   (unsigned long long)c[NOUVEAU_STATS_RELOCS]);
+	}
+
+	if (stats->dec)
+		nouveau_stats_report_mthds(pScrn, stats);
+
+	pNv->push_priv.stats = NULL;
+	free(stats->dec);
+	free(stats);
+}
+
+/* Fallback counters
+ *
+ * These are always on.  Each NOUVEAU_FALLBACK() site links itself into
+ * a list on its first hit and counts from then on.  Composite fallbacks
+ * are also broken down by op and picture formats, so we can tell which
+ * acceleration gaps are worth closing.
+ *
+ * The counters are published as text in the _NOUVEAU_FALLBACKS property
+ * on the root window ("xprop -root _NOUVEAU_FALLBACKS"), refreshed at
+ * most once a second and only when they've changed, and logged when the
+ * screen is closed.
+ */
+
+#define NOUVEAU_FALLBACK_COMPOSITES 256
+#define NOUVEAU_FALLBACK_PROBE 8
+#define NOUVEAU_FALLBACK_TEXT (32 * 1024)
+
+struct nouveau_fallback_composite {
+	struct nouveau_fallback_site *site;
+	int op;
+	uint32_t src, mask, dst;
+	uint64_t count;
+};
+
+struct nouveau_fallback_site *nouveau_fallback_sites = NULL;
+struct nouveau_fallback_site *nouveau_fallback_last = NULL;
+uint64_t nouveau_fallback_total = 0;
+
+static struct nouveau_fallback_composite
+nouveau_fallback_composites[NOUVEAU_FALLBACK_COMPOSITES];
+static uint64_t nouveau_fallback_composites_lost = 0;
+
+void
+nouveau_fallback_composite(struct nouveau_fallback_site *site, int op,
+			   PicturePtr src, PicturePtr mask, PicturePtr dst)
+{
+	uint32_t sf = src ? src->format : 0;
+	uint32_t mf = mask ? mask->format : 0;
+	uint32_t df = dst ? dst->format : 0;
+	uint32_t hash;
+	int i;
+
+	/* solid/gradient sources have no format worth telling apart */
+	if (src && !src->pDrawable)
+		sf = 0;
+	if (mask && !mask->pDrawable)
+		mf = 0;
+
+	hash = (uintptr_t)site ^ (op * 0x9e3779b1) ^ (sf * 31) ^ (mf * 17) ^ df;
+
+	for (i = 0; i < NOUVEAU_FALLBACK_PROBE; i++) {
+		struct nouveau_fallback_composite *c =
+			&nouveau_fallback_composites[(hash + i) %
+						     NOUVEAU_FALLBACK_COMPOSITES];
+
+		if (!c->count) {
+			c->site = site;
+			c->op = op;
+			c->src = sf;
+			c->mask = mf;
+			c->dst = df;
+		} else
+		if (c->site != site || c->op != op || c->src != sf ||
+		    c->mask != mf || c->dst != df)
+			continue;
+
+		c->count++;
+		return;
+	}
+
+	nouveau_fallback_composites_lost++;
+}
+
+/* reasons are printf formats, print them without arguments or newline */
+static int
+nouveau_fallback_reason(char *buf, int size, const char *reason)
+{
+	int len = strcspn(reason, "\n");
+
+	return snprintf(buf, size, "%.*s", len, reason);
+}
+
+static int
+nouveau_fallback_text(char *buf, int size)
+{
+	struct nouveau_fallback_site *site;
+	int len = 0, i;
+
+#define APPEND(fmt, args...) do {                                         \
+	if (len < size)                                                   \
+		len += snprintf(buf + len, size - len, fmt, ##args);      \
+} while(0)
+
+	APPEND("%llu fallbacks\n", (unsigned long long)nouveau_fallback_total);
+
+	for (site = nouveau_fallback_sites; site; site = site->next) {
+		APPEND("%10llu %s:%d ", (unsigned long long)site->count,
+		       site->func, site->line);
+		if (len < size)
+			len += nouveau_fallback_reason(buf + len, size - len,
+						       site->reason);
+		APPEND("\n");
+	}
+
+	for (i = 0; i < NOUVEAU_FALLBACK_COMPOSITES; i++) {
+		struct nouveau_fallback_composite *c =
+			&nouveau_fallback_composites[i];
+
+		if (!c->count)
+			continue;
+
+		APPEND("%10llu composite op %d src 0x%08x mask 0x%08x "
+		       "dst 0x%08x at %s:%d\n", (unsigned long long)c->count,
+		       c->op, c->src, c->mask, c->dst,
+		       c->site ? c->site->func : "?",
+		       c->site ? c->site->line : 0);
+	}
+
+	if (nouveau_fallback_composites_lost)
+		APPEND("%10llu composite (untracked)\n",
+		       (unsigned long long)nouveau_fallback_composites_lost);
+#undef APPEND
+
+	return len < size ? len : size - 1;
+}
+
+void
+nouveau_fallback_publish(ScreenPtr pScreen)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pScreen));
+	CARD32 now = GetTimeInMillis();
+	Atom atom;
+	char *buf;
+	int len;
+
+	if (pNv->fallback_published == nouveau_fallback_total ||
+	    now - pNv->fallback_time < 1000 || !pScreen->root)
+		return;
+
+	buf = malloc(NOUVEAU_FALLBACK_TEXT);
+	if (!buf)
+		return;
+
+	len = nouveau_fallback_text(buf, NOUVEAU_FALLBACK_TEXT);
+	atom = MakeAtom("_NOUVEAU_FALLBACKS", strlen("_NOUVEAU_FALLBACKS"),
+			TRUE);
+	dixChangeWindowProperty(serverClient, pScreen->root, atom, XA_STRING,
+				8, PropModeReplace, len, buf, FALSE);
+	free(buf);
+
+	pNv->fallback_published = nouveau_fallback_total;
+	pNv->fallback_time = now;
+}
+
+void
+nouveau_fallback_report(ScrnInfoPtr pScrn)
+{
+	char *buf, *line, *next;
+
+	if (!nouveau_fallback_total)
+		return;
+
+	buf = malloc(NOUVEAU_FALLBACK_TEXT);
+	if (!buf)
+		return;
+
+	nouveau_fallback_text(buf, NOUVEAU_FALLBACK_TEXT);
+	for (line = buf; *line; line = next) {
+		next = strchr(line, '\n');
+		if (!next)
+			break;
+		*next++ = '\0';
+		xf86DrvMsg(pScrn->scrnIndex, X_INFO, "%s\n", line);
+	}
+	free(buf);
+}
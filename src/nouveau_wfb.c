@@ -125,6 +125,7 @@ void
 nouveau_wfb_setup_wrap(ReadMemoryProcPtr *pRead, WriteMemoryProcPtr *pWrite,
 		       DrawablePtr pDraw)
 {
+	struct nouveau_pixmap *priv = NULL;
 	struct nouveau_bo *bo = NULL;
 	struct wfb_pixmap *wfb;
 	PixmapPtr ppix = NULL;
@@ -135,7 +136,7 @@ nouveau_wfb_setup_wrap(ReadMemoryProcPtr *pRead, WriteMemoryProcPtr *pWrite,
 
 	ppix = NVGetDrawablePixmap(pDraw);
 	if (ppix) {
-		struct nouveau_pixmap *priv = nouveau_pixmap(ppix);
+		priv = nouveau_pixmap(ppix);
 		bo = priv ? priv->bo : NULL;
 	}
 
@@ -172,12 +173,15 @@ nouveau_wfb_setup_wrap(ReadMemoryProcPtr *pRead, WriteMemoryProcPtr *pWrite,
 
 	wfb->ppix = ppix;
 	wfb->base = (unsigned long)ppix->devPrivate.ptr;
-	wfb->end = wfb->base + bo->size;
+	wfb->end = wfb->base;
+	wfb->end += priv->slab ? priv->slab->slot_size : bo->size;
 	if (!nv50_style_tiled_pixmap(ppix)) {
 		wfb->pitch = 0;
 	} else {
 		wfb->pitch = ppix->devKind;
-		/* 8192x8192x4 is 28 bits max, 64 - 28 == 36. */
+		/* 16384x16384x4 is 30 bits max, offset * factor stays
+		 * below height << 36.
+		 */
 		wfb->multiply_factor = (((1ULL << 36) - 1) / wfb->pitch) + 1;
 		if (bo->device->chipset < 0xc0)
 			wfb->tile_height = (bo->config.nv50.tile_mode >> 4) + 2;
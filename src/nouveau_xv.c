@@ -1342,6 +1342,7 @@ CPU_copy:
 #endif
 	}
 
+	nouveau_stats_begin(pNv->pushbuf, NOUVEAU_STATS_XV);
 	if (action_flags & USE_OVERLAY) {
 		if (pNv->Architecture == NV_ARCH_04) {
 			NV04PutOverlayImage(pScrn, pPriv->video_mem, offset,
@@ -1358,6 +1359,7 @@ CPU_copy:
 		}
 
 		pPriv->currentBuffer ^= 1;
+		nouveau_stats_end(pNv->pushbuf);
 	} else 
 	if (action_flags & USE_TEXTURE) {
 		int ret = BadImplementation;
@@ -1394,6 +1396,7 @@ CPU_copy:
 						clipBoxes, ppix, pPriv);
 		}
 
+		nouveau_stats_end(pNv->pushbuf);
 		if (ret != Success)
 			return ret;
 	} else {
@@ -1401,10 +1404,14 @@ CPU_copy:
 				     dstPitch, &dstBox, 0, 0, xb, yb, npixels,
 				     nlines, src_w, src_h, drw_w, drw_h,
 				     clipBoxes, ppix);
+		nouveau_stats_end(pNv->pushbuf);
 		if (ret != Success)
 			return ret;
 	}
 
+	if (!(action_flags & USE_OVERLAY))
+		nouveau_pixmap_fence(ppix, NOUVEAU_BO_WR);
+
 #ifdef COMPOSITE
 	/* Damage tracking */
 	if (!(action_flags & USE_OVERLAY))
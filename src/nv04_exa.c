@@ -129,7 +129,7 @@ NV04EXAPrepareSolid(PixmapPtr ppix, int alu, Pixel planemask, Pixel fg)
 	PUSH_DATA (push, rect_fmt);
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		return FALSE;
 	}
@@ -155,8 +155,7 @@ NV04EXASolid (PixmapPtr pPixmap, int x, int y, int x2, int y2)
 	BEGIN_NV04(push, NV04_RECT(UNCLIPPED_RECTANGLE_POINT(0)), 2);
 	PUSH_DATA (push, (x << 16) | y);
 	PUSH_DATA (push, (w << 16) | h);
-	if ((w * h) >= 512)
-		PUSH_KICK(push);
+	NVAccelQueue(pNv, w * h);
 }
 
 void
@@ -200,7 +199,7 @@ NV04EXAPrepareCopy(PixmapPtr pspix, PixmapPtr pdpix, int dx, int dy,
 			 NOUVEAU_BO_VRAM | NOUVEAU_BO_WR);
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		return FALSE;
 	}
@@ -265,8 +264,7 @@ NV04EXACopy(PixmapPtr pdpix, int srcX, int srcY, int dstX, int dstY,
 		pNv->pmpix = NULL;
 	}
 
-	if ((width * height) >= 512)
-		PUSH_KICK(push);
+	NVAccelQueue(pNv, width * height);
 }
 
 void
@@ -339,7 +337,7 @@ NV04EXAUploadIFC(ScrnInfoPtr pScrn, const char *src, int src_pitch,
 			 NOUVEAU_BO_VRAM | NOUVEAU_BO_WR);
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push))
+	if (PUSH_VAL(push))
 		goto out;
 
 	py = y;
@@ -377,8 +375,11 @@ NV04EXAUploadIFC(ScrnInfoPtr pScrn, const char *src, int src_pitch,
 	ret = TRUE;
 out:
 	nouveau_pushbuf_bufctx(push, NULL);
+	/* writes to the front buffer should show up right away */
 	if (pdpix == pScreen->GetScreenPixmap(pScreen))
-		PUSH_KICK(push);
+		NVAccelKick(pNv);
+	else
+		NVAccelQueue(pNv, w * h);
 	return ret;
 }
 
@@ -121,7 +121,7 @@ NVPutBlitImage(ScrnInfoPtr pScrn, struct nouveau_bo *src, int src_offset,
 	}
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		return BadAlloc;
 	}
@@ -579,7 +579,7 @@ NV10EXAPrepareComposite(int op,
 	}
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		return FALSE;
 	}
@@ -532,7 +532,7 @@ NV30EXAPrepareComposite(int op, PicturePtr psPict,
 	PUSH_DATA (push, 3);
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		return FALSE;
 	}
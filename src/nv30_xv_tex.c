@@ -275,7 +275,7 @@ NV30PutTextureImage(ScrnInfoPtr pScrn, struct nouveau_bo *src, int src_offset,
 	PUSH_DATA (push, 0x00000000);
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		return BadAlloc;
 	}
@@ -514,7 +514,7 @@ NV40EXAPrepareComposite(int op, PicturePtr psPict,
 	PUSH_DATA (push, 1);
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		return FALSE;
 	}
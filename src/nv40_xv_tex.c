@@ -277,7 +277,7 @@ NV40PutTextureImage(ScrnInfoPtr pScrn,
 	}
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		return BadAlloc;
 	}
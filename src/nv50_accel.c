@@ -119,7 +119,6 @@ NVAccelInit2D_NV50(ScrnInfoPtr pScrn)
 	BEGIN_NV04(push, NV50_2D(UNK58C), 1);
 	PUSH_DATA (push, 0x111);
 
-	pNv->currentRop = 0xfffffffa;
 	return TRUE;
 }
 
@@ -418,6 +417,48 @@ NVAccelInitNV50TCL(ScrnInfoPtr pScrn)
 	PUSH_DATA (push, 0xe0880205);
 	PUSH_DATA (push, 0x00010781); /* exit add f32 $r1 (mul $r1 c0[0x20]) $r4 */
 
+	PUSH_DATAu(push, pNv->scratch, PFP_OFFSET + PFP_RS, 14);
+	PUSH_DATA (push, 0x80000000); /* interp $r0 v[0x0] */
+	PUSH_DATA (push, 0x90000004); /* rcp f32 $r1 $r0 */
+	PUSH_DATA (push, 0x82010200); /* interp $r0 v[0x4] $r1 */
+	PUSH_DATA (push, 0x82020204); /* interp $r1 v[0x8] $r1 */
+	PUSH_DATA (push, 0xc0000008); /* mul f32 $r2 $r0 $r0 */
+	PUSH_DATA (push, 0xe0010208); /* add f32 $r2 (mul $r1 $r1) $r2 */
+	PUSH_DATA (push, 0x90000409);
+	PUSH_DATA (push, 0x40000780); /* rsqrt f32 $r2 $r2 */
+	PUSH_DATA (push, 0x90000409);
+	PUSH_DATA (push, 0x00000780); /* rcp f32 $r2 $r2 */
+	PUSH_DATA (push, 0xe08e0008); /* add f32 $r2 (mul $r0 c0[0x38]) $r2 */
+	PUSH_DATA (push, 0xb08f0400); /* add f32 $r0 $r2 c0[0x3c] */
+	PUSH_DATA (push, 0xf6400001);
+	PUSH_DATA (push, 0x0000c785); /* exit texauto live $r0:$r1:$r2:$r3 $t0 $s0 $r0:$r1 0x0 0x0 0x0 */
+	PUSH_DATAu(push, pNv->scratch, PFP_OFFSET + PFP_RC, 24);
+	PUSH_DATA (push, 0x80000000); /* interp $r0 v[0x0] */
+	PUSH_DATA (push, 0x90000004); /* rcp f32 $r1 $r0 */
+	PUSH_DATA (push, 0x82030210); /* interp $r4 v[0xc] $r1 */
+	PUSH_DATA (push, 0x82040214); /* interp $r5 v[0x10] $r1 */
+	PUSH_DATA (push, 0x82010200); /* interp $r0 v[0x4] $r1 */
+	PUSH_DATA (push, 0x82020204); /* interp $r1 v[0x8] $r1 */
+	PUSH_DATA (push, 0xc0000008); /* mul f32 $r2 $r0 $r0 */
+	PUSH_DATA (push, 0xe0010208); /* add f32 $r2 (mul $r1 $r1) $r2 */
+	PUSH_DATA (push, 0x90000409);
+	PUSH_DATA (push, 0x40000780); /* rsqrt f32 $r2 $r2 */
+	PUSH_DATA (push, 0x90000409);
+	PUSH_DATA (push, 0x00000780); /* rcp f32 $r2 $r2 */
+	PUSH_DATA (push, 0xe08e0008); /* add f32 $r2 (mul $r0 c0[0x38]) $r2 */
+	PUSH_DATA (push, 0xb08f0400); /* add f32 $r0 $r2 c0[0x3c] */
+	PUSH_DATA (push, 0xf6400001);
+	PUSH_DATA (push, 0x0000c784); /* texauto live $r0:$r1:$r2:$r3 $t0 $s0 $r0:$r1 0x0 0x0 0x0 */
+	PUSH_DATA (push, 0xf0400211);
+	PUSH_DATA (push, 0x00008784); /* texauto live #:#:#:$r4 $t1 $s0 $r4:$r5 0x0 0x0 0x0 */
+	PUSH_DATA (push, 0xc0040000); /* mul f32 $r0 $r0 $r4 */
+	PUSH_DATA (push, 0xc0040204); /* mul f32 $r1 $r1 $r4 */
+	PUSH_DATA (push, 0xc0040409);
+	PUSH_DATA (push, 0x00000780); /* mul rn f32 $r2 $r2 $r4 */
+	PUSH_DATA (push, 0xc004060d);
+	PUSH_DATA (push, 0x00000781); /* exit mul rn f32 $r3 $r3 $r4 */
+	memset(pNv->gradient_slot, 0, sizeof(pNv->gradient_slot));
+
 	/* HPOS.xy = ($o0, $o1), HPOS.zw = (0.0, 1.0), then map $o2 - $o5 */
 	BEGIN_NV04(push, NV50_3D(VP_RESULT_MAP(0)), 2);
 	PUSH_DATA (push, 0x41400100);
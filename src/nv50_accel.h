@@ -32,6 +32,7 @@
 #define PVP_DATA    0x00004000 /* VP constbuf */
 #define PFP_DATA    0x00004100 /* FP constbuf */
 #define SOLID(i)   (0x00006000 + (i) * 0x100)
+#define GRADIENT(i) (0x00007000 + (i) * 0x400) /* NOUVEAU_GRADIENT_SLOTS */
 
 /* Fragment programs */
 #define PFP_S     0x0000 /* (src) */
@@ -41,6 +42,13 @@
 #define PFP_S_A8  0x0400 /* (src) a8 rt */
 #define PFP_C_A8  0x0500 /* (src IN mask) a8 rt - same for CA and CA_SA */
 #define PFP_NV12  0x0600 /* NV12 YUV->RGB */
+#define PFP_RS    0x0700 /* (radial gradient src) */
+#define PFP_RC    0x0800 /* (radial gradient src IN mask) */
+
+/* FP constant offset of the PFP_R* programs' alpha and beta, after the Xv
+ * csc coefficients, see nouveau_exa_gradient_radial()
+ */
+#define PFP_RADIAL 0x38
 
 /* Constant buffer assignments */
 #define CB_PSH 0
@@ -68,6 +76,19 @@ PUSH_VTX2s(struct nouveau_pushbuf *push,
 	PUSH_DATA (push, ((dy & 0xffff) << 16) | (dx & 0xffff));
 }
 
+static __inline__ void
+PUSH_VTX2f(struct nouveau_pushbuf *push,
+	   float x1, float y1, float x2, float y2, int dx, int dy)
+{
+	BEGIN_NV04(push, NV50_3D(VTX_ATTR_2F_X(8)), 4);
+	PUSH_DATAf(push, x1);
+	PUSH_DATAf(push, y1);
+	PUSH_DATAf(push, x2);
+	PUSH_DATAf(push, y2);
+	BEGIN_NV04(push, NV50_3D(VTX_ATTR_2I(0)), 1);
+	PUSH_DATA (push, ((dy & 0xffff) << 16) | (dx & 0xffff));
+}
+
 static __inline__ void
 PUSH_DATAu(struct nouveau_pushbuf *push, struct nouveau_bo *bo,
 	   unsigned delta, unsigned dwords)
@@ -81,12 +81,12 @@ NV50EXA2DSurfaceFormat(PixmapPtr ppix, uint32_t *fmt)
 static void NV50EXASetClip(PixmapPtr ppix, int x, int y, int w, int h)
 {
 	NV50EXA_LOCALS(ppix);
+	uint32_t clip[4] = { x, y, w, h };
 
-	BEGIN_NV04(push, NV50_2D(CLIP_X), 4);
-	PUSH_DATA (push, x);
-	PUSH_DATA (push, y);
-	PUSH_DATA (push, w);
-	PUSH_DATA (push, h);
+	if (NVAccelState(pNv, NV50_2D(CLIP_X), 4, clip)) {
+		BEGIN_NV04(push, NV50_2D(CLIP_X), 4);
+		PUSH_DATAp(push, clip, 4);
+	}
 }
 
 static void
@@ -96,31 +96,39 @@ NV50EXAAcquireSurface2D(PixmapPtr ppix, int is_src, uint32_t fmt)
 	struct nouveau_bo *bo = nouveau_pixmap_bo(ppix);
 	struct nouveau_pixmap *nvpix = nouveau_pixmap(ppix);
 	int mthd = is_src ? NV50_2D_SRC_FORMAT : NV50_2D_DST_FORMAT;
+	uint64_t offset = bo->offset + nvpix->offset;
+	uint32_t size[4] = { ppix->drawable.width, ppix->drawable.height,
+			     offset >> 32, offset };
 	uint32_t bo_flags;
 
 	bo_flags = nvpix->shared ? NOUVEAU_BO_GART : NOUVEAU_BO_VRAM;
 	bo_flags |= is_src ? NOUVEAU_BO_RD : NOUVEAU_BO_WR;
 
 	if (!nv50_style_tiled_pixmap(ppix)) {
-		BEGIN_NV04(push, SUBC_2D(mthd), 2);
-		PUSH_DATA (push, fmt);
-		PUSH_DATA (push, 1);
-		BEGIN_NV04(push, SUBC_2D(mthd + 0x14), 1);
-		PUSH_DATA (push, (uint32_t)exaGetPixmapPitch(ppix));
+		uint32_t linear[2] = { fmt, 1 };
+		uint32_t pitch = exaGetPixmapPitch(ppix);
+
+		if (NVAccelState(pNv, SUBC_2D(mthd), 2, linear)) {
+			BEGIN_NV04(push, SUBC_2D(mthd), 2);
+			PUSH_DATAp(push, linear, 2);
+		}
+		if (NVAccelState(pNv, SUBC_2D(mthd + 0x14), 1, &pitch)) {
+			BEGIN_NV04(push, SUBC_2D(mthd + 0x14), 1);
+			PUSH_DATA (push, pitch);
+		}
 	} else {
-		BEGIN_NV04(push, SUBC_2D(mthd), 5);
-		PUSH_DATA (push, fmt);
-		PUSH_DATA (push, 0);
-		PUSH_DATA (push, bo->config.nv50.tile_mode);
-		PUSH_DATA (push, 1);
-		PUSH_DATA (push, 0);
+		uint32_t tiled[5] = { fmt, 0, bo->config.nv50.tile_mode, 1, 0 };
+
+		if (NVAccelState(pNv, SUBC_2D(mthd), 5, tiled)) {
+			BEGIN_NV04(push, SUBC_2D(mthd), 5);
+			PUSH_DATAp(push, tiled, 5);
+		}
 	}
 
-	BEGIN_NV04(push, SUBC_2D(mthd + 0x18), 4);
-	PUSH_DATA (push, ppix->drawable.width);
-	PUSH_DATA (push, ppix->drawable.height);
-	PUSH_DATA (push, bo->offset >> 32);
-	PUSH_DATA (push, bo->offset);
+	if (NVAccelState(pNv, SUBC_2D(mthd + 0x18), 4, size)) {
+		BEGIN_NV04(push, SUBC_2D(mthd + 0x18), 4);
+		PUSH_DATAp(push, size, 4);
+	}
 
 	if (is_src == 0)
 		NV50EXASetClip(ppix, 0, 0, ppix->drawable.width, ppix->drawable.height);
@@ -132,63 +140,66 @@ static void
 NV50EXASetPattern(PixmapPtr pdpix, int col0, int col1, int pat0, int pat1)
 {
 	NV50EXA_LOCALS(pdpix);
+	uint32_t pattern[4] = { col0, col1, pat0, pat1 };
 
-	BEGIN_NV04(push, NV50_2D(PATTERN_COLOR(0)), 4);
-	PUSH_DATA (push, col0);
-	PUSH_DATA (push, col1);
-	PUSH_DATA (push, pat0);
-	PUSH_DATA (push, pat1);
+	if (NVAccelState(pNv, NV50_2D(PATTERN_COLOR(0)), 4, pattern)) {
+		BEGIN_NV04(push, NV50_2D(PATTERN_COLOR(0)), 4);
+		PUSH_DATAp(push, pattern, 4);
+	}
+}
+
+static void
+NV50EXASetOperation(PixmapPtr pdpix, uint32_t operation)
+{
+	NV50EXA_LOCALS(pdpix);
+
+	if (NVAccelState(pNv, NV50_2D(OPERATION), 1, &operation)) {
+		BEGIN_NV04(push, NV50_2D(OPERATION), 1);
+		PUSH_DATA (push, operation);
+	}
 }
 
 static void
 NV50EXASetROP(PixmapPtr pdpix, int alu, Pixel planemask)
 {
 	NV50EXA_LOCALS(pdpix);
-	int rop;
+	uint32_t format[2] = { 2, 1 };
+	uint32_t rop;
 
 	if (planemask != ~0)
 		rop = NVROP[alu].copy_planemask;
 	else
 		rop = NVROP[alu].copy;
 
-	BEGIN_NV04(push, NV50_2D(OPERATION), 1);
 	if (alu == GXcopy && EXA_PM_IS_SOLID(&pdpix->drawable, planemask)) {
-		PUSH_DATA (push, NV50_2D_OPERATION_SRCCOPY);
+		NV50EXASetOperation(pdpix, NV50_2D_OPERATION_SRCCOPY);
 		return;
-	} else {
-		PUSH_DATA (push, NV50_2D_OPERATION_ROP);
 	}
+	NV50EXASetOperation(pdpix, NV50_2D_OPERATION_ROP);
 
-	BEGIN_NV04(push, NV50_2D(PATTERN_COLOR_FORMAT), 2);
 	switch (pdpix->drawable.bitsPerPixel) {
-		case  8: PUSH_DATA (push, 3); break;
-		case 15: PUSH_DATA (push, 1); break;
-		case 16: PUSH_DATA (push, 0); break;
-		case 24:
-		case 32:
-		default:
-			 PUSH_DATA (push, 2);
-			 break;
+	case  8: format[0] = 3; break;
+	case 15: format[0] = 1; break;
+	case 16: format[0] = 0; break;
+	case 24:
+	case 32:
+	default:
+		 break;
+	}
+	if (NVAccelState(pNv, NV50_2D(PATTERN_COLOR_FORMAT), 2, format)) {
+		BEGIN_NV04(push, NV50_2D(PATTERN_COLOR_FORMAT), 2);
+		PUSH_DATAp(push, format, 2);
 	}
-	PUSH_DATA (push, 1);
-
-	/* There are 16 alu's.
-	 * 0-15: copy
-	 * 16-31: copy_planemask
-	 */
 
-	if (!EXA_PM_IS_SOLID(&pdpix->drawable, planemask)) {
-		alu += 16;
+	/* the pattern is only used to apply the planemask */
+	if (!EXA_PM_IS_SOLID(&pdpix->drawable, planemask))
 		NV50EXASetPattern(pdpix, 0, planemask, ~0, ~0);
-	} else {
-		if (pNv->currentRop > 15)
-			NV50EXASetPattern(pdpix, ~0, ~0, ~0, ~0);
-	}
+	else
+		NV50EXASetPattern(pdpix, ~0, ~0, ~0, ~0);
 
-	if (pNv->currentRop != alu) {
+	if (NVAccelState(pNv, NV50_2D(ROP), 1, &rop)) {
 		BEGIN_NV04(push, NV50_2D(ROP), 1);
 		PUSH_DATA (push, rop);
-		pNv->currentRop = alu;
 	}
 }
 
@@ -196,6 +207,7 @@ Bool
 NV50EXAPrepareSolid(PixmapPtr pdpix, int alu, Pixel planemask, Pixel fg)
 {
 	NV50EXA_LOCALS(pdpix);
+	uint32_t draw[3] = { NV50_2D_DRAW_SHAPE_RECTANGLES };
 	uint32_t fmt;
 
 	if (!NV50EXA2DSurfaceFormat(pdpix, &fmt))
@@ -208,13 +220,15 @@ NV50EXAPrepareSolid(PixmapPtr pdpix, int alu, Pixel planemask, Pixel fg)
 	NV50EXAAcquireSurface2D(pdpix, 0, fmt);
 	NV50EXASetROP(pdpix, alu, planemask);
 
-	BEGIN_NV04(push, NV50_2D(DRAW_SHAPE), 3);
-	PUSH_DATA (push, NV50_2D_DRAW_SHAPE_RECTANGLES);
-	PUSH_DATA (push, fmt);
-	PUSH_DATA (push, fg);
+	draw[1] = fmt;
+	draw[2] = fg;
+	if (NVAccelState(pNv, NV50_2D(DRAW_SHAPE), 3, draw)) {
+		BEGIN_NV04(push, NV50_2D(DRAW_SHAPE), 3);
+		PUSH_DATAp(push, draw, 3);
+	}
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		NOUVEAU_FALLBACK("validate\n");
 	}
@@ -223,21 +237,42 @@ NV50EXAPrepareSolid(PixmapPtr pdpix, int alu, Pixel planemask, Pixel fg)
 }
 
 void
-NV50EXASolid(PixmapPtr pdpix, int x1, int y1, int x2, int y2)
+NV50EXASolidBoxes(PixmapPtr pdpix, BoxPtr box, int nbox)
 {
 	NV50EXA_LOCALS(pdpix);
+	uint32_t pixels = 0;
 
-	if (!PUSH_SPACE(push, 8))
-		return;
+	/* each rect is a pair of points, and there's room for 32 of them
+	 * in a single method group
+	 */
+	while (nbox) {
+		int n = min(nbox, NV50_2D_DRAW_POINT32_X__LEN / 2);
+		int i;
+
+		if (!PUSH_SPACE(push, 1 + n * 4))
+			break;
+
+		BEGIN_NV04(push, NV50_2D(DRAW_POINT32_X(0)), n * 4);
+		for (i = 0; i < n; i++, box++) {
+			PUSH_DATA (push, box->x1);
+			PUSH_DATA (push, box->y1);
+			PUSH_DATA (push, box->x2);
+			PUSH_DATA (push, box->y2);
+			pixels += (box->x2 - box->x1) * (box->y2 - box->y1);
+		}
+
+		nbox -= n;
+	}
+
+	NVAccelQueue(pNv, pixels);
+}
 
-	BEGIN_NV04(push, NV50_2D(DRAW_POINT32_X(0)), 4);
-	PUSH_DATA (push, x1);
-	PUSH_DATA (push, y1);
-	PUSH_DATA (push, x2);
-	PUSH_DATA (push, y2);
+void
+NV50EXASolid(PixmapPtr pdpix, int x1, int y1, int x2, int y2)
+{
+	BoxRec box = { x1, y1, x2, y2 };
 
-	if ((x2 - x1) * (y2 - y1) >= 512)
-		PUSH_KICK(push);
+	NV50EXASolidBoxes(pdpix, &box, 1);
 }
 
 void
@@ -268,7 +303,7 @@ NV50EXAPrepareCopy(PixmapPtr pspix, PixmapPtr pdpix, int dx, int dy,
 	NV50EXASetROP(pdpix, alu, planemask);
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		NOUVEAU_FALLBACK("validate\n");
 	}
@@ -304,8 +339,7 @@ NV50EXACopy(PixmapPtr pdpix, int srcX , int srcY,
 	PUSH_DATA (push, 0);
 	PUSH_DATA (push, srcY);
 
-	if (width * height >= 512)
-		PUSH_KICK(push);
+	NVAccelQueue(pNv, width * height);
 }
 
 void
@@ -335,8 +369,7 @@ NV50EXAUploadSIFC(const char *src, int src_pitch,
 	NV50EXAAcquireSurface2D(pdpix, 0, sifc_fmt);
 	NV50EXASetClip(pdpix, x, y, w, h);
 
-	BEGIN_NV04(push, NV50_2D(OPERATION), 1);
-	PUSH_DATA (push, NV50_2D_OPERATION_SRCCOPY);
+	NV50EXASetOperation(pdpix, NV50_2D_OPERATION_SRCCOPY);
 	BEGIN_NV04(push, NV50_2D(SIFC_BITMAP_ENABLE), 2);
 	PUSH_DATA (push, 0);
 	PUSH_DATA (push, sifc_fmt);
@@ -353,7 +386,7 @@ NV50EXAUploadSIFC(const char *src, int src_pitch,
 	PUSH_DATA (push, y);
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push))
+	if (PUSH_VAL(push))
 		goto out;
 
 	while (h--) {
@@ -378,8 +411,11 @@ NV50EXAUploadSIFC(const char *src, int src_pitch,
 	ret = TRUE;
 out:
 	nouveau_pushbuf_bufctx(push, NULL);
+	/* writes to the front buffer should show up right away */
 	if (pdpix == pScreen->GetScreenPixmap(pScreen))
-		PUSH_KICK(push);
+		NVAccelKick(pNv);
+	else
+		NVAccelQueue(pNv, w * h);
 	return ret;
 }
 
@@ -417,6 +453,8 @@ NV50EXARenderTarget(PixmapPtr ppix, PicturePtr ppict)
 {
 	NV50EXA_LOCALS(ppix);
 	struct nouveau_bo *bo = nouveau_pixmap_bo(ppix);
+	uint64_t offset = bo->offset + nouveau_pixmap_offset(ppix);
+	uint32_t rt[8];
 	unsigned format;
 
 	/*XXX: Scanout buffer not tiled, someone needs to figure it out */
@@ -445,22 +483,47 @@ NV50EXARenderTarget(PixmapPtr ppix, PicturePtr ppict)
 		NOUVEAU_FALLBACK("invalid picture format\n");
 	}
 
+	rt[0] = offset >> 32;
+	rt[1] = offset;
+	rt[2] = format;
+	rt[3] = bo->config.nv50.tile_mode;
+	rt[4] = 0x00000000;
+	rt[5] = ppix->drawable.width;
+	rt[6] = ppix->drawable.height;
+	rt[7] = 0x00000001;
+
 	PUSH_REFN (push, bo, NOUVEAU_BO_VRAM | NOUVEAU_BO_WR);
-	BEGIN_NV04(push, NV50_3D(RT_ADDRESS_HIGH(0)), 5);
-	PUSH_DATA (push, bo->offset >> 32);
-	PUSH_DATA (push, bo->offset);
-	PUSH_DATA (push, format);
-	PUSH_DATA (push, bo->config.nv50.tile_mode);
-	PUSH_DATA (push, 0x00000000);
-	BEGIN_NV04(push, NV50_3D(RT_HORIZ(0)), 2);
-	PUSH_DATA (push, ppix->drawable.width);
-	PUSH_DATA (push, ppix->drawable.height);
-	BEGIN_NV04(push, NV50_3D(RT_ARRAY_MODE), 1);
-	PUSH_DATA (push, 0x00000001);
+	if (NVAccelState(pNv, NV50_3D(RT_ADDRESS_HIGH(0)), 5, &rt[0])) {
+		BEGIN_NV04(push, NV50_3D(RT_ADDRESS_HIGH(0)), 5);
+		PUSH_DATAp(push, &rt[0], 5);
+	}
+	if (NVAccelState(pNv, NV50_3D(RT_HORIZ(0)), 2, &rt[5])) {
+		BEGIN_NV04(push, NV50_3D(RT_HORIZ(0)), 2);
+		PUSH_DATAp(push, &rt[5], 2);
+	}
+	if (NVAccelState(pNv, NV50_3D(RT_ARRAY_MODE), 1, &rt[7])) {
+		BEGIN_NV04(push, NV50_3D(RT_ARRAY_MODE), 1);
+		PUSH_DATA (push, rt[7]);
+	}
 
 	return TRUE;
 }
 
+/* OpenGL and Render disagree on what should be sampled outside an XRGB
+ * texture (with no repeating). Opengl has a hardcoded alpha value of
+ * 1.0, while render expects 0.0.  Without a mask, the mask unit is used
+ * to sample the source's bounds instead, see NV50EXAPictBounds().  We
+ * assume that clipping is done for untranformed sources.
+ */
+static Bool
+NV50EXANeedBounds(PicturePtr ppict, PicturePtr pdpict, int op)
+{
+	return NV50EXABlendOp[op].src_alpha && ppict->pDrawable &&
+	       !ppict->repeat && ppict->transform &&
+	       PICT_FORMAT_A(ppict->format) == 0 &&
+	       PICT_FORMAT_A(pdpict->format) != 0;
+}
+
 static Bool
 NV50EXACheckTexture(PicturePtr ppict, PicturePtr pdpict, int op)
 {
@@ -471,6 +534,8 @@ NV50EXACheckTexture(PicturePtr ppict, PicturePtr pdpict, int op)
 	} else {
 		switch (ppict->pSourcePict->type) {
 		case SourcePictTypeSolidFill:
+		case SourcePictTypeLinear:
+		case SourcePictTypeRadial:
 			break;
 		default:
 			NOUVEAU_FALLBACK("pict %d\n", ppict->pSourcePict->type);
@@ -513,16 +578,6 @@ NV50EXACheckTexture(PicturePtr ppict, PicturePtr pdpict, int op)
 		NOUVEAU_FALLBACK("picture filter %d\n", ppict->filter);
 	}
 
-	/* Opengl and Render disagree on what should be sampled outside an XRGB 
-	 * texture (with no repeating). Opengl has a hardcoded alpha value of 
-	 * 1.0, while render expects 0.0. We assume that clipping is done for 
-	 * untranformed sources.
-	 */
-	if (NV50EXABlendOp[op].src_alpha && !ppict->repeat &&
-		ppict->transform && (PICT_FORMAT_A(ppict->format) == 0)
-		&& (PICT_FORMAT_A(pdpict->format) != 0))
-		NOUVEAU_FALLBACK("REPEAT_NONE unsupported for XRGB source\n");
-
 	return TRUE;
 }
 
@@ -530,6 +585,39 @@ NV50EXACheckTexture(PicturePtr ppict, PicturePtr pdpict, int op)
 			    NV50TIC_0_0_MAP##X1 | NV50TIC_0_0_MAP##X2 | NV50TIC_0_0_MAP##X3 | NV50TIC_0_0_MAP##X4 | \
 			    NV50TIC_0_0_FMT_##FMT)
 
+/* the VP's texture coordinate transform and normalisation for a unit */
+static void
+NV50EXAPictTransform(NVPtr pNv, PicturePtr ppict, unsigned unit,
+		   int width, int height)
+{
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+
+	PUSH_DATAu(push, pNv->scratch, PVP_DATA + (unit * 11 * 4), 11);
+	if (ppict->transform) {
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[0][0]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[0][1]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[0][2]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[1][0]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[1][1]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[1][2]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[2][0]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[2][1]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[2][2]));
+	} else {
+		PUSH_DATAf(push, 1.0);
+		PUSH_DATAf(push, 0.0);
+		PUSH_DATAf(push, 0.0);
+		PUSH_DATAf(push, 0.0);
+		PUSH_DATAf(push, 1.0);
+		PUSH_DATAf(push, 0.0);
+		PUSH_DATAf(push, 0.0);
+		PUSH_DATAf(push, 0.0);
+		PUSH_DATAf(push, 1.0);
+	}
+	PUSH_DATAf(push, 1.0 / width);
+	PUSH_DATAf(push, 1.0 / height);
+}
+
 static Bool
 NV50EXAPictSolid(NVPtr pNv, PicturePtr ppict, unsigned unit)
 {
@@ -564,16 +652,135 @@ NV50EXAPictSolid(NVPtr pNv, PicturePtr ppict, unsigned unit)
 	return TRUE;
 }
 
+/* an opaque texel stretched over the source picture, with the same
+ * transform, reads back as 0 outside of it
+ */
+static void
+NV50EXAPictBounds(NVPtr pNv, PixmapPtr ppix, PicturePtr ppict, unsigned unit)
+{
+	uint64_t offset = pNv->scratch->offset + SOLID(unit);
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+
+	PUSH_DATAu(push, pNv->scratch, SOLID(unit), 1);
+	PUSH_DATA (push, 0xffffffff);
+	PUSH_DATAu(push, pNv->scratch, TIC_OFFSET + (unit * 32), 8);
+	PUSH_DATA (push, _(B_C0, G_C1, R_C2, A_C3, 8_8_8_8));
+	PUSH_DATA (push,  offset);
+	PUSH_DATA (push, (offset >> 32) | 0xd005d000);
+	PUSH_DATA (push, 0x00300000);
+	PUSH_DATA (push, 0x00000001);
+	PUSH_DATA (push, 0x00010001);
+	PUSH_DATA (push, 0x03000000);
+	PUSH_DATA (push, 0x00000000);
+	PUSH_DATAu(push, pNv->scratch, TSC_OFFSET + (unit * 32), 8);
+	PUSH_DATA (push, NV50TSC_1_0_WRAPS_CLAMP_TO_BORDER |
+			 NV50TSC_1_0_WRAPT_CLAMP_TO_BORDER |
+			 NV50TSC_1_0_WRAPR_CLAMP_TO_BORDER | 0x00024000);
+	PUSH_DATA (push, NV50TSC_1_1_MAGF_NEAREST |
+			 NV50TSC_1_1_MINF_NEAREST |
+			 NV50TSC_1_1_MIPF_NONE);
+	PUSH_DATA (push, 0x00000000);
+	PUSH_DATA (push, 0x00000000);
+	PUSH_DATA (push, 0x00000000);
+	PUSH_DATA (push, 0x00000000);
+	PUSH_DATA (push, 0x00000000);
+	PUSH_DATA (push, 0x00000000);
+
+	NV50EXAPictTransform(pNv, ppict, unit, ppix->drawable.width,
+			     ppix->drawable.height);
+}
+
+static Bool
+NV50EXAPictIsRadial(PicturePtr ppict)
+{
+	return !ppict->pDrawable &&
+	       ppict->pSourcePict->type == SourcePictTypeRadial;
+}
+
 static Bool
 NV50EXAPictGradient(NVPtr pNv, PicturePtr ppict, unsigned unit)
 {
-	return FALSE;
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+	uint32_t ramp[NOUVEAU_GRADIENT_TEXELS];
+	uint64_t offset;
+	float m[9], k[2];
+	Bool upload;
+	int i, slot;
+
+	if (!nouveau_exa_gradient(ppict, ramp, m, k))
+		NOUVEAU_FALLBACK("degenerate gradient\n");
+
+	slot = nouveau_exa_gradient_slot(pNv, ramp, &upload);
+	offset = pNv->scratch->offset + GRADIENT(slot);
+	if (upload) {
+		PUSH_DATAu(push, pNv->scratch, GRADIENT(slot),
+			   NOUVEAU_GRADIENT_TEXELS);
+		PUSH_DATAp(push, ramp, NOUVEAU_GRADIENT_TEXELS);
+	}
+
+	PUSH_DATAu(push, pNv->scratch, TIC_OFFSET + (unit * 32), 8);
+	PUSH_DATA (push, _(B_C0, G_C1, R_C2, A_C3, 8_8_8_8));
+	PUSH_DATA (push,  offset);
+	PUSH_DATA (push, (offset >> 32) | 0xd005d000);
+	PUSH_DATA (push, 0x00300000);
+	PUSH_DATA (push, NOUVEAU_GRADIENT_TEXELS);
+	PUSH_DATA (push, 0x00010001);
+	PUSH_DATA (push, 0x03000000);
+	PUSH_DATA (push, 0x00000000);
+	PUSH_DATAu(push, pNv->scratch, TSC_OFFSET + (unit * 32), 8);
+	if (ppict->repeat) {
+		switch (ppict->repeatType) {
+		case RepeatPad:
+			PUSH_DATA (push, NV50TSC_1_0_WRAPS_CLAMP_TO_EDGE |
+				 NV50TSC_1_0_WRAPT_CLAMP_TO_EDGE |
+				 NV50TSC_1_0_WRAPR_CLAMP_TO_EDGE | 0x00024000);
+			break;
+		case RepeatReflect:
+			PUSH_DATA (push, NV50TSC_1_0_WRAPS_MIRROR_REPEAT |
+				 NV50TSC_1_0_WRAPT_CLAMP_TO_EDGE |
+				 NV50TSC_1_0_WRAPR_CLAMP_TO_EDGE | 0x00024000);
+			break;
+		case RepeatNormal:
+		default:
+			PUSH_DATA (push, NV50TSC_1_0_WRAPS_REPEAT |
+				 NV50TSC_1_0_WRAPT_CLAMP_TO_EDGE |
+				 NV50TSC_1_0_WRAPR_CLAMP_TO_EDGE | 0x00024000);
+			break;
+		}
+	} else {
+		PUSH_DATA (push, NV50TSC_1_0_WRAPS_CLAMP_TO_BORDER |
+			 NV50TSC_1_0_WRAPT_CLAMP_TO_EDGE |
+			 NV50TSC_1_0_WRAPR_CLAMP_TO_EDGE | 0x00024000);
+	}
+	PUSH_DATA (push, NV50TSC_1_1_MAGF_NEAREST |
+			 NV50TSC_1_1_MINF_NEAREST |
+			 NV50TSC_1_1_MIPF_NONE);
+	PUSH_DATA (push, 0x00000000);
+	PUSH_DATA (push, 0x00000000);
+	PUSH_DATA (push, 0x00000000);
+	PUSH_DATA (push, 0x00000000);
+	PUSH_DATA (push, 0x00000000);
+	PUSH_DATA (push, 0x00000000);
+
+	PUSH_DATAu(push, pNv->scratch, PVP_DATA + (unit * 11 * 4), 11);
+	for (i = 0; i < 9; i++)
+		PUSH_DATAf(push, m[i]);
+	PUSH_DATAf(push, 1.0);
+	PUSH_DATAf(push, 1.0);
+
+	if (NV50EXAPictIsRadial(ppict)) {
+		PUSH_DATAu(push, pNv->scratch, PFP_DATA + PFP_RADIAL, 2);
+		PUSH_DATAf(push, k[0]);
+		PUSH_DATAf(push, k[1]);
+	}
+	return TRUE;
 }
 
 static Bool
 NV50EXAPictTexture(NVPtr pNv, PixmapPtr ppix, PicturePtr ppict, unsigned unit)
 {
 	struct nouveau_bo *bo = nouveau_pixmap_bo(ppix);
+	uint64_t offset = bo->offset + nouveau_pixmap_offset(ppix);
 	struct nouveau_pushbuf *push = pNv->pushbuf;
 
 	/*XXX: Scanout buffer not tiled, someone needs to figure it out */
@@ -651,8 +858,8 @@ NV50EXAPictTexture(NVPtr pNv, PixmapPtr ppix, PicturePtr ppict, unsigned unit)
 	}
 #undef _
 
-	PUSH_DATA (push, bo->offset);
-	PUSH_DATA (push, (bo->offset >> 32) |
+	PUSH_DATA (push, offset);
+	PUSH_DATA (push, (offset >> 32) |
 			 (bo->config.nv50.tile_mode << 18) |
 			 0xd0005000);
 	PUSH_DATA (push, 0x00300000);
@@ -702,30 +909,8 @@ NV50EXAPictTexture(NVPtr pNv, PixmapPtr ppix, PicturePtr ppict, unsigned unit)
 	PUSH_DATA (push, 0x00000000);
 	PUSH_DATA (push, 0x00000000);
 
-	PUSH_DATAu(push, pNv->scratch, PVP_DATA + (unit * 11 * 4), 11);
-	if (ppict->transform) {
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[0][0]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[0][1]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[0][2]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[1][0]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[1][1]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[1][2]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[2][0]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[2][1]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[2][2]));
-	} else {
-		PUSH_DATAf(push, 1.0);
-		PUSH_DATAf(push, 0.0);
-		PUSH_DATAf(push, 0.0);
-		PUSH_DATAf(push, 0.0);
-		PUSH_DATAf(push, 1.0);
-		PUSH_DATAf(push, 0.0);
-		PUSH_DATAf(push, 0.0);
-		PUSH_DATAf(push, 0.0);
-		PUSH_DATAf(push, 1.0);
-	}
-	PUSH_DATAf(push, 1.0 / ppix->drawable.width);
-	PUSH_DATAf(push, 1.0 / ppix->drawable.height);
+	NV50EXAPictTransform(pNv, ppict, unit, ppix->drawable.width,
+			     ppix->drawable.height);
 	return TRUE;
 }
 
@@ -739,6 +924,7 @@ NV50EXAPicture(NVPtr pNv, PixmapPtr ppix, PicturePtr ppict, int unit)
 	case SourcePictTypeSolidFill:
 		return NV50EXAPictSolid(pNv, ppict, unit);
 	case SourcePictTypeLinear:
+	case SourcePictTypeRadial:
 		return NV50EXAPictGradient(pNv, ppict, unit);
 	default:
 		break;
@@ -760,8 +946,9 @@ NV50EXABlend(PixmapPtr ppix, PicturePtr ppict, int op, int component_alpha)
 {
 	NV50EXA_LOCALS(ppix);
 	struct nv50_blend_op *b = &NV50EXABlendOp[op];
-	unsigned sblend = b->src_blend;
-	unsigned dblend = b->dst_blend;
+	uint32_t sblend = b->src_blend;
+	uint32_t dblend = b->dst_blend;
+	uint32_t enable;
 
 	if (b->dst_alpha) {
 		if (!PICT_FORMAT_A(ppict->format)) {
@@ -781,20 +968,26 @@ NV50EXABlend(PixmapPtr ppix, PicturePtr ppict, int op, int component_alpha)
 			dblend = BF(ONE_MINUS_SRC_COLOR);
 	}
 
-	if (sblend == BF(ONE) && dblend == BF(ZERO)) {
-		BEGIN_NV04(push, NV50_3D(BLEND_ENABLE(0)), 1);
-		PUSH_DATA (push, 0);
-	} else {
+	enable = !(sblend == BF(ONE) && dblend == BF(ZERO));
+	if (NVAccelState(pNv, NV50_3D(BLEND_ENABLE(0)), 1, &enable)) {
 		BEGIN_NV04(push, NV50_3D(BLEND_ENABLE(0)), 1);
-		PUSH_DATA (push, 1);
-		BEGIN_NV04(push, NV50_3D(BLEND_EQUATION_RGB), 5);
-		PUSH_DATA (push, NV50_3D_BLEND_EQUATION_RGB_FUNC_ADD);
-		PUSH_DATA (push, sblend);
-		PUSH_DATA (push, dblend);
-		PUSH_DATA (push, NV50_3D_BLEND_EQUATION_ALPHA_FUNC_ADD);
-		PUSH_DATA (push, sblend);
-		BEGIN_NV04(push, NV50_3D(BLEND_FUNC_DST_ALPHA), 1);
-		PUSH_DATA (push, dblend);
+		PUSH_DATA (push, enable);
+	}
+
+	if (enable) {
+		uint32_t func[5] = { NV50_3D_BLEND_EQUATION_RGB_FUNC_ADD,
+				     sblend, dblend,
+				     NV50_3D_BLEND_EQUATION_ALPHA_FUNC_ADD,
+				     sblend };
+
+		if (NVAccelState(pNv, NV50_3D(BLEND_EQUATION_RGB), 5, func)) {
+			BEGIN_NV04(push, NV50_3D(BLEND_EQUATION_RGB), 5);
+			PUSH_DATAp(push, func, 5);
+		}
+		if (NVAccelState(pNv, NV50_3D(BLEND_FUNC_DST_ALPHA), 1, &dblend)) {
+			BEGIN_NV04(push, NV50_3D(BLEND_FUNC_DST_ALPHA), 1);
+			PUSH_DATA (push, dblend);
+		}
 	}
 }
 
@@ -811,7 +1004,21 @@ NV50EXACheckComposite(int op,
 	if (!NV50EXACheckTexture(pspict, pdpict, op))
 		NOUVEAU_FALLBACK("src picture invalid\n");
 
+	/* the PFP_R* programs only take a radial gradient as the source,
+	 * alone or IN a plain mask
+	 */
+	if (NV50EXAPictIsRadial(pspict)) {
+		if (pdpict->format == PICT_a8)
+			NOUVEAU_FALLBACK("radial gradient to a8\n");
+		if (pmpict && pmpict->componentAlpha &&
+		    PICT_FORMAT_RGB(pmpict->format))
+			NOUVEAU_FALLBACK("radial gradient with component-alpha\n");
+	}
+
 	if (pmpict) {
+		if (NV50EXAPictIsRadial(pmpict))
+			NOUVEAU_FALLBACK("radial gradient mask\n");
+
 		if (pmpict->componentAlpha &&
 		    PICT_FORMAT_RGB(pmpict->format) &&
 		    NV50EXABlendOp[op].src_alpha &&
@@ -820,19 +1027,68 @@ NV50EXACheckComposite(int op,
 
 		if (!NV50EXACheckTexture(pmpict, pdpict, op))
 			NOUVEAU_FALLBACK("mask picture invalid\n");
+
+		if (NV50EXANeedBounds(pspict, pdpict, op) ||
+		    NV50EXANeedBounds(pmpict, pdpict, op))
+			NOUVEAU_FALLBACK("REPEAT_NONE unsupported for XRGB source\n");
 	}
 
 	return TRUE;
 }
 
-Bool
-NV50EXAPrepareComposite(int op,
-			PicturePtr pspict, PicturePtr pmpict, PicturePtr pdpict,
-			PixmapPtr pspix, PixmapPtr pmpix, PixmapPtr pdpix)
+/* Composite rects are queued as quads in a GART buffer and drawn with a
+ * single vertex array per batch, as on NVC0.  The VP reads the position
+ * from attribute 0, and the source and mask coordinates from 8 and 9.
+ */
+#define NV50_COMPOSITE_BATCH 256
+
+struct nv50_vtx {
+	int32_t dx, dy;
+	int32_t sx, sy;
+	int32_t mx, my;
+};
+
+#define NV50_VTX_ATTRIB(m)						\
+	(NV50_3D_VERTEX_ARRAY_ATTRIB_TYPE_SSCALED |			\
+	 NV50_3D_VERTEX_ARRAY_ATTRIB_FORMAT_32_32 |			\
+	 (offsetof(struct nv50_vtx, m) <<				\
+	  NV50_3D_VERTEX_ARRAY_ATTRIB_OFFSET__SHIFT))
+
+static const uint32_t
+NV50EXAVertexFormat[] = {
+	NV50_VTX_ATTRIB(dx),
+	NV50_VTX_ATTRIB(sx),
+	NV50_VTX_ATTRIB(mx),
+};
+
+static __inline__ void
+NV50EXAVertex(struct nv50_vtx *v, int sx, int sy, int mx, int my,
+	      int dx, int dy)
+{
+	v->dx = dx;
+	v->dy = dy;
+	v->sx = sx;
+	v->sy = sy;
+	v->mx = mx;
+	v->my = my;
+}
+
+static Bool
+NV50EXAPrepare3D(int op,
+		 PicturePtr pspict, PicturePtr pmpict, PicturePtr pdpict,
+		 PixmapPtr pspix, PixmapPtr pmpix, PixmapPtr pdpix)
 {
 	NV50EXA_LOCALS(pdpix);
+	uint32_t fp;
+	int space = 256;
 
-	if (!PUSH_SPACE(push, 256))
+	/* baked gradient ramps go through the pushbuf too */
+	if (!pspict->pDrawable)
+		space += NOUVEAU_GRADIENT_TEXELS;
+	if (pmpict && !pmpict->pDrawable)
+		space += NOUVEAU_GRADIENT_TEXELS;
+
+	if (!PUSH_SPACE(push, space))
 		NOUVEAU_FALLBACK("space\n");
 	PUSH_RESET(push);
 	PUSH_REFN (push, pNv->scratch, NOUVEAU_BO_VRAM | NOUVEAU_BO_RDWR);
@@ -848,31 +1104,48 @@ NV50EXAPrepareComposite(int op,
 
 	if (!NV50EXAPicture(pNv, pspix, pspict, 0))
 		NOUVEAU_FALLBACK("src picture invalid\n");
+	pNv->exa_bounds = !pmpict && NV50EXANeedBounds(pspict, pdpict, op);
 
 	if (pmpict) {
 		if (!NV50EXAPicture(pNv, pmpix, pmpict, 1))
 			NOUVEAU_FALLBACK("mask picture invalid\n");
 
-		BEGIN_NV04(push, NV50_3D(FP_START_ID), 1);
 		if (pdpict->format == PICT_a8) {
-			PUSH_DATA (push, PFP_C_A8);
+			fp = PFP_C_A8;
 		} else {
 			if (pmpict->componentAlpha &&
 			    PICT_FORMAT_RGB(pmpict->format)) {
 				if (NV50EXABlendOp[op].src_alpha)
-					PUSH_DATA (push, PFP_CCASA);
+					fp = PFP_CCASA;
 				else
-					PUSH_DATA (push, PFP_CCA);
+					fp = PFP_CCA;
+			} else
+			if (NV50EXAPictIsRadial(pspict)) {
+				fp = PFP_RC;
 			} else {
-				PUSH_DATA (push, PFP_C);
+				fp = PFP_C;
 			}
 		}
+	} else
+	if (pNv->exa_bounds) {
+		NV50EXAPictBounds(pNv, pspix, pspict, 1);
+		if (pdpict->format == PICT_a8)
+			fp = PFP_C_A8;
+		else
+			fp = PFP_C;
 	} else {
-		BEGIN_NV04(push, NV50_3D(FP_START_ID), 1);
 		if (pdpict->format == PICT_a8)
-			PUSH_DATA (push, PFP_S_A8);
+			fp = PFP_S_A8;
+		else
+		if (NV50EXAPictIsRadial(pspict))
+			fp = PFP_RS;
 		else
-			PUSH_DATA (push, PFP_S);
+			fp = PFP_S;
+	}
+
+	if (NVAccelState(pNv, NV50_3D(FP_START_ID), 1, &fp)) {
+		BEGIN_NV04(push, NV50_3D(FP_START_ID), 1);
+		PUSH_DATA (push, fp);
 	}
 
 	BEGIN_NV04(push, NV50_3D(TIC_FLUSH), 1);
@@ -883,40 +1156,290 @@ NV50EXAPrepareComposite(int op,
 	BEGIN_NV04(push, NV50_3D(BIND_TIC(2)), 1);
 	PUSH_DATA (push, 0x203);
 
+	/* rects are drawn as quads, no need to scissor each one.  Not
+	 * shadowed, it'd share a slot with RT_ADDRESS and evict it.
+	 */
+	BEGIN_NV04(push, NV50_3D(SCISSOR_HORIZ(0)), 2);
+	PUSH_DATA (push, pdpix->drawable.width <<
+			 NV50_3D_SCISSOR_HORIZ_MAX__SHIFT);
+	PUSH_DATA (push, pdpix->drawable.height <<
+			 NV50_3D_SCISSOR_VERT_MAX__SHIFT);
+	if (NVAccelState(pNv, NV50_3D(VERTEX_ARRAY_ATTRIB(0)), 1,
+			 &NV50EXAVertexFormat[0])) {
+		BEGIN_NV04(push, NV50_3D(VERTEX_ARRAY_ATTRIB(0)), 1);
+		PUSH_DATA (push, NV50EXAVertexFormat[0]);
+	}
+	if (NVAccelState(pNv, NV50_3D(VERTEX_ARRAY_ATTRIB(8)), 2,
+			 &NV50EXAVertexFormat[1])) {
+		BEGIN_NV04(push, NV50_3D(VERTEX_ARRAY_ATTRIB(8)), 2);
+		PUSH_DATAp(push, &NV50EXAVertexFormat[1], 2);
+	}
+
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		NOUVEAU_FALLBACK("validate\n");
 	}
 
+	pNv->vtx_bo = NULL;
 	return TRUE;
 }
 
-void
-NV50EXAComposite(PixmapPtr pdpix, int sx, int sy, int mx, int my,
-		 int dx, int dy, int w, int h)
+/* Composites that only copy scaled source texels skip the 3D engine, and
+ * go through the 2D engine's scaled blit instead, see nouveau_exa_blit().
+ * Rects that sample outside the source still need the 3D engine, it's
+ * only set up by the first of them, see NV50EXABlit3D().  The formats were
+ * checked by CheckComposite, the tiling and bos are checked here, so that
+ * can't fail for any other reason than running out of pushbuf space.
+ */
+static Bool
+NV50EXAPrepareBlit(int op, PicturePtr pspict, PicturePtr pmpict,
+		   PicturePtr pdpict, PixmapPtr pspix, PixmapPtr pdpix)
 {
 	NV50EXA_LOCALS(pdpix);
+	uint32_t src, dst;
+
+	if (!nouveau_exa_blit(pNv, op, pspict, pmpict, pdpict, pspix))
+		return FALSE;
+	if (pspix == pdpix ||
+	    !nv50_style_tiled_pixmap(pspix) || !nv50_style_tiled_pixmap(pdpix))
+		return FALSE;
+	if (!NV50EXA2DSurfaceFormat(pspix, &src) ||
+	    !NV50EXA2DSurfaceFormat(pdpix, &dst))
+		return FALSE;
 
 	if (!PUSH_SPACE(push, 64))
+		return FALSE;
+	PUSH_RESET(push);
+
+	NV50EXAAcquireSurface2D(pspix, 1, src);
+	NV50EXAAcquireSurface2D(pdpix, 0, dst);
+	NV50EXASetROP(pdpix, GXcopy, ~0);
+	/* the 2D surfaces are the 3D engine's texture and render target,
+	 * it only adds the scratch bo
+	 */
+	PUSH_REFN (push, pNv->scratch, NOUVEAU_BO_VRAM | NOUVEAU_BO_RDWR);
+
+	nouveau_pushbuf_bufctx(push, pNv->bufctx);
+	if (PUSH_VAL(push)) {
+		nouveau_pushbuf_bufctx(push, NULL);
+		return FALSE;
+	}
+
+	pNv->vtx_bo = NULL;
+	return TRUE;
+}
+
+Bool
+NV50EXAPrepareComposite(int op,
+			PicturePtr pspict, PicturePtr pmpict, PicturePtr pdpict,
+			PixmapPtr pspix, PixmapPtr pmpix, PixmapPtr pdpix)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+
+	pNv->exa_blit = NV50EXAPrepareBlit(op, pspict, pmpict, pdpict,
+					   pspix, pdpix);
+	if (pNv->exa_blit) {
+		pNv->blit.op = op;
+		pNv->blit.pspict = pspict;
+		pNv->blit.pdpict = pdpict;
+		pNv->blit.pspix = pspix;
+		pNv->blit.ready = FALSE;
+		return TRUE;
+	}
+
+	if (!NV50EXAPrepare3D(op, pspict, pmpict, pdpict,
+			      pspix, pmpix, pdpix)) {
+		nouveau_pushbuf_bufctx(pNv->pushbuf, NULL);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+NV50EXACompositeFlush(NVPtr pNv)
+{
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+	struct nouveau_bo *bo = pNv->vtx_bo;
+	uint64_t start, limit;
+	int nr = pNv->vtx_count * 4;
+
+	if (!bo)
+		return;
+	pNv->vtx_bo = NULL;
+	if (!nr || !PUSH_SPACE(push, 32))
 		return;
 
-	BEGIN_NV04(push, NV50_3D(SCISSOR_HORIZ(0)), 2);
-	PUSH_DATA (push, (dx + w) << 16 | dx);
-	PUSH_DATA (push, (dy + h) << 16 | dy);
+	start = bo->offset + pNv->vtx_offset;
+	limit = start + nr * sizeof(struct nv50_vtx) - 1;
+
+	BEGIN_NV04(push, NV50_3D(VERTEX_ARRAY_FLUSH), 1);
+	PUSH_DATA (push, 0);
+	BEGIN_NV04(push, NV50_3D(VERTEX_ARRAY_FETCH(0)), 3);
+	PUSH_DATA (push, NV50_3D_VERTEX_ARRAY_FETCH_ENABLE |
+			 sizeof(struct nv50_vtx));
+	PUSH_DATA (push, start >> 32);
+	PUSH_DATA (push, start);
+	BEGIN_NV04(push, NV50_3D(VERTEX_ARRAY_LIMIT_HIGH(0)), 2);
+	PUSH_DATA (push, limit >> 32);
+	PUSH_DATA (push, limit);
 	BEGIN_NV04(push, NV50_3D(VERTEX_BEGIN_GL), 1);
-	PUSH_DATA (push, NV50_3D_VERTEX_BEGIN_GL_PRIMITIVE_TRIANGLES);
-	PUSH_VTX2s(push, sx, sy + (h * 2), mx, my + (h * 2), dx, dy + (h * 2));
-	PUSH_VTX2s(push, sx, sy, mx, my, dx, dy);
-	PUSH_VTX2s(push, sx + (w * 2), sy, mx + (w * 2), my, dx + (w * 2), dy);
+	PUSH_DATA (push, NV50_3D_VERTEX_BEGIN_GL_PRIMITIVE_QUADS);
+	BEGIN_NV04(push, NV50_3D(VERTEX_BUFFER_FIRST), 2);
+	PUSH_DATA (push, 0);
+	PUSH_DATA (push, nr);
 	BEGIN_NV04(push, NV50_3D(VERTEX_END_GL), 1);
 	PUSH_DATA (push, 0);
 }
 
+static struct nv50_vtx *
+NV50EXAVertices(NVPtr pNv)
+{
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+	struct nv50_vtx *v;
+
+	if (!pNv->vtx_bo) {
+		struct nouveau_bo *bo;
+		int offset;
+
+		if (nouveau_exa_scratch(pNv, NV50_COMPOSITE_BATCH * 4 *
+					sizeof(struct nv50_vtx), FALSE,
+					&bo, &offset))
+			return NULL;
+
+		/* the draw may be emitted after any number of kicks, keep
+		 * the array in the bufctx rather than on the pushbuf, the
+		 * previous one is on the pushbuf already
+		 */
+		nouveau_bufctx_reset(BUFCTX(push), NOUVEAU_BIN_VTX);
+		nouveau_bufctx_refn(BUFCTX(push), NOUVEAU_BIN_VTX, bo,
+				    NOUVEAU_BO_GART | NOUVEAU_BO_RD);
+		if (PUSH_VAL(push))
+			return NULL;
+
+		pNv->vtx_bo = bo;
+		pNv->vtx_offset = offset;
+		pNv->vtx_count = 0;
+	}
+
+	v = (struct nv50_vtx *)((char *)pNv->vtx_bo->map + pNv->vtx_offset);
+	return v + pNv->vtx_count * 4;
+}
+
+static Bool
+NV50EXABlit(PixmapPtr pdpix, int sx, int sy, int dx, int dy, int w, int h)
+{
+	NV50EXA_LOCALS(pdpix);
+	uint32_t data[8];
+
+	if (!nouveau_exa_blit_rect(pNv, sx, sy, w, h, data))
+		return FALSE;
+
+	if (!PUSH_SPACE(push, 32))
+		return FALSE;
+
+	BEGIN_NV04(push, SUBC_2D(NV50_GRAPH_SERIALIZE), 1);
+	PUSH_DATA (push, 0);
+	BEGIN_NV04(push, NV50_2D(BLIT_CONTROL), 1);
+	PUSH_DATA (push, NV50_2D_BLIT_CONTROL_ORIGIN_CORNER |
+			 (pNv->blit.bilinear ?
+			  NV50_2D_BLIT_CONTROL_FILTER_BILINEAR :
+			  NV50_2D_BLIT_CONTROL_FILTER_POINT_SAMPLE));
+	BEGIN_NV04(push, NV50_2D(BLIT_DST_X), 12);
+	PUSH_DATA (push, dx);
+	PUSH_DATA (push, dy);
+	PUSH_DATA (push, w);
+	PUSH_DATA (push, h);
+	PUSH_DATAp(push, data, 8);
+
+	NVAccelQueue(pNv, w * h);
+	return TRUE;
+}
+
+/* a rect of a blit composite that the 2D engine can't do, the 3D engine
+ * is set up for the rest of the composite on the first one
+ */
+static Bool
+NV50EXABlit3D(PixmapPtr pdpix)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+	struct nouveau_blit *blit = &pNv->blit;
+
+	if (!blit->ready)
+		blit->ready = NV50EXAPrepare3D(blit->op, blit->pspict, NULL,
+					       blit->pdpict, blit->pspix, NULL,
+					       pdpix);
+	return blit->ready;
+}
+
+void
+NV50EXAComposite(PixmapPtr pdpix, int sx, int sy, int mx, int my,
+		 int dx, int dy, int w, int h)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+	struct nv50_vtx *v;
+
+	if (pNv->exa_blit) {
+		if (NV50EXABlit(pdpix, sx, sy, dx, dy, w, h))
+			return;
+		if (!NV50EXABlit3D(pdpix))
+			return;
+	}
+
+	if (pNv->exa_bounds) {
+		mx = sx;
+		my = sy;
+	}
+
+	if (!(v = NV50EXAVertices(pNv)))
+		return;
+
+	NV50EXAVertex(&v[0], sx, sy, mx, my, dx, dy);
+	NV50EXAVertex(&v[1], sx + w, sy, mx + w, my, dx + w, dy);
+	NV50EXAVertex(&v[2], sx + w, sy + h, mx + w, my + h, dx + w, dy + h);
+	NV50EXAVertex(&v[3], sx, sy + h, mx, my + h, dx, dy + h);
+
+	if (++pNv->vtx_count == NV50_COMPOSITE_BATCH)
+		NV50EXACompositeFlush(pNv);
+}
+
+/* Same as NV50EXAComposite(), except the source and mask coordinates are
+ * given per corner (top-left, top-right, bottom-left) rather than derived
+ * from the destination position, the bottom-right one is extrapolated.
+ */
+void
+NV50EXACompositeAffine(PixmapPtr pdpix, int dx, int dy, int w, int h,
+		       const int32_t *s, const int32_t *m)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+	struct nv50_vtx *v;
+
+	if (pNv->exa_blit && !NV50EXABlit3D(pdpix))
+		return;
+
+	if (!(v = NV50EXAVertices(pNv)))
+		return;
+
+	NV50EXAVertex(&v[0], s[0], s[1], m[0], m[1], dx, dy);
+	NV50EXAVertex(&v[1], s[2], s[3], m[2], m[3], dx + w, dy);
+	NV50EXAVertex(&v[2], s[2] + s[4] - s[0], s[3] + s[5] - s[1],
+		      m[2] + m[4] - m[0], m[3] + m[5] - m[1], dx + w, dy + h);
+	NV50EXAVertex(&v[3], s[4], s[5], m[4], m[5], dx, dy + h);
+
+	if (++pNv->vtx_count == NV50_COMPOSITE_BATCH)
+		NV50EXACompositeFlush(pNv);
+}
+
 void
 NV50EXADoneComposite(PixmapPtr pdpix)
 {
 	NV50EXA_LOCALS(pdpix);
+
+	/* the vertex array setup is left in place for the next composite,
+	 * Xv puts the immediate-mode attributes back itself
+	 */
+	NV50EXACompositeFlush(pNv);
 	nouveau_pushbuf_bufctx(push, NULL);
 }
 
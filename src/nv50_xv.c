@@ -39,6 +39,13 @@ extern Atom xvSyncToVBlank, xvSetDefaults;
 extern Atom xvBrightness, xvContrast, xvHue, xvSaturation;
 extern Atom xvITURBT709;
 
+/* what the attributes composite fetches from its vertex array are reset to,
+ * so the immediate-mode VTX_ATTR methods below take effect again
+ */
+#define NV50_XV_VTX_CONST (NV50_3D_VERTEX_ARRAY_ATTRIB_TYPE_FLOAT |	\
+			   NV50_3D_VERTEX_ARRAY_ATTRIB_FORMAT_32_32_32_32 |	\
+			   NV50_3D_VERTEX_ARRAY_ATTRIB_CONST)
+
 static Bool
 nv50_xv_check_image_put(PixmapPtr ppix)
 {
@@ -71,6 +78,7 @@ nv50_xv_image_put(ScrnInfoPtr pScrn,
 {
 	NVPtr pNv = NVPTR(pScrn);
 	struct nouveau_bo *dst = nouveau_pixmap_bo(ppix);
+	uint64_t dst_offset = dst->offset + nouveau_pixmap_offset(ppix);
 	struct nouveau_pushbuf *push = pNv->pushbuf;
 	struct nouveau_pushbuf_refn refs[] = {
 		{ pNv->scratch, NOUVEAU_BO_VRAM | NOUVEAU_BO_RDWR },
@@ -88,9 +96,21 @@ nv50_xv_image_put(ScrnInfoPtr pScrn,
 	if (!PUSH_SPACE(push, 256))
 		return BadImplementation;
 
+	/* none of this goes through the EXA state shadow, and composite
+	 * leaves its vertex array bound
+	 */
+	NVAccelStateReset(pNv);
+	BEGIN_NV04(push, NV50_3D(VERTEX_ARRAY_FETCH(0)), 1);
+	PUSH_DATA (push, 0);
+	BEGIN_NV04(push, NV50_3D(VERTEX_ARRAY_ATTRIB(0)), 1);
+	PUSH_DATA (push, NV50_XV_VTX_CONST);
+	BEGIN_NV04(push, NV50_3D(VERTEX_ARRAY_ATTRIB(8)), 2);
+	PUSH_DATA (push, NV50_XV_VTX_CONST);
+	PUSH_DATA (push, NV50_XV_VTX_CONST);
+
 	BEGIN_NV04(push, NV50_3D(RT_ADDRESS_HIGH(0)), 5);
-	PUSH_DATA (push, dst->offset >> 32);
-	PUSH_DATA (push, dst->offset);
+	PUSH_DATA (push, dst_offset >> 32);
+	PUSH_DATA (push, dst_offset);
 	switch (ppix->drawable.bitsPerPixel) {
 	case 32: PUSH_DATA (push, NV50_SURFACE_FORMAT_BGRA8_UNORM); break;
 	case 24: PUSH_DATA (push, NV50_SURFACE_FORMAT_BGRX8_UNORM); break;
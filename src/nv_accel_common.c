@@ -28,17 +28,150 @@
 #include "hwdefs/nv50_2d.xml.h"
 #include "nv04_accel.h"
 
-Bool
-nouveau_allocate_surface(ScrnInfoPtr scrn, int width, int height, int bpp,
-			 int usage_hint, int *pitch, struct nouveau_bo **bo)
+/* BOs are cached for a second after the pixmap using them goes away, so
+ * the flood of short-lived pixmaps toolkits create doesn't cost a kernel
+ * allocation (and VM mapping) for each of them.
+ */
+#define NOUVEAU_BO_CACHE_EXPIRE 1000 /* milliseconds */
+#define NOUVEAU_BO_CACHE_MAX_BO (32 * 1024 * 1024)
+
+struct nouveau_bo_cache_entry {
+	struct nouveau_bo_cache_entry *next;
+	struct nouveau_bo *bo;
+	CARD32 time;
+};
+
+/* one bucket per power of two */
+static inline int
+nouveau_bo_cache_bucket(uint32_t size)
+{
+	return size > 1 ? log2i(size - 1) + 1 : 0;
+}
+
+static void
+nouveau_bo_cache_expire(NVPtr pNv, Bool all)
+{
+	struct nouveau_bo_cache_entry **pe, *e;
+	CARD32 now = GetTimeInMillis();
+	int i;
+
+	for (i = 0; i < NOUVEAU_BO_CACHE_BUCKETS; i++) {
+		/* entries are kept newest first */
+		for (pe = &pNv->bo_cache[i]; (e = *pe); pe = &e->next) {
+			if (all || now - e->time > NOUVEAU_BO_CACHE_EXPIRE)
+				break;
+		}
+
+		*pe = NULL;
+		while (e) {
+			struct nouveau_bo_cache_entry *next = e->next;
+
+			pNv->bo_cache_size -= e->bo->size;
+			nouveau_bo_ref(NULL, &e->bo);
+			free(e);
+			e = next;
+		}
+	}
+}
+
+/* the cache is also trimmed while the server is idle, when nothing else
+ * would get to nouveau_bo_cache_put()
+ */
+static CARD32
+nouveau_bo_cache_timer(OsTimerPtr timer, CARD32 now, void *arg)
+{
+	NVPtr pNv = arg;
+
+	nouveau_bo_cache_expire(pNv, FALSE);
+	return pNv->bo_cache_size ? NOUVEAU_BO_CACHE_EXPIRE : 0;
+}
+
+static struct nouveau_bo *
+nouveau_bo_cache_get(NVPtr pNv, uint32_t flags, union nouveau_bo_config *cfg,
+		     uint32_t size)
+{
+	const uint32_t domain = NOUVEAU_BO_VRAM | NOUVEAU_BO_GART;
+	struct nouveau_bo_cache_entry **pe, *e = NULL;
+	struct nouveau_bo *bo;
+	int bucket;
+
+	if (size > NOUVEAU_BO_CACHE_MAX_BO)
+		return NULL;
+
+	/* the BO must look exactly like what a fresh allocation would give,
+	 * so match on its domain and tiling config (memtype/tile_mode), and
+	 * don't waste more than a quarter of it, which can put it one
+	 * bucket up
+	 */
+	bucket = nouveau_bo_cache_bucket(size);
+	for (; !e && bucket < NOUVEAU_BO_CACHE_BUCKETS &&
+	       bucket <= nouveau_bo_cache_bucket(size) + 1; bucket++) {
+		for (pe = &pNv->bo_cache[bucket]; (e = *pe); pe = &e->next) {
+			if (e->bo->size >= size &&
+			    e->bo->size - size <= size / 4 &&
+			    (e->bo->flags & domain) == (flags & domain) &&
+			    !memcmp(&e->bo->config, cfg, sizeof(*cfg)))
+				break;
+		}
+	}
+
+	if (!e)
+		return NULL;
+
+	*pe = e->next;
+	bo = e->bo;
+	pNv->bo_cache_size -= bo->size;
+	free(e);
+	return bo;
+}
+
+/* takes over the caller's reference to bo */
+void
+nouveau_bo_cache_put(ScrnInfoPtr scrn, struct nouveau_bo *bo)
+{
+	NVPtr pNv = NVPTR(scrn);
+	struct nouveau_bo_cache_entry *e;
+	int bucket;
+
+	nouveau_bo_cache_expire(pNv, FALSE);
+
+	if (bo->size > NOUVEAU_BO_CACHE_MAX_BO ||
+	    pNv->bo_cache_size + bo->size > pNv->dev->vram_size / 16)
+		goto free;
+
+	e = malloc(sizeof(*e));
+	if (!e)
+		goto free;
+
+	bucket = nouveau_bo_cache_bucket(bo->size);
+	e->bo = bo;
+	e->time = GetTimeInMillis();
+	e->next = pNv->bo_cache[bucket];
+	pNv->bo_cache[bucket] = e;
+	if (!pNv->bo_cache_size)
+		pNv->bo_cache_timer = TimerSet(pNv->bo_cache_timer, 0,
+					       NOUVEAU_BO_CACHE_EXPIRE,
+					       nouveau_bo_cache_timer, pNv);
+	pNv->bo_cache_size += bo->size;
+	return;
+
+free:
+	nouveau_bo_ref(NULL, &bo);
+}
+
+static void
+nouveau_surface_layout(ScrnInfoPtr scrn, int width, int *pheight, int bpp,
+		       int usage_hint, int *pitch, uint32_t *pflags,
+		       union nouveau_bo_config *pcfg)
 {
 	NVPtr pNv = NVPTR(scrn);
 	Bool scanout = (usage_hint & NOUVEAU_CREATE_PIXMAP_SCANOUT);
 	Bool tiled = (usage_hint & NOUVEAU_CREATE_PIXMAP_TILED);
 	Bool shared = FALSE;
 	union nouveau_bo_config cfg = {};
-	int flags = NOUVEAU_BO_MAP | (bpp >= 8 ? NOUVEAU_BO_VRAM : 0);
-	int cpp = bpp / 8, ret;
+	int height = *pheight;
+	uint32_t flags;
+	int cpp = bpp / 8;
 
 #ifdef NOUVEAU_PIXMAP_SHARING
 	shared = ((usage_hint & 0xffff) == CREATE_PIXMAP_USAGE_SHARED);
@@ -113,6 +246,30 @@ nouveau_allocate_surface(ScrnInfoPtr scrn, int width, int height, int bpp,
 	if (usage_hint & NOUVEAU_CREATE_PIXMAP_SCANOUT)
 		flags |= NOUVEAU_BO_CONTIG;
 
+	*pheight = height;
+	*pflags = flags;
+	*pcfg = cfg;
+}
+
+Bool
+nouveau_allocate_surface(ScrnInfoPtr scrn, int width, int height, int bpp,
+			 int usage_hint, int *pitch, struct nouveau_bo **bo)
+{
+	NVPtr pNv = NVPTR(scrn);
+	union nouveau_bo_config cfg;
+	uint32_t flags;
+	int ret;
+
+	nouveau_surface_layout(scrn, width, &height, bpp, usage_hint,
+			       pitch, &flags, &cfg);
+
+	/* scanout and shared buffers never come from the cache */
+	if (!(flags & (NOUVEAU_BO_CONTIG | NOUVEAU_BO_GART))) {
+		*bo = nouveau_bo_cache_get(pNv, flags, &cfg, *pitch * height);
+		if (*bo)
+			return TRUE;
+	}
+
 	ret = nouveau_bo_new(pNv->dev, flags, 0, *pitch * height, &cfg, bo);
 	if (ret) {
 		ErrorF("%d\n", ret);
@@ -122,6 +279,147 @@ nouveau_allocate_surface(ScrnInfoPtr scrn, int width, int height, int bpp,
 	return TRUE;
 }
 
+/* Small pixmaps are packed into shared 64KiB BOs ("slabs") of equally sized
+ * slots, rather than each taking a BO (and at least a page) of its own.
+ * Slot sizes are powers of two, so every slot is naturally aligned to the
+ * tile block size of the pixmaps that live in it.
+ */
+#define NOUVEAU_SLAB_SIZE     (64 * 1024)
+#define NOUVEAU_SLAB_MIN_SLOT 1024
+#define NOUVEAU_SLAB_MAX_SLOT (16 * 1024)
+
+static inline uint64_t
+nouveau_slab_full(struct nouveau_slab *slab)
+{
+	int slots = NOUVEAU_SLAB_SIZE / slab->slot_size;
+
+	return slots == 64 ? ~0ULL : (1ULL << slots) - 1;
+}
+
+Bool
+nouveau_allocate_surface_slab(ScrnInfoPtr scrn, int width, int height, int bpp,
+			      int usage_hint, int *pitch,
+			      struct nouveau_pixmap *nvpix)
+{
+	NVPtr pNv = NVPTR(scrn);
+	struct nouveau_slab *slab;
+	union nouveau_bo_config cfg;
+	uint32_t flags, size;
+	int slot;
+
+	/* only plain (tiled) pixmaps on Tesla and up, the older emitters
+	 * have no idea about pixmaps not starting at the beginning of a BO
+	 */
+	if (pNv->Architecture < NV_TESLA || bpp < 8 ||
+	    (usage_hint & (NOUVEAU_CREATE_PIXMAP_ZETA |
+			   NOUVEAU_CREATE_PIXMAP_SCANOUT)))
+		return FALSE;
+
+	nouveau_surface_layout(scrn, width, &height, bpp, usage_hint,
+			       pitch, &flags, &cfg);
+	if (flags & NOUVEAU_BO_GART)
+		return FALSE;
+
+	size = *pitch * height;
+	if (size > NOUVEAU_SLAB_MAX_SLOT)
+		return FALSE;
+	if (size < NOUVEAU_SLAB_MIN_SLOT)
+		size = NOUVEAU_SLAB_MIN_SLOT;
+	size = 1 << log2i(size * 2 - 1);
+
+	for (slab = pNv->slabs; slab; slab = slab->next) {
+		if (slab->slot_size == size &&
+		    slab->used != nouveau_slab_full(slab) &&
+		    !memcmp(&slab->bo->config, &cfg, sizeof(cfg)))
+			break;
+	}
+
+	if (!slab) {
+		slab = calloc(1, sizeof(*slab));
+		if (!slab)
+			return FALSE;
+
+		if (nouveau_bo_new(pNv->dev, flags, 0, NOUVEAU_SLAB_SIZE,
+				   &cfg, &slab->bo)) {
+			free(slab);
+			return FALSE;
+		}
+
+		slab->slot_size = size;
+		slab->next = pNv->slabs;
+		pNv->slabs = slab;
+	}
+
+	for (slot = 0; slab->used & (1ULL << slot); slot++);
+	slab->used |= 1ULL << slot;
+
+	nouveau_bo_ref(slab->bo, &nvpix->bo);
+	nvpix->slab = slab;
+	nvpix->offset = slot * slab->slot_size;
+	return TRUE;
+}
+
+void
+nouveau_slab_free(ScrnInfoPtr scrn, struct nouveau_pixmap *nvpix)
+{
+	NVPtr pNv = NVPTR(scrn);
+	struct nouveau_slab *slab = nvpix->slab, **ps;
+
+	nouveau_bo_ref(NULL, &nvpix->bo);
+	nvpix->slab = NULL;
+
+	slab->used &= ~(1ULL << (nvpix->offset / slab->slot_size));
+	nvpix->offset = 0;
+	if (slab->used)
+		return;
+
+	for (ps = &pNv->slabs; *ps != slab; ps = &(*ps)->next);
+	*ps = slab->next;
+
+	nouveau_bo_ref(NULL, &slab->bo);
+	free(slab);
+}
+
+/* Move a pixmap out of its slab into a BO of its own, needed before the BO
+ * is handed to anyone outside the X server (which would otherwise get
+ * access to every other pixmap in the slab).
+ */
+Bool
+nouveau_pixmap_unslab(PixmapPtr ppix)
+{
+	ScrnInfoPtr scrn = xf86ScreenToScrn(ppix->drawable.pScreen);
+	NVPtr pNv = NVPTR(scrn);
+	struct nouveau_pixmap *nvpix = nouveau_pixmap(ppix);
+	struct nouveau_bo *bo = NULL;
+	int pitch;
+
+	if (!nvpix || !nvpix->slab)
+		return TRUE;
+
+	if (!nouveau_allocate_surface(scrn, ppix->drawable.width,
+				      ppix->drawable.height,
+				      ppix->drawable.bitsPerPixel, 0,
+				      &pitch, &bo))
+		return FALSE;
+
+	if (pitch != ppix->devKind ||
+	    nouveau_bo_map(bo, NOUVEAU_BO_WR, pNv->client) ||
+	    nouveau_bo_map(nvpix->bo, NOUVEAU_BO_RD, pNv->client)) {
+		nouveau_bo_ref(NULL, &bo);
+		return FALSE;
+	}
+
+	/* same pitch and tiling, so the raw bytes can be copied as-is */
+	memcpy(bo->map, (char *)nvpix->bo->map + nvpix->offset,
+	       min(bo->size, nvpix->slab->slot_size));
+
+	nouveau_slab_free(scrn, nvpix);
+	nvpix->bo = bo;
+	if (ppix->devPrivate.ptr && !nvpix->mirror_access)
+		ppix->devPrivate.ptr = bo->map;
+	return TRUE;
+}
+
 void
 NV11SyncToVBlank(PixmapPtr ppix, BoxPtr box)
 {
@@ -309,6 +607,87 @@ NVGetDrawablePixmap(DrawablePtr pDraw)
 		return (PixmapPtr) pDraw;
 }
 
+/* Submission policy
+ *
+ * Commands are submitted from the block handler, or when the CPU is about
+ * to touch something the GPU may still be using.  On top of that, ops
+ * report the work they queue here, and the pushbuf is kicked early when
+ * enough has piled up to keep the GPU busy, or when the oldest unsubmitted
+ * work has been waiting longer than the time budget.  A full pushbuf is
+ * flushed by libdrm itself.
+ */
+#define NOUVEAU_KICK_PIXELS (1024 * 1024)
+#define NOUVEAU_KICK_MS 2 /* milliseconds */
+
+/* libdrm calls this for every submission, including the ones it does
+ * by itself when the pushbuf fills up or a validate needs the space, so
+ * the queued work is accounted as submitted whoever kicked
+ */
+static void
+NVAccelKickNotify(struct nouveau_pushbuf *push)
+{
+	struct nouveau_push_priv *priv = push->user_priv;
+
+	priv->pNv->kick_pixels = 0;
+	priv->pNv->kick_ops = 0;
+	nouveau_stats_count(push, NOUVEAU_STATS_KICKS);
+}
+
+void
+NVAccelKick(NVPtr pNv)
+{
+	PUSH_KICK(pNv->pushbuf);
+}
+
+void
+NVAccelQueue(NVPtr pNv, uint32_t pixels)
+{
+	if (!pNv->kick_ops++)
+		pNv->kick_time = GetTimeInMillis();
+	pNv->kick_pixels += pixels;
+
+	/* only look at the clock every so often, it's not free */
+	if (pNv->kick_pixels >= NOUVEAU_KICK_PIXELS ||
+	    (!(pNv->kick_ops & 63) &&
+	     GetTimeInMillis() - pNv->kick_time >= NOUVEAU_KICK_MS))
+		NVAccelKick(pNv);
+}
+
+/* Method state shadow
+ *
+ * Remembers the last value written to each 2D/3D method, so emitters can
+ * skip a block of state the GPU already has.  It's a small direct-mapped
+ * table keyed by subchannel and method, a collision only costs a
+ * redundant emit.  Code that writes shadowed methods without going
+ * through here must call NVAccelStateReset() afterwards.
+ */
+Bool
+NVAccelState(NVPtr pNv, int subc, int mthd, int size, const uint32_t *data)
+{
+	Bool dirty = FALSE;
+	int i;
+
+	for (i = 0; i < size; i++, mthd += 4) {
+		uint32_t key = (subc << 16) | mthd;
+		int idx = ((mthd >> 2) + subc * 37) & (NOUVEAU_STATE_SIZE - 1);
+
+		if (pNv->state[idx].key != key ||
+		    pNv->state[idx].data != data[i]) {
+			pNv->state[idx].key = key;
+			pNv->state[idx].data = data[i];
+			dirty = TRUE;
+		}
+	}
+
+	return dirty;
+}
+
+void
+NVAccelStateReset(NVPtr pNv)
+{
+	memset(pNv->state, 0, sizeof(pNv->state));
+}
+
 static Bool
 NVAccelInitImagePattern(ScrnInfoPtr pScrn)
 {
@@ -613,7 +992,13 @@ NVAccelCommonFini(ScrnInfoPtr pScrn)
 	nouveau_object_del(&pNv->NvCOPY);
 
 	nouveau_bo_ref(NULL, &pNv->scratch);
+	TimerFree(pNv->bo_cache_timer);
+	pNv->bo_cache_timer = NULL;
+	nouveau_bo_cache_expire(pNv, TRUE);
 
+	if (pNv->pushbuf)
+		nouveau_stats_fini(pScrn);
+	nouveau_fallback_report(pScrn);
 	nouveau_bufctx_del(&pNv->bufctx);
 	nouveau_pushbuf_del(&pNv->pushbuf);
 	nouveau_object_del(&pNv->channel);
@@ -661,13 +1046,17 @@ NVAccelCommonInit(ScrnInfoPtr pScrn)
 		return FALSE;
 	}
 
-	ret = nouveau_bufctx_new(pNv->client, 1, &pNv->bufctx);
+	ret = nouveau_bufctx_new(pNv->client, NOUVEAU_BINS, &pNv->bufctx);
 	if (ret) {
 		NVAccelCommonFini(pScrn);
 		return FALSE;
 	}
 
-	pNv->pushbuf->user_priv = pNv->bufctx;
+	pNv->push_priv.bufctx = pNv->bufctx;
+	pNv->push_priv.pNv = pNv;
+	pNv->pushbuf->user_priv = &pNv->push_priv;
+	pNv->pushbuf->kick_notify = NVAccelKickNotify;
+	nouveau_stats_init(pScrn);
 
 	/* Scratch buffer */
 	ret = nouveau_bo_new(pNv->dev, NOUVEAU_BO_VRAM | NOUVEAU_BO_MAP,
@@ -722,6 +1111,7 @@ NVAccelCommonInit(ScrnInfoPtr pScrn)
 	switch (pNv->Architecture) {
 	case NV_FERMI:
 	case NV_KEPLER:
+	case NV_MAXWELL:
 		INIT_CONTEXT_OBJECT(3D_NVC0);
 		break;
 	case NV_TESLA:
@@ -741,6 +1131,7 @@ NVAccelCommonInit(ScrnInfoPtr pScrn)
 		break;
 	}
 
+	NVAccelStateReset(pNv);
 	xf86DrvMsg(pScrn->scrnIndex, X_INFO, "Channel setup complete.\n");
 	return TRUE;
 }
@@ -19,6 +19,9 @@ typedef enum {
     OPTION_ASYNC_COPY,
     OPTION_ACCELMETHOD,
     OPTION_DRI,
+    OPTION_LINEAR_MIRROR,
+    OPTION_PUSHBUF_STATS,
+    OPTION_UPLOAD_CACHE,
 } NVOpts;
 
 
@@ -36,6 +39,9 @@ static const OptionInfoRec NVOptions[] = {
     { OPTION_ASYNC_COPY,	"AsyncUTSDFS",	OPTV_BOOLEAN,	{0}, FALSE },
     { OPTION_ACCELMETHOD,	"AccelMethod",	OPTV_STRING,	{0}, FALSE },
     { OPTION_DRI,		"DRI",		OPTV_INTEGER,	{0}, FALSE },
+    { OPTION_LINEAR_MIRROR,	"LinearMirror",	OPTV_BOOLEAN,	{0}, FALSE },
+    { OPTION_PUSHBUF_STATS,	"PushbufStats",	OPTV_BOOLEAN,	{0}, FALSE },
+    { OPTION_UPLOAD_CACHE,	"UploadCache",	OPTV_STRING,	{0}, FALSE },
     { -1,                       NULL,           OPTV_NONE,      {0}, FALSE }
 };
 
@@ -600,6 +600,7 @@ NVBlockHandler (BLOCKHANDLER_ARGS_DECL)
 #endif
 
 	NVFlushCallback(NULL, pScrn, NULL);
+	nouveau_fallback_publish(pScreen);
 
 	if (pNv->VideoTimerCallback) 
 		(*pNv->VideoTimerCallback)(pScrn, currentTime.milliseconds);
@@ -623,6 +624,8 @@ NVCreateScreenResources(ScreenPtr pScreen)
 	if (pNv->AccelMethod == EXA) {
 		PixmapPtr ppix = pScreen->GetScreenPixmap(pScreen);
 		nouveau_bo_ref(pNv->scanout, &nouveau_pixmap(ppix)->bo);
+		nouveau_pixmap(ppix)->reusable = FALSE;
+		nouveau_exa_upload_init(pScreen);
 	}
 
 	return TRUE;
@@ -684,6 +687,24 @@ NVCloseScreen(CLOSE_SCREEN_ARGS_DECL)
 		pNv->textureAdaptor[1] = NULL;
 	}
 	if (pNv->EXADriverPtr) {
+		if (pNv->CreateGC) {
+			pScreen->CreateGC = pNv->CreateGC;
+			pNv->CreateGC = NULL;
+		}
+		if (pNv->Trapezoids) {
+			PictureScreenPtr ps = GetPictureScreen(pScreen);
+
+			ps->Trapezoids = pNv->Trapezoids;
+			ps->Triangles = pNv->Triangles;
+			ps->AddTraps = pNv->AddTraps;
+			ps->Glyphs = pNv->Glyphs;
+			pNv->Trapezoids = NULL;
+		}
+		if (pNv->trap_edge) {
+			FreePicture(pNv->trap_edge, 0);
+			pNv->trap_edge = NULL;
+		}
+		nouveau_exa_glyphs_fini(pScreen);
 		exaDriverFini(pScreen);
 		free(pNv->EXADriverPtr);
 		pNv->EXADriverPtr = NULL;
@@ -1070,6 +1091,12 @@ NVPreInit(ScrnInfoPtr pScrn, int flags)
 		if (pNv->Architecture >= NV_TESLA)
 			pNv->wfb_enabled = xf86ReturnOptValBool(
 				pNv->Options, OPTION_WFB, FALSE);
+		pNv->linear_mirror = xf86ReturnOptValBool(
+			pNv->Options, OPTION_LINEAR_MIRROR, TRUE);
+		pNv->push_stats = xf86ReturnOptValBool(
+			pNv->Options, OPTION_PUSHBUF_STATS, FALSE);
+		pNv->upload_cache = xf86GetOptValString(
+			pNv->Options, OPTION_UPLOAD_CACHE);
 
 		pNv->tiled_scanout = TRUE;
 	}
@@ -1272,10 +1299,12 @@ static Bool
 NVUnmapMem(ScrnInfoPtr pScrn)
 {
 	NVPtr pNv = NVPTR(pScrn);
+	int i;
 
 	drmmode_remove_fb(pScrn);
 
-	nouveau_bo_ref(NULL, &pNv->transfer);
+	for (i = 0; i < NOUVEAU_TRANSFER_SLOTS; i++)
+		nouveau_bo_ref(NULL, &pNv->transfer[i].bo);
 	nouveau_bo_ref(NULL, &pNv->scanout);
 	return TRUE;
 }
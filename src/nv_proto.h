@@ -28,10 +28,21 @@ void NVAccelCommonFini(ScrnInfoPtr pScrn);
 Bool NVAccelGetCtxSurf2DFormatFromPixmap(PixmapPtr pPix, int *fmt_ret);
 Bool NVAccelGetCtxSurf2DFormatFromPicture(PicturePtr pPix, int *fmt_ret);
 PixmapPtr NVGetDrawablePixmap(DrawablePtr pDraw);
+void NVAccelKick(NVPtr pNv);
+void NVAccelQueue(NVPtr pNv, uint32_t pixels);
+Bool NVAccelState(NVPtr pNv, int subc, int mthd, int size,
+		  const uint32_t *data);
+void NVAccelStateReset(NVPtr pNv);
 void NV11SyncToVBlank(PixmapPtr ppix, BoxPtr box);
 Bool nouveau_allocate_surface(ScrnInfoPtr scrn, int width, int height,
 			      int bpp, int usage_hint, int *pitch,
 			      struct nouveau_bo **bo);
+void nouveau_bo_cache_put(ScrnInfoPtr scrn, struct nouveau_bo *bo);
+Bool nouveau_allocate_surface_slab(ScrnInfoPtr scrn, int width, int height,
+				   int bpp, int usage_hint, int *pitch,
+				   struct nouveau_pixmap *nvpix);
+void nouveau_slab_free(ScrnInfoPtr scrn, struct nouveau_pixmap *nvpix);
+Bool nouveau_pixmap_unslab(PixmapPtr ppix);
 
 /* in nouveau_dri2.c */
 Bool nouveau_dri2_init(ScreenPtr pScreen);
@@ -49,12 +60,36 @@ xf86CrtcPtr nouveau_pick_best_crtc(ScrnInfoPtr pScrn, Bool consider_disabled,
 
 /* in nouveau_exa.c */
 Bool nouveau_exa_init(ScreenPtr pScreen);
+void nouveau_exa_upload_init(ScreenPtr pScreen);
 Bool nouveau_exa_pixmap_is_onscreen(PixmapPtr pPixmap);
 bool nv50_style_tiled_pixmap(PixmapPtr ppix);
+void nouveau_pixmap_fence(PixmapPtr ppix, uint32_t access);
+int nouveau_exa_scratch(NVPtr pNv, int size, Bool own_slot,
+			struct nouveau_bo **pbo, int *off);
+Bool nouveau_exa_gradient(PicturePtr ppict, uint32_t *ramp, float *m,
+			  float *k);
+int nouveau_exa_gradient_slot(NVPtr pNv, const uint32_t *ramp, Bool *upload);
+void nouveau_exa_glyphs_fini(ScreenPtr pScreen);
+Bool nouveau_exa_blit(NVPtr pNv, int op, PicturePtr pspict, PicturePtr pmpict,
+		      PicturePtr pdpict, PixmapPtr pspix);
+Bool nouveau_exa_blit_rect(NVPtr pNv, int sx, int sy, int w, int h,
+			   uint32_t *data);
 Bool NVAccelM2MF(NVPtr pNv, int w, int h, int cpp, uint32_t srco, uint32_t dsto,
 		 struct nouveau_bo *s, int sd, int sp, int sh, int sx, int sy,
 		 struct nouveau_bo *d, int dd, int dp, int dh, int dx, int dy);
 
+/* in nouveau_stats.c */
+void nouveau_stats_init(ScrnInfoPtr pScrn);
+void nouveau_stats_fini(ScrnInfoPtr pScrn);
+void nouveau_fallback_composite(struct nouveau_fallback_site *site, int op,
+				PicturePtr src, PicturePtr mask, PicturePtr dst);
+void nouveau_fallback_publish(ScreenPtr pScreen);
+void nouveau_fallback_report(ScrnInfoPtr pScrn);
+
+/* in nouveau_memcpy.c */
+void nouveau_memcpy_init(ScrnInfoPtr pScrn);
+void nouveau_memcpy_to_wc(void *dst, const void *src, size_t n);
+void nouveau_memcpy_from_wc(void *dst, const void *src, size_t n);
 
 /* in nouveau_wfb.c */
 void nouveau_wfb_setup_wrap(ReadMemoryProcPtr *, WriteMemoryProcPtr *,
@@ -162,6 +197,7 @@ Bool NVAccelInit3D_NVC0(ScrnInfoPtr pScrn);
 /* in nv50_exa.c */
 Bool NV50EXAPrepareSolid(PixmapPtr, int, Pixel, Pixel);
 void NV50EXASolid(PixmapPtr, int, int, int, int);
+void NV50EXASolidBoxes(PixmapPtr, BoxPtr, int);
 void NV50EXADoneSolid(PixmapPtr);
 Bool NV50EXAPrepareCopy(PixmapPtr, PixmapPtr, int, int, int, Pixel);
 void NV50EXACopy(PixmapPtr, int, int, int, int, int, int);
@@ -170,6 +206,8 @@ Bool NV50EXACheckComposite(int, PicturePtr, PicturePtr, PicturePtr);
 Bool NV50EXAPrepareComposite(int, PicturePtr, PicturePtr, PicturePtr,
 				  PixmapPtr, PixmapPtr, PixmapPtr);
 void NV50EXAComposite(PixmapPtr, int, int, int, int, int, int, int, int);
+void NV50EXACompositeAffine(PixmapPtr, int, int, int, int,
+			    const int32_t *, const int32_t *);
 void NV50EXADoneComposite(PixmapPtr);
 Bool NV50EXAUploadSIFC(const char *src, int src_pitch,
 		       PixmapPtr pdPix, int x, int y, int w, int h, int cpp);
@@ -185,6 +223,7 @@ Bool NVC0AccelDownloadM2MF(PixmapPtr pspix, int x, int y, int w, int h,
 
 Bool NVC0EXAPrepareSolid(PixmapPtr, int, Pixel, Pixel);
 void NVC0EXASolid(PixmapPtr, int, int, int, int);
+void NVC0EXASolidBoxes(PixmapPtr, BoxPtr, int);
 void NVC0EXADoneSolid(PixmapPtr);
 Bool NVC0EXAPrepareCopy(PixmapPtr, PixmapPtr, int, int, int, Pixel);
 void NVC0EXACopy(PixmapPtr, int, int, int, int, int, int);
@@ -193,6 +232,8 @@ Bool NVC0EXACheckComposite(int, PicturePtr, PicturePtr, PicturePtr);
 Bool NVC0EXAPrepareComposite(int, PicturePtr, PicturePtr, PicturePtr,
 				  PixmapPtr, PixmapPtr, PixmapPtr);
 void NVC0EXAComposite(PixmapPtr, int, int, int, int, int, int, int, int);
+void NVC0EXACompositeAffine(PixmapPtr, int, int, int, int,
+			    const int32_t *, const int32_t *);
 void NVC0EXADoneComposite(PixmapPtr);
 Bool NVC0EXAUploadSIFC(const char *src, int src_pitch,
 		       PixmapPtr pdPix, int x, int y, int w, int h, int cpp);
@@ -24,6 +24,31 @@
 #define NV_KEPLER   0xe0
 #define NV_MAXWELL  0x110
 
+#define NOUVEAU_TRANSFER_SLOTS 4
+#define NOUVEAU_BO_CACHE_BUCKETS 33
+
+/* pixmap was touched by another channel (copy engine), always wait */
+#define NOUVEAU_FENCE_UNKNOWN 0xffffffff
+
+/* upload size classes, 1KiB to 4MiB */
+#define NOUVEAU_UPLOAD_BUCKETS 13
+
+/* size of the 1D ramp gradients are baked into */
+#define NOUVEAU_GRADIENT_TEXELS 256
+
+/* gradient ramps kept resident in the scratch bo (NV50/NVC0) */
+#define NOUVEAU_GRADIENT_SLOTS 8
+
+/* entries in the method state shadow, must be a power of two */
+#define NOUVEAU_STATE_SIZE 256
+
+/* texture descriptors kept resident in the scratch bo (NVC0) */
+#define NOUVEAU_TEX_SLOTS 30
+
+struct nouveau_bo_cache_entry;
+struct nouveau_slab;
+struct nouveau_glyph_atlas;
+
 struct xf86_platform_device;
 
 /* NV50 */
@@ -62,8 +87,64 @@ typedef struct _NVRec {
     int                 ShadowPitch;
 
     ExaDriverPtr	EXADriverPtr;
+	/* arch hooks, wrapped to track which pixmaps the GPU is using */
+	Bool (*exa_prepare_solid)(PixmapPtr, int, Pixel, Pixel);
+	Bool (*exa_prepare_copy)(PixmapPtr, PixmapPtr, int, int, int, Pixel);
+	Bool (*exa_check_composite)(int, PicturePtr, PicturePtr, PicturePtr);
+	Bool (*exa_prepare_composite)(int, PicturePtr, PicturePtr, PicturePtr,
+				      PixmapPtr, PixmapPtr, PixmapPtr);
+	void (*exa_done_solid)(PixmapPtr);
+	void (*exa_done_copy)(PixmapPtr);
+	void (*exa_done_composite)(PixmapPtr);
+	/* fill a whole box list between PrepareSolid/DoneSolid */
+	void (*exa_solid_boxes)(PixmapPtr, BoxPtr, int);
+	/* one Composite() quad with per-corner src/mask coordinates */
+	void (*exa_composite_affine)(PixmapPtr, int, int, int, int,
+				     const int32_t *, const int32_t *);
+	/* coverage ramp for trapezoid rasterization, see nouveau_exa.c */
+	PicturePtr trap_edge;
+	/* a8 and a8r8g8b8 glyph atlases, see nouveau_exa.c */
+	struct nouveau_glyph_atlas *glyph_atlas[2];
+	/* the mask unit samples the src bounds, see NV50EXAPictBounds() */
+	Bool exa_bounds;
+	/* Composite done as a scaled 2D blit, see nouveau_exa_blit() */
+	Bool exa_blit;
+	struct nouveau_blit {
+		Bool bilinear;
+		int64_t du, dv;		/* 32.32 source step per pixel */
+		int64_t tx, ty;		/* 32.32 source translation */
+		int width, height;
+		/* what the 3D engine needs for the rects that stray outside
+		 * the source, it's only set up once the first one does
+		 */
+		int op;
+		PicturePtr pspict, pdpict;
+		PixmapPtr pspix;
+		Bool ready;
+	} blit;
+	/* pixmap fence sequence of the commands currently being built, and
+	 * the last one the GPU is known to have completed
+	 */
+	uint32_t fence_seq;
+	uint32_t fence_done;
+	/* work queued since the last kick, see NVAccelQueue() */
+	uint32_t kick_pixels;
+	uint32_t kick_ops;
+	CARD32 kick_time;
+	/* last value written to 2D/3D methods, see NVAccelState() */
+	struct {
+		uint32_t key;
+		uint32_t data;
+	} state[NOUVEAU_STATE_SIZE];
+	/* fastest upload path, by [wide][size class] */
+	uint8_t upload_method[2][NOUVEAU_UPLOAD_BUCKETS];
     Bool                exa_force_cp;
     Bool		wfb_enabled;
+    Bool		linear_mirror;
+    Bool		push_stats;
+    const char		*upload_cache;
+    uint64_t		fallback_published;
+    CARD32		fallback_time;
     Bool		tiled_scanout;
     Bool		glx_vblank;
     Bool		has_async_pageflip;
@@ -74,6 +155,11 @@ typedef struct _NVRec {
 
     ScreenBlockHandlerProcPtr BlockHandler;
     CreateScreenResourcesProcPtr CreateScreenResources;
+    CreateGCProcPtr	CreateGC;
+    TrapezoidsProcPtr	Trapezoids;
+    TrianglesProcPtr	Triangles;
+    AddTrapsProcPtr	AddTraps;
+    GlyphsProcPtr	Glyphs;
     CloseScreenProcPtr  CloseScreen;
     void		(*VideoTimerCallback)(ScrnInfoPtr, Time);
     XF86VideoAdaptorPtr	overlayAdaptor;
@@ -95,12 +181,54 @@ typedef struct _NVRec {
 	/* GPU context */
 	struct nouveau_client *client;
 
-	struct nouveau_bo *transfer;
-	CARD32 transfer_offset;
+	/* GART staging ring for UploadToScreen/DownloadFromScreen, a slot
+	 * is only reused once the GPU has retired all transfers from it.
+	 */
+	struct {
+		struct nouveau_bo *bo;
+		CARD32 offset;
+	} transfer[NOUVEAU_TRANSFER_SLOTS];
+	int transfer_slot;
+
+	/* NV50/NVC0 composite rects queued in the transfer ring, waiting
+	 * to be drawn as a single vertex array
+	 */
+	struct nouveau_bo *vtx_bo;
+	int vtx_offset;
+	int vtx_count;
+	/* TIC/TSC cache, and the entry each texture unit is bound to */
+	struct {
+		uint32_t tic[8];
+		uint32_t tsc[8];
+		uint32_t stamp;
+	} tex_slot[NOUVEAU_TEX_SLOTS];
+	uint32_t tex_stamp;
+	unsigned tex_bound[2];
+	Bool tex_dirty;
+
+	/* gradient ramp cache, each slot is GRADIENT(i) in the scratch bo */
+	struct {
+		uint32_t ramp[NOUVEAU_GRADIENT_TEXELS];
+		uint32_t stamp;
+	} gradient_slot[NOUVEAU_GRADIENT_SLOTS];
+	uint32_t gradient_stamp;
+
+	/* recently freed pixmap BOs, bucketed by size */
+	struct nouveau_bo_cache_entry *bo_cache[NOUVEAU_BO_CACHE_BUCKETS];
+	uint64_t bo_cache_size;
+	OsTimerPtr bo_cache_timer;
+
+	/* shared BOs small pixmaps are sub-allocated from */
+	struct nouveau_slab *slabs;
+
+	/* pixmaps with a linear mirror, most recently used first */
+	struct nouveau_pixmap *mirrors;
+	uint64_t mirror_size;
 
 	struct nouveau_object *channel;
 	struct nouveau_pushbuf *pushbuf;
 	struct nouveau_bufctx *bufctx;
+	struct nouveau_push_priv push_priv;
 	struct nouveau_object *notify0;
 	struct nouveau_object *vblank_sem;
 	struct nouveau_object *NvNull;
@@ -192,9 +320,25 @@ typedef struct _NVPortPrivRec {
 #define NOUVEAU_CREATE_PIXMAP_TILED	0x20000000
 #define NOUVEAU_CREATE_PIXMAP_SCANOUT	0x40000000
 
+struct nouveau_slab {
+	struct nouveau_slab *next;
+	struct nouveau_bo *bo;
+	uint32_t slot_size;
+	uint64_t used; /* bitmask of allocated slots */
+};
+
 struct nouveau_pixmap {
 	struct nouveau_bo *bo;
 	Bool shared;
+	Bool reusable; /* bo can go back into the BO cache on destroy */
+	struct nouveau_slab *slab;
+	uint32_t offset; /* of the pixmap within bo, non-zero for slabs */
+	uint32_t rd_seq; /* fence sequence of last GPU read, 0 if idle */
+	uint32_t wr_seq; /* fence sequence of last GPU write, 0 if idle */
+	struct nouveau_bo *mirror; /* linear copy of tiled pixmap, no wfb */
+	Bool mirror_valid;
+	uint32_t mirror_access; /* NOUVEAU_BO_RD/WR while CPU is using it */
+	struct nouveau_pixmap *mirror_next; /* on NVRec::mirrors */
 };
 
 static inline struct nouveau_pixmap *
@@ -211,6 +355,14 @@ nouveau_pixmap_bo(PixmapPtr ppix)
 	return nvpix ? nvpix->bo : NULL;
 }
 
+static inline uint32_t
+nouveau_pixmap_offset(PixmapPtr ppix)
+{
+	struct nouveau_pixmap *nvpix = nouveau_pixmap(ppix);
+
+	return nvpix ? nvpix->offset : 0;
+}
+
 static inline uint32_t
 nv_pitch_align(NVPtr pNv, uint32_t width, int bpp)
 {
@@ -32,6 +32,13 @@
 #include "shader/exasanvc0.fp"
 #include "shader/exas8nvc0.fp"
 #include "shader/exac8nvc0.fp"
+#include "shader/exacsnvc0.fp"
+#include "shader/exacknvc0.fp"
+#include "shader/exav3nvc0.fp"
+#include "shader/exav5nvc0.fp"
+#include "shader/exav7nvc0.fp"
+#include "shader/exarsnvc0.fp"
+#include "shader/exarcnvc0.fp"
 
 #include "shader/xfrm2nve0.vp"
 #include "shader/videonve0.fp"
@@ -42,6 +49,13 @@
 #include "shader/exasanve0.fp"
 #include "shader/exas8nve0.fp"
 #include "shader/exac8nve0.fp"
+#include "shader/exacsnve0.fp"
+#include "shader/exacknve0.fp"
+#include "shader/exav3nve0.fp"
+#include "shader/exav5nve0.fp"
+#include "shader/exav7nve0.fp"
+#include "shader/exarsnve0.fp"
+#include "shader/exarcnve0.fp"
 
 #include "shader/xfrm2nvf0.vp"
 #include "shader/videonvf0.fp"
@@ -52,6 +66,30 @@
 #include "shader/exasanvf0.fp"
 #include "shader/exas8nvf0.fp"
 #include "shader/exac8nvf0.fp"
+#include "shader/exacsnvf0.fp"
+#include "shader/exacknvf0.fp"
+#include "shader/exav3nvf0.fp"
+#include "shader/exav5nvf0.fp"
+#include "shader/exav7nvf0.fp"
+#include "shader/exarsnvf0.fp"
+#include "shader/exarcnvf0.fp"
+
+#include "shader/xfrm2nv110.vp"
+#include "shader/videonv110.fp"
+
+#include "shader/exascnv110.fp"
+#include "shader/exacmnv110.fp"
+#include "shader/exacanv110.fp"
+#include "shader/exasanv110.fp"
+#include "shader/exas8nv110.fp"
+#include "shader/exac8nv110.fp"
+#include "shader/exacsnv110.fp"
+#include "shader/exacknv110.fp"
+#include "shader/exav3nv110.fp"
+#include "shader/exav5nv110.fp"
+#include "shader/exav7nv110.fp"
+#include "shader/exarsnv110.fp"
+#include "shader/exarcnv110.fp"
 
 #define NVC0PushProgram(pNv,addr,code) do {                                    \
 	const unsigned size = sizeof(code) / sizeof(code[0]);                  \
@@ -201,7 +239,6 @@ NVAccelInit2D_NVC0(ScrnInfoPtr pScrn)
 	PUSH_DATA (push, 2);
 	PUSH_DATA (push, 1);
 
-	pNv->currentRop = 0xfffffffa;
 	return TRUE;
 }
 
@@ -223,9 +260,12 @@ NVAccelInit3D_NVC0(ScrnInfoPtr pScrn)
 	} else if (pNv->dev->chipset < 0xf0) {
 		class  = 0xa097;
 		handle = 0x0000906e;
-	} else {
+	} else if (pNv->Architecture < NV_MAXWELL) {
 		class  = 0xa197;
 		handle = 0x0000906e;
+	} else {
+		class  = 0xb097;
+		handle = 0x0000906e;
 	}
 
 	ret = nouveau_object_new(pNv->channel, class, class,
@@ -240,7 +280,8 @@ NVAccelInit3D_NVC0(ScrnInfoPtr pScrn)
 			   "DRM doesn't support sync-to-vblank\n");
 	}
 
-	if (nouveau_pushbuf_space(push, 512, 0, 0) ||
+	/* the shader uploads are most of it, some 2500 dwords */
+	if (nouveau_pushbuf_space(push, 4096, 0, 0) ||
 	    nouveau_pushbuf_refn (push, &(struct nouveau_pushbuf_refn) {
 					pNv->scratch, NOUVEAU_BO_VRAM |
 					NOUVEAU_BO_WR }, 1))
@@ -262,11 +303,11 @@ NVAccelInit3D_NVC0(ScrnInfoPtr pScrn)
 	PUSH_DATA (push, 0);
 
 	BEGIN_NVC0(push, NVC0_3D(VIEWPORT_HORIZ(0)), 2);
-	PUSH_DATA (push, (8192 << 16) | 0);
-	PUSH_DATA (push, (8192 << 16) | 0);
+	PUSH_DATA (push, (NVC0_TEXTURE_MAX << 16) | 0);
+	PUSH_DATA (push, (NVC0_TEXTURE_MAX << 16) | 0);
 	BEGIN_NVC0(push, NVC0_3D(SCREEN_SCISSOR_HORIZ), 2);
-	PUSH_DATA (push, (8192 << 16) | 0);
-	PUSH_DATA (push, (8192 << 16) | 0);
+	PUSH_DATA (push, (NVC0_TEXTURE_MAX << 16) | 0);
+	PUSH_DATA (push, (NVC0_TEXTURE_MAX << 16) | 0);
 	BEGIN_NVC0(push, NVC0_3D(SCISSOR_ENABLE(0)), 1);
 	PUSH_DATA (push, 1);
 	BEGIN_NVC0(push, NVC0_3D(VIEWPORT_TRANSFORM_EN), 1);
@@ -277,11 +318,11 @@ NVAccelInit3D_NVC0(ScrnInfoPtr pScrn)
 	BEGIN_NVC0(push, NVC0_3D(TIC_ADDRESS_HIGH), 3);
 	PUSH_DATA (push, (bo->offset + TIC_OFFSET) >> 32);
 	PUSH_DATA (push, (bo->offset + TIC_OFFSET));
-	PUSH_DATA (push, 15);
+	PUSH_DATA (push, TEX_SLOT(NOUVEAU_TEX_SLOTS) - 1);
 	BEGIN_NVC0(push, NVC0_3D(TSC_ADDRESS_HIGH), 3);
 	PUSH_DATA (push, (bo->offset + TSC_OFFSET) >> 32);
 	PUSH_DATA (push, (bo->offset + TSC_OFFSET));
-	PUSH_DATA (push, 0);
+	PUSH_DATA (push, TEX_SLOT(NOUVEAU_TEX_SLOTS) - 1);
 	BEGIN_NVC0(push, NVC0_3D(LINKED_TSC), 1);
 	PUSH_DATA (push, 1);
 	if (pNv->Architecture < NV_KEPLER) {
@@ -303,6 +344,10 @@ NVAccelInit3D_NVC0(ScrnInfoPtr pScrn)
 		BEGIN_NVC0(push, SUBC_3D(0x2608), 1);
 		PUSH_DATA (push, 1);
 	}
+	memset(pNv->tex_slot, 0, sizeof(pNv->tex_slot));
+	memset(pNv->gradient_slot, 0, sizeof(pNv->gradient_slot));
+	pNv->tex_bound[0] = 0;
+	pNv->tex_bound[1] = 1;
 
 	BEGIN_NVC0(push, NVC0_3D(VERTEX_QUARANTINE_ADDRESS_HIGH), 3);
 	PUSH_DATA (push, (bo->offset + MISC_OFFSET) >> 32);
@@ -321,6 +366,13 @@ NVAccelInit3D_NVC0(ScrnInfoPtr pScrn)
 		NVC0PushProgram(pNv, PFP_S_A8, NVC0FP_Source_A8);
 		NVC0PushProgram(pNv, PFP_C_A8, NVC0FP_Composite_A8);
 		NVC0PushProgram(pNv, PFP_NV12, NVC0FP_NV12);
+		NVC0PushProgram(pNv, PFP_C_SS, NVC0FP_CompositeSolid);
+		NVC0PushProgram(pNv, PFP_C_SM, NVC0FP_CompositeSolidMask);
+		NVC0PushProgram(pNv, PFP_CONV3, NVC0FP_Convolution3x3);
+		NVC0PushProgram(pNv, PFP_CONV5, NVC0FP_Convolution5x5);
+		NVC0PushProgram(pNv, PFP_CONV7, NVC0FP_Convolution7x7);
+		NVC0PushProgram(pNv, PFP_RS, NVC0FP_RadialSource);
+		NVC0PushProgram(pNv, PFP_RC, NVC0FP_RadialComposite);
 
 		BEGIN_NVC0(push, NVC0_3D(MEM_BARRIER), 1);
 		PUSH_DATA (push, 0x1111);
@@ -334,7 +386,15 @@ NVAccelInit3D_NVC0(ScrnInfoPtr pScrn)
 		NVC0PushProgram(pNv, PFP_S_A8, NVE0FP_Source_A8);
 		NVC0PushProgram(pNv, PFP_C_A8, NVE0FP_Composite_A8);
 		NVC0PushProgram(pNv, PFP_NV12, NVE0FP_NV12);
-	} else {
+		NVC0PushProgram(pNv, PFP_C_SS, NVE0FP_CompositeSolid);
+		NVC0PushProgram(pNv, PFP_C_SM, NVE0FP_CompositeSolidMask);
+		NVC0PushProgram(pNv, PFP_CONV3, NVE0FP_Convolution3x3);
+		NVC0PushProgram(pNv, PFP_CONV5, NVE0FP_Convolution5x5);
+		NVC0PushProgram(pNv, PFP_CONV7, NVE0FP_Convolution7x7);
+		NVC0PushProgram(pNv, PFP_RS, NVE0FP_RadialSource);
+		NVC0PushProgram(pNv, PFP_RC, NVE0FP_RadialComposite);
+	} else
+	if (pNv->Architecture < NV_MAXWELL) {
 		NVC0PushProgram(pNv, PVP_PASS, NVF0VP_Transform2);
 		NVC0PushProgram(pNv, PFP_S, NVF0FP_Source);
 		NVC0PushProgram(pNv, PFP_C, NVF0FP_Composite);
@@ -343,6 +403,29 @@ NVAccelInit3D_NVC0(ScrnInfoPtr pScrn)
 		NVC0PushProgram(pNv, PFP_S_A8, NVF0FP_Source_A8);
 		NVC0PushProgram(pNv, PFP_C_A8, NVF0FP_Composite_A8);
 		NVC0PushProgram(pNv, PFP_NV12, NVF0FP_NV12);
+		NVC0PushProgram(pNv, PFP_C_SS, NVF0FP_CompositeSolid);
+		NVC0PushProgram(pNv, PFP_C_SM, NVF0FP_CompositeSolidMask);
+		NVC0PushProgram(pNv, PFP_CONV3, NVF0FP_Convolution3x3);
+		NVC0PushProgram(pNv, PFP_CONV5, NVF0FP_Convolution5x5);
+		NVC0PushProgram(pNv, PFP_CONV7, NVF0FP_Convolution7x7);
+		NVC0PushProgram(pNv, PFP_RS, NVF0FP_RadialSource);
+		NVC0PushProgram(pNv, PFP_RC, NVF0FP_RadialComposite);
+	} else {
+		NVC0PushProgram(pNv, PVP_PASS, NV110VP_Transform2);
+		NVC0PushProgram(pNv, PFP_S, NV110FP_Source);
+		NVC0PushProgram(pNv, PFP_C, NV110FP_Composite);
+		NVC0PushProgram(pNv, PFP_CCA, NV110FP_CAComposite);
+		NVC0PushProgram(pNv, PFP_CCASA, NV110FP_CACompositeSrcAlpha);
+		NVC0PushProgram(pNv, PFP_S_A8, NV110FP_Source_A8);
+		NVC0PushProgram(pNv, PFP_C_A8, NV110FP_Composite_A8);
+		NVC0PushProgram(pNv, PFP_NV12, NV110FP_NV12);
+		NVC0PushProgram(pNv, PFP_C_SS, NV110FP_CompositeSolid);
+		NVC0PushProgram(pNv, PFP_C_SM, NV110FP_CompositeSolidMask);
+		NVC0PushProgram(pNv, PFP_CONV3, NV110FP_Convolution3x3);
+		NVC0PushProgram(pNv, PFP_CONV5, NV110FP_Convolution5x5);
+		NVC0PushProgram(pNv, PFP_CONV7, NV110FP_Convolution7x7);
+		NVC0PushProgram(pNv, PFP_RS, NV110FP_RadialSource);
+		NVC0PushProgram(pNv, PFP_RC, NV110FP_RadialComposite);
 	}
 
 	BEGIN_NVC0(push, NVC0_3D(SP_SELECT(1)), 4);
@@ -365,11 +448,11 @@ NVAccelInit3D_NVC0(ScrnInfoPtr pScrn)
 			 NVC0_3D_SP_SELECT_ENABLE);
 	PUSH_DATA (push, PFP_S);
 	PUSH_DATA (push, 0x00000000);
-	PUSH_DATA (push, 8);
+	PUSH_DATA (push, 16); /* the PFP_CONV programs use 10 */
 	BEGIN_NVC0(push, NVC0_3D(FRAG_COLOR_CLAMP_EN), 1);
 	PUSH_DATA (push, 0x11111111);
 	BEGIN_NVC0(push, NVC0_3D(CB_SIZE), 3);
-	PUSH_DATA (push, 256);
+	PUSH_DATA (push, PFP_DATA_SIZE);
 	PUSH_DATA (push, (bo->offset + PFP_DATA) >> 32);
 	PUSH_DATA (push, (bo->offset + PFP_DATA));
 	BEGIN_NVC0(push, NVC0_3D(CB_BIND(4)), 1);
@@ -29,13 +29,20 @@
 #define TIC_OFFSET  0x02000 /* Texture Image Control */
 #define TSC_OFFSET  0x03000 /* Texture Sampler Control */
 #define SOLID(i)   (0x04000 + (i) * 0x100)
+#define GRADIENT(i) (0x09000 + (i) * 0x400) /* NOUVEAU_GRADIENT_SLOTS */
 #define NTFY_OFFSET 0x08000
 #define SEMA_OFFSET 0x08100
 #define MISC_OFFSET 0x10000
 
-/* vertex/fragment programs */
+/* TIC/TSC entries 0 and 1 belong to Xv, EXA caches descriptors after them */
+#define TEX_SLOT(i) ((i) + 2)
+
+/* vertex/fragment programs, 0x200 bytes each, except the vertex program
+ * which comes after them: the Maxwell one is 0x230 bytes with its header.
+ * The convolution programs follow, the largest is 0xed0 bytes, then the
+ * radial gradient ones.
+ */
 #define SPO       ((pNv->Architecture < NV_KEPLER) ? 0x0000 : 0x0030)
-#define PVP_PASS  (0x0000 + SPO) /* vertex pass-through shader */
 #define PFP_S     (0x0200 + SPO) /* (src) */
 #define PFP_C     (0x0400 + SPO) /* (src IN mask) */
 #define PFP_CCA   (0x0600 + SPO) /* (src IN mask) component-alpha */
@@ -43,6 +50,31 @@
 #define PFP_S_A8  (0x0a00 + SPO) /* (src) a8 rt */
 #define PFP_C_A8  (0x0c00 + SPO) /* (src IN mask) a8 rt - same for CCA/CCASA */
 #define PFP_NV12  (0x0e00 + SPO) /* NV12 YUV->RGB */
+#define PFP_C_SS  (0x5000 + SPO) /* (solid src IN mask), colour in c0 */
+#define PFP_C_SM  (0x5200 + SPO) /* (src IN solid mask), colour in c0 */
+#define PVP_PASS  (0x5400 + SPO) /* vertex pass-through shader */
+#define PFP_CONV3 (0x5800 + SPO) /* (src) convolved, up to 9 taps */
+#define PFP_CONV5 (0x5c00 + SPO) /* (src) convolved, up to 25 taps */
+#define PFP_CONV7 (0x6400 + SPO) /* (src) convolved, up to 49 taps */
+#define PFP_RS    (0x7400 + SPO) /* (radial gradient src) */
+#define PFP_RC    (0x7600 + SPO) /* (radial gradient src IN mask) */
+
+/* FP constant offset of the solid colour, after the Xv csc coefficients */
+#define PFP_SOLID 0x28
+
+/* FP constant offset of the PFP_R* programs' alpha and beta, after the
+ * solid colour, see nouveau_exa_gradient_radial()
+ */
+#define PFP_RADIAL 0x38
+
+/* FP constant offset of the convolution taps, 4 floats each: x and y
+ * offset, weight, unused.  The FP constant buffer is sized for 49.
+ */
+#define PFP_TAPS  0x40
+#define PFP_DATA_SIZE 0x400
+
+/* largest texture/render target, also EXA's pixmap size limit */
+#define NVC0_TEXTURE_MAX 16384
 
 
 #define VTX_ATTR(a, c, t, s)				\
@@ -107,4 +139,23 @@ PUSH_DATAu(struct nouveau_pushbuf *push, struct nouveau_bo *bo,
 	}
 }
 
+/* point a fragment texture unit at a (linked) TIC/TSC entry */
+static __inline__ void
+PUSH_TEXBIND(struct nouveau_pushbuf *push, struct nouveau_bo *bo,
+	     unsigned unit, unsigned entry)
+{
+	if (push->client->device->chipset < 0xe0) {
+		BEGIN_NVC0(push, NVC0_3D(BIND_TIC(4)), 1);
+		PUSH_DATA (push, (entry << 9) | (unit << 1) |
+				 NVC0_3D_BIND_TIC_ACTIVE);
+	} else {
+		BEGIN_NVC0(push, NVC0_3D(CB_SIZE), 5);
+		PUSH_DATA (push, 256);
+		PUSH_DATA (push, (bo->offset + TB_OFFSET) >> 32);
+		PUSH_DATA (push, (bo->offset + TB_OFFSET));
+		PUSH_DATA (push, unit * 4);
+		PUSH_DATA (push, entry);
+	}
+}
+
 #endif
@@ -83,12 +83,12 @@ NVC0EXA2DSurfaceFormat(PixmapPtr ppix, uint32_t *fmt)
 static void NVC0EXASetClip(PixmapPtr ppix, int x, int y, int w, int h)
 {
 	NVC0EXA_LOCALS(ppix);
+	uint32_t clip[4] = { x, y, w, h };
 
-	BEGIN_NVC0(push, NV50_2D(CLIP_X), 4);
-	PUSH_DATA (push, x);
-	PUSH_DATA (push, y);
-	PUSH_DATA (push, w);
-	PUSH_DATA (push, h);
+	if (NVAccelState(pNv, NV50_2D(CLIP_X), 4, clip)) {
+		BEGIN_NVC0(push, NV50_2D(CLIP_X), 4);
+		PUSH_DATAp(push, clip, 4);
+	}
 }
 
 static void
@@ -98,31 +98,39 @@ NVC0EXAAcquireSurface2D(PixmapPtr ppix, int is_src, uint32_t fmt)
 	struct nouveau_bo *bo = nouveau_pixmap_bo(ppix);
 	struct nouveau_pixmap *nvpix = nouveau_pixmap(ppix);
 	int mthd = is_src ? NV50_2D_SRC_FORMAT : NV50_2D_DST_FORMAT;
+	uint64_t offset = bo->offset + nvpix->offset;
+	uint32_t size[4] = { ppix->drawable.width, ppix->drawable.height,
+			     offset >> 32, offset };
 	uint32_t bo_flags;
 
 	bo_flags = nvpix->shared ? NOUVEAU_BO_GART : NOUVEAU_BO_VRAM;
 	bo_flags |= is_src ? NOUVEAU_BO_RD : NOUVEAU_BO_WR;
 
 	if (!nv50_style_tiled_pixmap(ppix)) {
-		BEGIN_NVC0(push, SUBC_2D(mthd), 2);
-		PUSH_DATA (push, fmt);
-		PUSH_DATA (push, 1);
-		BEGIN_NVC0(push, SUBC_2D(mthd + 0x14), 1);
-		PUSH_DATA (push, (uint32_t)exaGetPixmapPitch(ppix));
+		uint32_t linear[2] = { fmt, 1 };
+		uint32_t pitch = exaGetPixmapPitch(ppix);
+
+		if (NVAccelState(pNv, SUBC_2D(mthd), 2, linear)) {
+			BEGIN_NVC0(push, SUBC_2D(mthd), 2);
+			PUSH_DATAp(push, linear, 2);
+		}
+		if (NVAccelState(pNv, SUBC_2D(mthd + 0x14), 1, &pitch)) {
+			BEGIN_NVC0(push, SUBC_2D(mthd + 0x14), 1);
+			PUSH_DATA (push, pitch);
+		}
 	} else {
-		BEGIN_NVC0(push, SUBC_2D(mthd), 5);
-		PUSH_DATA (push, fmt);
-		PUSH_DATA (push, 0);
-		PUSH_DATA (push, bo->config.nvc0.tile_mode);
-		PUSH_DATA (push, 1);
-		PUSH_DATA (push, 0);
+		uint32_t tiled[5] = { fmt, 0, bo->config.nvc0.tile_mode, 1, 0 };
+
+		if (NVAccelState(pNv, SUBC_2D(mthd), 5, tiled)) {
+			BEGIN_NVC0(push, SUBC_2D(mthd), 5);
+			PUSH_DATAp(push, tiled, 5);
+		}
 	}
 
-	BEGIN_NVC0(push, SUBC_2D(mthd + 0x18), 4);
-	PUSH_DATA (push, ppix->drawable.width);
-	PUSH_DATA (push, ppix->drawable.height);
-	PUSH_DATA (push, bo->offset >> 32);
-	PUSH_DATA (push, bo->offset);
+	if (NVAccelState(pNv, SUBC_2D(mthd + 0x18), 4, size)) {
+		BEGIN_NVC0(push, SUBC_2D(mthd + 0x18), 4);
+		PUSH_DATAp(push, size, 4);
+	}
 
 	if (is_src == 0)
 		NVC0EXASetClip(ppix, 0, 0, ppix->drawable.width, ppix->drawable.height);
@@ -134,63 +142,66 @@ static void
 NVC0EXASetPattern(PixmapPtr pdpix, int col0, int col1, int pat0, int pat1)
 {
 	NVC0EXA_LOCALS(pdpix);
+	uint32_t pattern[4] = { col0, col1, pat0, pat1 };
+
+	if (NVAccelState(pNv, NV50_2D(PATTERN_COLOR(0)), 4, pattern)) {
+		BEGIN_NVC0(push, NV50_2D(PATTERN_COLOR(0)), 4);
+		PUSH_DATAp(push, pattern, 4);
+	}
+}
 
-	BEGIN_NVC0(push, NV50_2D(PATTERN_COLOR(0)), 4);
-	PUSH_DATA (push, col0);
-	PUSH_DATA (push, col1);
-	PUSH_DATA (push, pat0);
-	PUSH_DATA (push, pat1);
+static void
+NVC0EXASetOperation(PixmapPtr pdpix, uint32_t operation)
+{
+	NVC0EXA_LOCALS(pdpix);
+
+	if (NVAccelState(pNv, NV50_2D(OPERATION), 1, &operation)) {
+		BEGIN_NVC0(push, NV50_2D(OPERATION), 1);
+		PUSH_DATA (push, operation);
+	}
 }
 
 static void
 NVC0EXASetROP(PixmapPtr pdpix, int alu, Pixel planemask)
 {
 	NVC0EXA_LOCALS(pdpix);
-	int rop;
+	uint32_t format[2] = { 2, 1 };
+	uint32_t rop;
 
 	if (planemask != ~0)
 		rop = NVROP[alu].copy_planemask;
 	else
 		rop = NVROP[alu].copy;
 
-	BEGIN_NVC0(push, NV50_2D(OPERATION), 1);
 	if (alu == GXcopy && EXA_PM_IS_SOLID(&pdpix->drawable, planemask)) {
-		PUSH_DATA (push, NV50_2D_OPERATION_SRCCOPY);
+		NVC0EXASetOperation(pdpix, NV50_2D_OPERATION_SRCCOPY);
 		return;
-	} else {
-		PUSH_DATA (push, NV50_2D_OPERATION_ROP);
 	}
+	NVC0EXASetOperation(pdpix, NV50_2D_OPERATION_ROP);
 
-	BEGIN_NVC0(push, NV50_2D(PATTERN_COLOR_FORMAT), 2);
 	switch (pdpix->drawable.bitsPerPixel) {
-	case  8: PUSH_DATA (push, 3); break;
-	case 15: PUSH_DATA (push, 1); break;
-	case 16: PUSH_DATA (push, 0); break;
+	case  8: format[0] = 3; break;
+	case 15: format[0] = 1; break;
+	case 16: format[0] = 0; break;
 	case 24:
 	case 32:
 	default:
-		 PUSH_DATA (push, 2);
 		 break;
 	}
-	PUSH_DATA (push, 1);
-
-	/* There are 16 ALUs.
-	 * 0-15: copy
-	 * 16-31: copy_planemask
-	 */
+	if (NVAccelState(pNv, NV50_2D(PATTERN_COLOR_FORMAT), 2, format)) {
+		BEGIN_NVC0(push, NV50_2D(PATTERN_COLOR_FORMAT), 2);
+		PUSH_DATAp(push, format, 2);
+	}
 
-	if (!EXA_PM_IS_SOLID(&pdpix->drawable, planemask)) {
-		alu += 16;
+	/* the pattern is only used to apply the planemask */
+	if (!EXA_PM_IS_SOLID(&pdpix->drawable, planemask))
 		NVC0EXASetPattern(pdpix, 0, planemask, ~0, ~0);
-	} else {
-		if (pNv->currentRop > 15)
-			NVC0EXASetPattern(pdpix, ~0, ~0, ~0, ~0);
-	}
+	else
+		NVC0EXASetPattern(pdpix, ~0, ~0, ~0, ~0);
 
-	if (pNv->currentRop != alu) {
+	if (NVAccelState(pNv, NV50_2D(ROP), 1, &rop)) {
 		BEGIN_NVC0(push, NV50_2D(ROP), 1);
 		PUSH_DATA (push, rop);
-		pNv->currentRop = alu;
 	}
 }
 
@@ -198,6 +209,7 @@ Bool
 NVC0EXAPrepareSolid(PixmapPtr pdpix, int alu, Pixel planemask, Pixel fg)
 {
 	NVC0EXA_LOCALS(pdpix);
+	uint32_t draw[3] = { NV50_2D_DRAW_SHAPE_RECTANGLES };
 	uint32_t fmt;
 
 	if (!NVC0EXA2DSurfaceFormat(pdpix, &fmt))
@@ -210,13 +222,15 @@ NVC0EXAPrepareSolid(PixmapPtr pdpix, int alu, Pixel planemask, Pixel fg)
 	NVC0EXAAcquireSurface2D(pdpix, 0, fmt);
 	NVC0EXASetROP(pdpix, alu, planemask);
 
-	BEGIN_NVC0(push, NV50_2D(DRAW_SHAPE), 3);
-	PUSH_DATA (push, NV50_2D_DRAW_SHAPE_RECTANGLES);
-	PUSH_DATA (push, fmt);
-	PUSH_DATA (push, fg);
+	draw[1] = fmt;
+	draw[2] = fg;
+	if (NVAccelState(pNv, NV50_2D(DRAW_SHAPE), 3, draw)) {
+		BEGIN_NVC0(push, NV50_2D(DRAW_SHAPE), 3);
+		PUSH_DATAp(push, draw, 3);
+	}
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		NOUVEAU_FALLBACK("validate\n");
 	}
@@ -225,21 +239,42 @@ NVC0EXAPrepareSolid(PixmapPtr pdpix, int alu, Pixel planemask, Pixel fg)
 }
 
 void
-NVC0EXASolid(PixmapPtr pdpix, int x1, int y1, int x2, int y2)
+NVC0EXASolidBoxes(PixmapPtr pdpix, BoxPtr box, int nbox)
 {
 	NVC0EXA_LOCALS(pdpix);
+	uint32_t pixels = 0;
 
-	if (!PUSH_SPACE(push, 8))
-		return;
+	/* each rect is a pair of points, and there's room for 32 of them
+	 * in a single method group
+	 */
+	while (nbox) {
+		int n = min(nbox, NV50_2D_DRAW_POINT32_X__LEN / 2);
+		int i;
+
+		if (!PUSH_SPACE(push, 1 + n * 4))
+			break;
 
-	BEGIN_NVC0(push, NV50_2D(DRAW_POINT32_X(0)), 4);
-	PUSH_DATA (push, x1);
-	PUSH_DATA (push, y1);
-	PUSH_DATA (push, x2);
-	PUSH_DATA (push, y2);
+		BEGIN_NVC0(push, NV50_2D(DRAW_POINT32_X(0)), n * 4);
+		for (i = 0; i < n; i++, box++) {
+			PUSH_DATA (push, box->x1);
+			PUSH_DATA (push, box->y1);
+			PUSH_DATA (push, box->x2);
+			PUSH_DATA (push, box->y2);
+			pixels += (box->x2 - box->x1) * (box->y2 - box->y1);
+		}
+
+		nbox -= n;
+	}
 
-	if ((x2 - x1) * (y2 - y1) >= 512)
-		PUSH_KICK(push);
+	NVAccelQueue(pNv, pixels);
+}
+
+void
+NVC0EXASolid(PixmapPtr pdpix, int x1, int y1, int x2, int y2)
+{
+	BoxRec box = { x1, y1, x2, y2 };
+
+	NVC0EXASolidBoxes(pdpix, &box, 1);
 }
 
 void
@@ -270,7 +305,7 @@ NVC0EXAPrepareCopy(PixmapPtr pspix, PixmapPtr pdpix, int dx, int dy,
 	NVC0EXASetROP(pdpix, alu, planemask);
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		NOUVEAU_FALLBACK("validate\n");
 	}
@@ -306,8 +341,7 @@ NVC0EXACopy(PixmapPtr pdpix, int srcX , int srcY,
 	PUSH_DATA (push, 0);
 	PUSH_DATA (push, srcY);
 
-	if (width * height >= 512)
-		PUSH_KICK(push);
+	NVAccelQueue(pNv, width * height);
 }
 
 void
@@ -337,8 +371,7 @@ NVC0EXAUploadSIFC(const char *src, int src_pitch,
 	NVC0EXAAcquireSurface2D(pdpix, 0, sifc_fmt);
 	NVC0EXASetClip(pdpix, x, y, w, h);
 
-	BEGIN_NVC0(push, NV50_2D(OPERATION), 1);
-	PUSH_DATA (push, NV50_2D_OPERATION_SRCCOPY);
+	NVC0EXASetOperation(pdpix, NV50_2D_OPERATION_SRCCOPY);
 	BEGIN_NVC0(push, NV50_2D(SIFC_BITMAP_ENABLE), 2);
 	PUSH_DATA (push, 0);
 	PUSH_DATA (push, sifc_fmt);
@@ -355,7 +388,7 @@ NVC0EXAUploadSIFC(const char *src, int src_pitch,
 	PUSH_DATA (push, y);
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push))
+	if (PUSH_VAL(push))
 		goto out;
 
 	while (h--) {
@@ -380,16 +413,19 @@ NVC0EXAUploadSIFC(const char *src, int src_pitch,
 	ret = TRUE;
 out:
 	nouveau_pushbuf_bufctx(push, NULL);
+	/* writes to the front buffer should show up right away */
 	if (pdpix == pScreen->GetScreenPixmap(pScreen))
-		PUSH_KICK(push);
+		NVAccelKick(pNv);
+	else
+		NVAccelQueue(pNv, w * h);
 	return ret;
 }
 
 static Bool
 NVC0EXACheckRenderTarget(PicturePtr ppict)
 {
-	if (ppict->pDrawable->width > 8192 ||
-	    ppict->pDrawable->height > 8192)
+	if (ppict->pDrawable->width > NVC0_TEXTURE_MAX ||
+	    ppict->pDrawable->height > NVC0_TEXTURE_MAX)
 		NOUVEAU_FALLBACK("render target dimensions exceeded %dx%d\n",
 				 ppict->pDrawable->width,
 				 ppict->pDrawable->height);
@@ -419,6 +455,8 @@ NVC0EXARenderTarget(PixmapPtr ppix, PicturePtr ppict)
 {
 	NVC0EXA_LOCALS(ppix);
 	struct nouveau_bo *bo = nouveau_pixmap_bo(ppix);
+	uint64_t offset = bo->offset + nouveau_pixmap_offset(ppix);
+	uint32_t rt[8];
 	unsigned format;
 
 	/*XXX: Scanout buffer not tiled, someone needs to figure it out */
@@ -445,28 +483,76 @@ NVC0EXARenderTarget(PixmapPtr ppix, PicturePtr ppict)
 		NOUVEAU_FALLBACK("invalid picture format\n");
 	}
 
-	BEGIN_NVC0(push, NVC0_3D(RT_ADDRESS_HIGH(0)), 8);
-	PUSH_DATA (push, bo->offset >> 32);
-	PUSH_DATA (push, bo->offset);
-	PUSH_DATA (push, ppix->drawable.width);
-	PUSH_DATA (push, ppix->drawable.height);
-	PUSH_DATA (push, format);
-	PUSH_DATA (push, bo->config.nvc0.tile_mode);
-	PUSH_DATA (push, 0x00000001);
-	PUSH_DATA (push, 0x00000000);
+	rt[0] = offset >> 32;
+	rt[1] = offset;
+	rt[2] = ppix->drawable.width;
+	rt[3] = ppix->drawable.height;
+	rt[4] = format;
+	rt[5] = bo->config.nvc0.tile_mode;
+	rt[6] = 0x00000001;
+	rt[7] = 0x00000000;
+
+	if (NVAccelState(pNv, NVC0_3D(RT_ADDRESS_HIGH(0)), 8, rt)) {
+		BEGIN_NVC0(push, NVC0_3D(RT_ADDRESS_HIGH(0)), 8);
+		PUSH_DATAp(push, rt, 8);
+	}
 	return TRUE;
 }
 
+/* OpenGL and Render disagree on what should be sampled outside an XRGB
+ * texture (with no repeating). Opengl has a hardcoded alpha value of
+ * 1.0, while render expects 0.0.  Without a mask, the mask unit is used
+ * to sample the source's bounds instead, see NVC0EXAPictBounds().  We
+ * assume that clipping is done for untranformed sources.
+ */
+static Bool
+NVC0EXANeedBounds(PicturePtr ppict, PicturePtr pdpict, int op)
+{
+	return NVC0EXABlendOp[op].src_alpha && ppict->pDrawable &&
+	       !ppict->repeat && ppict->transform &&
+	       PICT_FORMAT_A(ppict->format) == 0 &&
+	       PICT_FORMAT_A(pdpict->format) != 0;
+}
+
+/* Convolution filters are applied by a program with a fixed number of
+ * taps, the smallest of 9, 25 or 49 that holds the kernel.  Returns that
+ * number, or 0 if the kernel doesn't fit.
+ */
+static int
+NVC0EXAConvolution(PicturePtr ppict)
+{
+	xFixed *params = ppict->filter_params;
+	int cw, ch;
+
+	if (!ppict->pDrawable || ppict->filter_nparams < 2)
+		return 0;
+
+	cw = xFixedToInt(params[0]);
+	ch = xFixedToInt(params[1]);
+	if (cw <= 0 || ch <= 0 || cw * ch > ppict->filter_nparams - 2)
+		return 0;
+
+	if (cw * ch <= 9)
+		return 9;
+	if (cw * ch <= 25)
+		return 25;
+	if (cw * ch <= 49)
+		return 49;
+	return 0;
+}
+
 static Bool
 NVC0EXACheckTexture(PicturePtr ppict, PicturePtr pdpict, int op)
 {
 	if (ppict->pDrawable) {
-		if (ppict->pDrawable->width > 8192 ||
-		    ppict->pDrawable->height > 8192)
+		if (ppict->pDrawable->width > NVC0_TEXTURE_MAX ||
+		    ppict->pDrawable->height > NVC0_TEXTURE_MAX)
 			NOUVEAU_FALLBACK("texture too large\n");
 	} else {
 		switch (ppict->pSourcePict->type) {
 		case SourcePictTypeSolidFill:
+		case SourcePictTypeLinear:
+		case SourcePictTypeRadial:
 			break;
 		default:
 			NOUVEAU_FALLBACK("pict %d\n", ppict->pSourcePict->type);
@@ -505,20 +591,14 @@ NVC0EXACheckTexture(PicturePtr ppict, PicturePtr pdpict, int op)
 	case PictFilterNearest:
 	case PictFilterBilinear:
 		break;
+	case PictFilterConvolution:
+		if (!NVC0EXAConvolution(ppict))
+			NOUVEAU_FALLBACK("convolution kernel too large\n");
+		break;
 	default:
 		NOUVEAU_FALLBACK("picture filter %d\n", ppict->filter);
 	}
 
-	/* OpenGL and Render disagree on what should be sampled outside an XRGB 
-	 * texture (with no repeating). Opengl has a hardcoded alpha value of 
-	 * 1.0, while render expects 0.0. We assume that clipping is done for 
-	 * untranformed sources.
-	 */
-	if (NVC0EXABlendOp[op].src_alpha && !ppict->repeat &&
-	    ppict->transform && (PICT_FORMAT_A(ppict->format) == 0)
-	    && (PICT_FORMAT_A(pdpict->format) != 0))
-		NOUVEAU_FALLBACK("REPEAT_NONE unsupported for XRGB source\n");
-
 	return TRUE;
 }
 
@@ -529,206 +609,442 @@ NVC0EXACheckTexture(PicturePtr ppict, PicturePtr pdpict, int op)
 	 NV50TIC_0_0_MAP##X3 | NV50TIC_0_0_MAP##X4 |			\
 	 NV50TIC_0_0_FMT_##FMT)
 
+/* TIC/TSC pairs stay resident in the scratch bo after use, so a texture
+ * that's already there only needs binding to the unit.  When there's no
+ * match, the least recently used entry is replaced.
+ */
+static void
+NVC0EXATexture(NVPtr pNv, unsigned unit, const uint32_t *tic,
+	       const uint32_t *tsc)
+{
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+	int i, lru = 0;
+
+	for (i = 0; i < NOUVEAU_TEX_SLOTS; i++) {
+		if (pNv->tex_slot[i].stamp &&
+		    !memcmp(pNv->tex_slot[i].tic, tic, 8 * 4) &&
+		    !memcmp(pNv->tex_slot[i].tsc, tsc, 8 * 4))
+			break;
+		if (pNv->tex_slot[i].stamp < pNv->tex_slot[lru].stamp)
+			lru = i;
+	}
+
+	if (i == NOUVEAU_TEX_SLOTS) {
+		i = lru;
+		memcpy(pNv->tex_slot[i].tic, tic, 8 * 4);
+		memcpy(pNv->tex_slot[i].tsc, tsc, 8 * 4);
+
+		PUSH_DATAu(push, pNv->scratch, TIC_OFFSET + TEX_SLOT(i) * 32, 8);
+		PUSH_DATAp(push, tic, 8);
+		PUSH_DATAu(push, pNv->scratch, TSC_OFFSET + TEX_SLOT(i) * 32, 8);
+		PUSH_DATAp(push, tsc, 8);
+		pNv->tex_dirty = TRUE;
+	}
+
+	pNv->tex_slot[i].stamp = ++pNv->tex_stamp;
+	if (pNv->tex_bound[unit] != TEX_SLOT(i)) {
+		pNv->tex_bound[unit] = TEX_SLOT(i);
+		PUSH_TEXBIND(push, pNv->scratch, unit, TEX_SLOT(i));
+	}
+}
+
+/* the VP's texture coordinate transform and normalisation for a unit */
+static void
+NVC0EXAPictTransform(NVPtr pNv, PicturePtr ppict, unsigned unit,
+		   int width, int height)
+{
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+
+	PUSH_DATAu(push, pNv->scratch, PVP_DATA + (unit * 11 * 4), 11);
+	if (ppict->transform) {
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[0][0]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[0][1]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[0][2]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[1][0]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[1][1]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[1][2]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[2][0]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[2][1]));
+		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[2][2]));
+	} else {
+		PUSH_DATAf(push, 1.0);
+		PUSH_DATAf(push, 0.0);
+		PUSH_DATAf(push, 0.0);
+		PUSH_DATAf(push, 0.0);
+		PUSH_DATAf(push, 1.0);
+		PUSH_DATAf(push, 0.0);
+		PUSH_DATAf(push, 0.0);
+		PUSH_DATAf(push, 0.0);
+		PUSH_DATAf(push, 1.0);
+	}
+	PUSH_DATAf(push, 1.0 / width);
+	PUSH_DATAf(push, 1.0 / height);
+}
+
 static Bool
 NVC0EXAPictSolid(NVPtr pNv, PicturePtr ppict, unsigned unit)
 {
 	uint64_t offset = pNv->scratch->offset + SOLID(unit);
 	struct nouveau_pushbuf *push = pNv->pushbuf;
+	uint32_t tic[8] = {
+		_(B_C0, G_C1, R_C2, A_C3, 8_8_8_8),
+		offset,
+		(offset >> 32) | 0xd005d000,
+		0x00300000,
+		0x00000001,
+		0x00010001,
+		0x03000000,
+		0x00000000,
+	};
+	uint32_t tsc[8] = {
+		NV50TSC_1_0_WRAPS_REPEAT |
+		NV50TSC_1_0_WRAPT_REPEAT |
+		NV50TSC_1_0_WRAPR_REPEAT | 0x00024000,
+		NV50TSC_1_1_MAGF_NEAREST |
+		NV50TSC_1_1_MINF_NEAREST |
+		NV50TSC_1_1_MIPF_NONE,
+	};
 
 	PUSH_DATAu(push, pNv->scratch, SOLID(unit), 1);
 	PUSH_DATA (push, ppict->pSourcePict->solidFill.color);
-	PUSH_DATAu(push, pNv->scratch, TIC_OFFSET + (unit * 32), 8);
-	PUSH_DATA (push, _(B_C0, G_C1, R_C2, A_C3, 8_8_8_8));
-	PUSH_DATA (push,  offset);
-	PUSH_DATA (push, (offset >> 32) | 0xd005d000);
-	PUSH_DATA (push, 0x00300000);
-	PUSH_DATA (push, 0x00000001);
-	PUSH_DATA (push, 0x00010001);
-	PUSH_DATA (push, 0x03000000);
-	PUSH_DATA (push, 0x00000000);
-	PUSH_DATAu(push, pNv->scratch, TSC_OFFSET + (unit * 32), 8);
-	PUSH_DATA (push, NV50TSC_1_0_WRAPS_REPEAT |
-			 NV50TSC_1_0_WRAPT_REPEAT |
-			 NV50TSC_1_0_WRAPR_REPEAT | 0x00024000);
-	PUSH_DATA (push, NV50TSC_1_1_MAGF_NEAREST |
-			 NV50TSC_1_1_MINF_NEAREST |
-			 NV50TSC_1_1_MIPF_NONE);
-	PUSH_DATA (push, 0x00000000);
-	PUSH_DATA (push, 0x00000000);
-	PUSH_DATA (push, 0x00000000);
-	PUSH_DATA (push, 0x00000000);
-	PUSH_DATA (push, 0x00000000);
-	PUSH_DATA (push, 0x00000000);
-
+	NVC0EXATexture(pNv, unit, tic, tsc);
 	return TRUE;
 }
 
+/* an opaque texel stretched over the source picture, with the same
+ * transform, reads back as 0 outside of it
+ */
+static void
+NVC0EXAPictBounds(NVPtr pNv, PixmapPtr ppix, PicturePtr ppict, unsigned unit)
+{
+	uint64_t offset = pNv->scratch->offset + SOLID(unit);
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+	uint32_t tic[8] = {
+		_(B_C0, G_C1, R_C2, A_C3, 8_8_8_8),
+		offset,
+		(offset >> 32) | 0xd005d000,
+		0x00300000,
+		0x00000001,
+		0x00010001,
+		0x03000000,
+		0x00000000,
+	};
+	uint32_t tsc[8] = {
+		NV50TSC_1_0_WRAPS_CLAMP_TO_BORDER |
+		NV50TSC_1_0_WRAPT_CLAMP_TO_BORDER |
+		NV50TSC_1_0_WRAPR_CLAMP_TO_BORDER | 0x00024000,
+		NV50TSC_1_1_MAGF_NEAREST |
+		NV50TSC_1_1_MINF_NEAREST |
+		NV50TSC_1_1_MIPF_NONE,
+	};
+
+	PUSH_DATAu(push, pNv->scratch, SOLID(unit), 1);
+	PUSH_DATA (push, 0xffffffff);
+	NVC0EXATexture(pNv, unit, tic, tsc);
+	NVC0EXAPictTransform(pNv, ppict, unit, ppix->drawable.width,
+			     ppix->drawable.height);
+}
+
+/* the PFP_C_SS/PFP_C_SM programs read the solid colour from the FP
+ * constants, no texture descriptors or cache flushes are needed for it
+ */
+static void
+NVC0EXAPictConst(NVPtr pNv, PicturePtr ppict)
+{
+	uint32_t color = ppict->pSourcePict->solidFill.color;
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+
+	BEGIN_NVC0(push, NVC0_3D(CB_SIZE), 3);
+	PUSH_DATA (push, 256);
+	PUSH_DATA (push, (pNv->scratch->offset + PFP_DATA) >> 32);
+	PUSH_DATA (push, (pNv->scratch->offset + PFP_DATA));
+	BEGIN_NVC0(push, NVC0_3D(CB_POS), 5);
+	PUSH_DATA (push, PFP_SOLID);
+	PUSH_DATAf(push, ((color >> 16) & 0xff) / 255.0);
+	PUSH_DATAf(push, ((color >>  8) & 0xff) / 255.0);
+	PUSH_DATAf(push, ((color >>  0) & 0xff) / 255.0);
+	PUSH_DATAf(push, ((color >> 24) & 0xff) / 255.0);
+}
+
+/* Each tap of the PFP_CONV programs is an offset from the sample point,
+ * after the projective divide, and its weight.  As pixman, the kernel
+ * starts half its size before the sample point, taps past its end weigh
+ * nothing.  Untransformed sample points fall on texel edges there, the
+ * small bias keeps them on the texel pixman picks.
+ */
+static uint32_t
+NVC0EXAPictTaps(NVPtr pNv, PixmapPtr ppix, PicturePtr ppict)
+{
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+	xFixed *weight = ppict->filter_params + 2;
+	int cw = xFixedToInt(ppict->filter_params[0]);
+	int ch = xFixedToInt(ppict->filter_params[1]);
+	int taps = NVC0EXAConvolution(ppict);
+	float sx = 1.0 / ppix->drawable.width;
+	float sy = 1.0 / ppix->drawable.height;
+	int i;
+
+	BEGIN_NVC0(push, NVC0_3D(CB_SIZE), 3);
+	PUSH_DATA (push, PFP_DATA_SIZE);
+	PUSH_DATA (push, (pNv->scratch->offset + PFP_DATA) >> 32);
+	PUSH_DATA (push, (pNv->scratch->offset + PFP_DATA));
+	BEGIN_NVC0(push, NVC0_3D(CB_POS), 1 + taps * 4);
+	PUSH_DATA (push, PFP_TAPS);
+	for (i = 0; i < taps; i++) {
+		if (i < cw * ch) {
+			PUSH_DATAf(push, (i % cw - cw / 2.0 + 1 / 256.0) * sx);
+			PUSH_DATAf(push, (i / cw - ch / 2.0 + 1 / 256.0) * sy);
+			PUSH_DATAf(push, xFixedToFloat(weight[i]));
+		} else {
+			PUSH_DATAf(push, 0.0);
+			PUSH_DATAf(push, 0.0);
+			PUSH_DATAf(push, 0.0);
+		}
+		PUSH_DATAf(push, 0.0);
+	}
+
+	if (taps == 9)
+		return PFP_CONV3;
+	if (taps == 25)
+		return PFP_CONV5;
+	return PFP_CONV7;
+}
+
+static Bool
+NVC0EXAPictIsSolid(PicturePtr ppict)
+{
+	return !ppict->pDrawable &&
+	       ppict->pSourcePict->type == SourcePictTypeSolidFill;
+}
+
+static Bool
+NVC0EXAPictIsRadial(PicturePtr ppict)
+{
+	return !ppict->pDrawable &&
+	       ppict->pSourcePict->type == SourcePictTypeRadial;
+}
+
 static Bool
 NVC0EXAPictGradient(NVPtr pNv, PicturePtr ppict, unsigned unit)
 {
-	return FALSE;
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+	uint32_t ramp[NOUVEAU_GRADIENT_TEXELS];
+	uint32_t tic[8] = {
+		_(B_C0, G_C1, R_C2, A_C3, 8_8_8_8),
+		0x00000000,
+		0xd005d000,
+		0x00300000,
+		(1 << 31) | NOUVEAU_GRADIENT_TEXELS,
+		0x00010001,
+		0x03000000,
+		0x00000000,
+	};
+	uint32_t tsc[8] = {
+		0,
+		NV50TSC_1_1_MAGF_NEAREST |
+		NV50TSC_1_1_MINF_NEAREST |
+		NV50TSC_1_1_MIPF_NONE,
+	};
+	uint64_t offset;
+	float m[9], k[2];
+	Bool upload;
+	int i, slot;
+
+	if (!nouveau_exa_gradient(ppict, ramp, m, k))
+		NOUVEAU_FALLBACK("degenerate gradient\n");
+
+	slot = nouveau_exa_gradient_slot(pNv, ramp, &upload);
+	offset = pNv->scratch->offset + GRADIENT(slot);
+	if (upload) {
+		PUSH_DATAu(push, pNv->scratch, GRADIENT(slot),
+			   NOUVEAU_GRADIENT_TEXELS);
+		PUSH_DATAp(push, ramp, NOUVEAU_GRADIENT_TEXELS);
+	}
+	tic[1] = offset;
+	tic[2] |= offset >> 32;
+
+	if (ppict->repeat) {
+		switch (ppict->repeatType) {
+		case RepeatPad:
+			tsc[0] = 0x00024000 |
+				 NV50TSC_1_0_WRAPS_CLAMP_TO_EDGE |
+				 NV50TSC_1_0_WRAPT_CLAMP_TO_EDGE |
+				 NV50TSC_1_0_WRAPR_CLAMP_TO_EDGE;
+			break;
+		case RepeatReflect:
+			tsc[0] = 0x00024000 |
+				 NV50TSC_1_0_WRAPS_MIRROR_REPEAT |
+				 NV50TSC_1_0_WRAPT_CLAMP_TO_EDGE |
+				 NV50TSC_1_0_WRAPR_CLAMP_TO_EDGE;
+			break;
+		case RepeatNormal:
+		default:
+			tsc[0] = 0x00024000 |
+				 NV50TSC_1_0_WRAPS_REPEAT |
+				 NV50TSC_1_0_WRAPT_CLAMP_TO_EDGE |
+				 NV50TSC_1_0_WRAPR_CLAMP_TO_EDGE;
+			break;
+		}
+	} else {
+		tsc[0] = 0x00024000 |
+			 NV50TSC_1_0_WRAPS_CLAMP_TO_BORDER |
+			 NV50TSC_1_0_WRAPT_CLAMP_TO_EDGE |
+			 NV50TSC_1_0_WRAPR_CLAMP_TO_EDGE;
+	}
+	NVC0EXATexture(pNv, unit, tic, tsc);
+
+	PUSH_DATAu(push, pNv->scratch, PVP_DATA + (unit * 11 * 4), 11);
+	for (i = 0; i < 9; i++)
+		PUSH_DATAf(push, m[i]);
+	PUSH_DATAf(push, 1.0);
+	PUSH_DATAf(push, 1.0);
+
+	if (NVC0EXAPictIsRadial(ppict)) {
+		BEGIN_NVC0(push, NVC0_3D(CB_SIZE), 3);
+		PUSH_DATA (push, 256);
+		PUSH_DATA (push, (pNv->scratch->offset + PFP_DATA) >> 32);
+		PUSH_DATA (push, (pNv->scratch->offset + PFP_DATA));
+		BEGIN_NVC0(push, NVC0_3D(CB_POS), 3);
+		PUSH_DATA (push, PFP_RADIAL);
+		PUSH_DATAf(push, k[0]);
+		PUSH_DATAf(push, k[1]);
+	}
+	return TRUE;
 }
 
 static Bool
 NVC0EXAPictTexture(NVPtr pNv, PixmapPtr ppix, PicturePtr ppict, unsigned unit)
 {
 	struct nouveau_bo *bo = nouveau_pixmap_bo(ppix);
+	uint64_t offset = bo->offset + nouveau_pixmap_offset(ppix);
 	struct nouveau_pushbuf *push = pNv->pushbuf;
+	uint32_t tic[8], tsc[8] = { 0 };
 
 	/*XXX: Scanout buffer not tiled, someone needs to figure it out */
 	if (!nv50_style_tiled_pixmap(ppix))
 		NOUVEAU_FALLBACK("pixmap is scanout buffer\n");
 
 	PUSH_REFN (push, bo, NOUVEAU_BO_VRAM | NOUVEAU_BO_RD);
-	PUSH_DATAu(push, pNv->scratch, TIC_OFFSET + (unit * 32), 8);
 	switch (ppict->format) {
 	case PICT_a8r8g8b8:
-		PUSH_DATA (push, _(B_C0, G_C1, R_C2, A_C3, 8_8_8_8));
+		tic[0] = _(B_C0, G_C1, R_C2, A_C3, 8_8_8_8);
 		break;
 	case PICT_a8b8g8r8:
-		PUSH_DATA (push, _(R_C0, G_C1, B_C2, A_C3, 8_8_8_8));
+		tic[0] = _(R_C0, G_C1, B_C2, A_C3, 8_8_8_8);
 		break;
 	case PICT_x8r8g8b8:
-		PUSH_DATA (push, _(B_C0, G_C1, R_C2, A_ONE, 8_8_8_8));
+		tic[0] = _(B_C0, G_C1, R_C2, A_ONE, 8_8_8_8);
 		break;
 	case PICT_x8b8g8r8:
-		PUSH_DATA (push, _(R_C0, G_C1, B_C2, A_ONE, 8_8_8_8));
+		tic[0] = _(R_C0, G_C1, B_C2, A_ONE, 8_8_8_8);
 		break;
 	case PICT_r5g6b5:
-		PUSH_DATA (push, _(B_C0, G_C1, R_C2, A_ONE, 5_6_5));
+		tic[0] = _(B_C0, G_C1, R_C2, A_ONE, 5_6_5);
 		break;
 	case PICT_a8:
-		PUSH_DATA (push, _(A_C0, B_ZERO, G_ZERO, R_ZERO, 8));
+		tic[0] = _(A_C0, B_ZERO, G_ZERO, R_ZERO, 8);
 		break;
 	case PICT_x1r5g5b5:
-		PUSH_DATA (push, _(B_C0, G_C1, R_C2, A_ONE, 1_5_5_5));
+		tic[0] = _(B_C0, G_C1, R_C2, A_ONE, 1_5_5_5);
 		break;
 	case PICT_x1b5g5r5:
-		PUSH_DATA (push, _(R_C0, G_C1, B_C2, A_ONE, 1_5_5_5));
+		tic[0] = _(R_C0, G_C1, B_C2, A_ONE, 1_5_5_5);
 		break;
 	case PICT_a1r5g5b5:
-		PUSH_DATA (push, _(B_C0, G_C1, R_C2, A_C3, 1_5_5_5));
+		tic[0] = _(B_C0, G_C1, R_C2, A_C3, 1_5_5_5);
 		break;
 	case PICT_a1b5g5r5:
-		PUSH_DATA (push, _(R_C0, G_C1, B_C2, A_C3, 1_5_5_5));
+		tic[0] = _(R_C0, G_C1, B_C2, A_C3, 1_5_5_5);
 		break;
 	case PICT_b5g6r5:
-		PUSH_DATA (push, _(R_C0, G_C1, B_C2, A_ONE, 5_6_5));
+		tic[0] = _(R_C0, G_C1, B_C2, A_ONE, 5_6_5);
 		break;
 	case PICT_b8g8r8x8:
-		PUSH_DATA (push, _(A_ONE, R_C1, G_C2, B_C3, 8_8_8_8));
+		tic[0] = _(A_ONE, R_C1, G_C2, B_C3, 8_8_8_8);
 		break;
 	case PICT_b8g8r8a8:
-		PUSH_DATA (push, _(A_C0, R_C1, G_C2, B_C3, 8_8_8_8));
+		tic[0] = _(A_C0, R_C1, G_C2, B_C3, 8_8_8_8);
 		break;
 	case PICT_a2b10g10r10:
-		PUSH_DATA (push, _(R_C0, G_C1, B_C2, A_C3, 2_10_10_10));
+		tic[0] = _(R_C0, G_C1, B_C2, A_C3, 2_10_10_10);
 		break;
 	case PICT_x2b10g10r10:
-		PUSH_DATA (push, _(R_C0, G_C1, B_C2, A_ONE, 2_10_10_10));
+		tic[0] = _(R_C0, G_C1, B_C2, A_ONE, 2_10_10_10);
 		break;
 	case PICT_x2r10g10b10:
-		PUSH_DATA (push, _(B_C0, G_C1, R_C2, A_ONE, 2_10_10_10));
+		tic[0] = _(B_C0, G_C1, R_C2, A_ONE, 2_10_10_10);
 		break;
 	case PICT_a2r10g10b10:
-		PUSH_DATA (push, _(B_C0, G_C1, R_C2, A_C3, 2_10_10_10));
+		tic[0] = _(B_C0, G_C1, R_C2, A_C3, 2_10_10_10);
 		break;
 	case PICT_x4r4g4b4:
-		PUSH_DATA (push, _(B_C0, G_C1, R_C2, A_ONE, 4_4_4_4));
+		tic[0] = _(B_C0, G_C1, R_C2, A_ONE, 4_4_4_4);
 		break;
 	case PICT_x4b4g4r4:
-		PUSH_DATA (push, _(R_C0, G_C1, B_C2, A_ONE, 4_4_4_4));
+		tic[0] = _(R_C0, G_C1, B_C2, A_ONE, 4_4_4_4);
 		break;
 	case PICT_a4r4g4b4:
-		PUSH_DATA (push, _(B_C0, G_C1, R_C2, A_C3, 4_4_4_4));
+		tic[0] = _(B_C0, G_C1, R_C2, A_C3, 4_4_4_4);
 		break;
 	case PICT_a4b4g4r4:
-		PUSH_DATA (push, _(R_C0, G_C1, B_C2, A_C3, 4_4_4_4));
+		tic[0] = _(R_C0, G_C1, B_C2, A_C3, 4_4_4_4);
 		break;
 	default:
 		NOUVEAU_FALLBACK("invalid picture format, this SHOULD NOT HAPPEN. Expect trouble.\n");
 	}
 #undef _
 
-	PUSH_DATA (push, bo->offset);
-	PUSH_DATA (push, (bo->offset >> 32) |
-			 (bo->config.nvc0.tile_mode << 18) |
-			 0xd0005000);
-	PUSH_DATA (push, 0x00300000);
-	PUSH_DATA (push, (1 << 31) | ppix->drawable.width);
-	PUSH_DATA (push, (1 << 16) | ppix->drawable.height);
-	PUSH_DATA (push, 0x03000000);
-	PUSH_DATA (push, 0x00000000);
-
-	PUSH_DATAu(push, pNv->scratch, TSC_OFFSET + (unit * 32), 8);
+	tic[1] = offset;
+	tic[2] = (offset >> 32) | (bo->config.nvc0.tile_mode << 18) |
+		 0xd0005000;
+	tic[3] = 0x00300000;
+	tic[4] = (1 << 31) | ppix->drawable.width;
+	tic[5] = (1 << 16) | ppix->drawable.height;
+	tic[6] = 0x03000000;
+	tic[7] = 0x00000000;
+
 	if (ppict->repeat) {
 		switch (ppict->repeatType) {
 		case RepeatPad:
-			PUSH_DATA (push, 0x00024000 |
-					 NV50TSC_1_0_WRAPS_CLAMP_TO_EDGE |
-					 NV50TSC_1_0_WRAPT_CLAMP_TO_EDGE |
-					 NV50TSC_1_0_WRAPR_CLAMP_TO_EDGE);
+			tsc[0] = 0x00024000 |
+				 NV50TSC_1_0_WRAPS_CLAMP_TO_EDGE |
+				 NV50TSC_1_0_WRAPT_CLAMP_TO_EDGE |
+				 NV50TSC_1_0_WRAPR_CLAMP_TO_EDGE;
 			break;
 		case RepeatReflect:
-			PUSH_DATA (push, 0x00024000 |
-					 NV50TSC_1_0_WRAPS_MIRROR_REPEAT |
-					 NV50TSC_1_0_WRAPT_MIRROR_REPEAT |
-					 NV50TSC_1_0_WRAPR_MIRROR_REPEAT);
+			tsc[0] = 0x00024000 |
+				 NV50TSC_1_0_WRAPS_MIRROR_REPEAT |
+				 NV50TSC_1_0_WRAPT_MIRROR_REPEAT |
+				 NV50TSC_1_0_WRAPR_MIRROR_REPEAT;
 			break;
 		case RepeatNormal:
 		default:
-			PUSH_DATA (push, 0x00024000 |
-					 NV50TSC_1_0_WRAPS_REPEAT |
-					 NV50TSC_1_0_WRAPT_REPEAT |
-					 NV50TSC_1_0_WRAPR_REPEAT);
+			tsc[0] = 0x00024000 |
+				 NV50TSC_1_0_WRAPS_REPEAT |
+				 NV50TSC_1_0_WRAPT_REPEAT |
+				 NV50TSC_1_0_WRAPR_REPEAT;
 			break;
 		}
 	} else {
-		PUSH_DATA (push, 0x00024000 |
-				 NV50TSC_1_0_WRAPS_CLAMP_TO_BORDER |
-				 NV50TSC_1_0_WRAPT_CLAMP_TO_BORDER |
-				 NV50TSC_1_0_WRAPR_CLAMP_TO_BORDER);
+		tsc[0] = 0x00024000 |
+			 NV50TSC_1_0_WRAPS_CLAMP_TO_BORDER |
+			 NV50TSC_1_0_WRAPT_CLAMP_TO_BORDER |
+			 NV50TSC_1_0_WRAPR_CLAMP_TO_BORDER;
 	}
 	if (ppict->filter == PictFilterBilinear) {
-		PUSH_DATA (push, NV50TSC_1_1_MAGF_LINEAR |
-				 NV50TSC_1_1_MINF_LINEAR |
-				 NV50TSC_1_1_MIPF_NONE);
+		tsc[1] = NV50TSC_1_1_MAGF_LINEAR |
+			 NV50TSC_1_1_MINF_LINEAR |
+			 NV50TSC_1_1_MIPF_NONE;
 	} else {
-		PUSH_DATA (push, NV50TSC_1_1_MAGF_NEAREST |
-				 NV50TSC_1_1_MINF_NEAREST |
-				 NV50TSC_1_1_MIPF_NONE);
+		tsc[1] = NV50TSC_1_1_MAGF_NEAREST |
+			 NV50TSC_1_1_MINF_NEAREST |
+			 NV50TSC_1_1_MIPF_NONE;
 	}
-	PUSH_DATA (push, 0x00000000);
-	PUSH_DATA (push, 0x00000000);
-	PUSH_DATA (push, 0x00000000);
-	PUSH_DATA (push, 0x00000000);
-	PUSH_DATA (push, 0x00000000);
-	PUSH_DATA (push, 0x00000000);
 
-	PUSH_DATAu(push, pNv->scratch, PVP_DATA + (unit * 11 * 4), 11);
-	if (ppict->transform) {
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[0][0]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[0][1]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[0][2]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[1][0]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[1][1]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[1][2]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[2][0]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[2][1]));
-		PUSH_DATAf(push, xFixedToFloat(ppict->transform->matrix[2][2]));
-	} else {
-		PUSH_DATAf(push, 1.0);
-		PUSH_DATAf(push, 0.0);
-		PUSH_DATAf(push, 0.0);
-		PUSH_DATAf(push, 0.0);
-		PUSH_DATAf(push, 1.0);
-		PUSH_DATAf(push, 0.0);
-		PUSH_DATAf(push, 0.0);
-		PUSH_DATAf(push, 0.0);
-		PUSH_DATAf(push, 1.0);
-	}
-	PUSH_DATAf(push, 1.0 / ppix->drawable.width);
-	PUSH_DATAf(push, 1.0 / ppix->drawable.height);
+	NVC0EXATexture(pNv, unit, tic, tsc);
+
+	NVC0EXAPictTransform(pNv, ppict, unit, ppix->drawable.width,
+			     ppix->drawable.height);
 	return TRUE;
 }
 
@@ -742,6 +1058,7 @@ NVC0EXAPicture(NVPtr pNv, PixmapPtr ppix, PicturePtr ppict, int unit)
 	case SourcePictTypeSolidFill:
 		return NVC0EXAPictSolid(pNv, ppict, unit);
 	case SourcePictTypeLinear:
+	case SourcePictTypeRadial:
 		return NVC0EXAPictGradient(pNv, ppict, unit);
 	default:
 		break;
@@ -762,8 +1079,9 @@ NVC0EXABlend(PixmapPtr ppix, PicturePtr ppict, int op, int component_alpha)
 {
 	NVC0EXA_LOCALS(ppix);
 	struct nvc0_blend_op *b = &NVC0EXABlendOp[op];
-	unsigned sblend = b->src_blend;
-	unsigned dblend = b->dst_blend;
+	uint32_t sblend = b->src_blend;
+	uint32_t dblend = b->dst_blend;
+	uint32_t enable;
 
 	if (b->dst_alpha) {
 		if (!PICT_FORMAT_A(ppict->format)) {
@@ -783,20 +1101,26 @@ NVC0EXABlend(PixmapPtr ppix, PicturePtr ppict, int op, int component_alpha)
 			dblend = BF(ONE_MINUS_SRC_COLOR);
 	}
 
-	if (sblend == BF(ONE) && dblend == BF(ZERO)) {
-		BEGIN_NVC0(push, NVC0_3D(BLEND_ENABLE(0)), 1);
-		PUSH_DATA (push, 0);
-	} else {
+	enable = !(sblend == BF(ONE) && dblend == BF(ZERO));
+	if (NVAccelState(pNv, NVC0_3D(BLEND_ENABLE(0)), 1, &enable)) {
 		BEGIN_NVC0(push, NVC0_3D(BLEND_ENABLE(0)), 1);
-		PUSH_DATA (push, 1);
-		BEGIN_NVC0(push, NVC0_3D(BLEND_EQUATION_RGB), 5);
-		PUSH_DATA (push, NVC0_3D_BLEND_EQUATION_RGB_FUNC_ADD);
-		PUSH_DATA (push, sblend);
-		PUSH_DATA (push, dblend);
-		PUSH_DATA (push, NVC0_3D_BLEND_EQUATION_ALPHA_FUNC_ADD);
-		PUSH_DATA (push, sblend);
-		BEGIN_NVC0(push, NVC0_3D(BLEND_FUNC_DST_ALPHA), 1);
-		PUSH_DATA (push, dblend);
+		PUSH_DATA (push, enable);
+	}
+
+	if (enable) {
+		uint32_t func[5] = { NVC0_3D_BLEND_EQUATION_RGB_FUNC_ADD,
+				     sblend, dblend,
+				     NVC0_3D_BLEND_EQUATION_ALPHA_FUNC_ADD,
+				     sblend };
+
+		if (NVAccelState(pNv, NVC0_3D(BLEND_EQUATION_RGB), 5, func)) {
+			BEGIN_NVC0(push, NVC0_3D(BLEND_EQUATION_RGB), 5);
+			PUSH_DATAp(push, func, 5);
+		}
+		if (NVAccelState(pNv, NVC0_3D(BLEND_FUNC_DST_ALPHA), 1, &dblend)) {
+			BEGIN_NVC0(push, NVC0_3D(BLEND_FUNC_DST_ALPHA), 1);
+			PUSH_DATA (push, dblend);
+		}
 	}
 }
 
@@ -813,7 +1137,36 @@ NVC0EXACheckComposite(int op,
 	if (!NVC0EXACheckTexture(pspict, pdpict, op))
 		NOUVEAU_FALLBACK("src picture invalid\n");
 
+	/* the convolution programs sample the source alone, and can't tell
+	 * texels outside an XRGB one from the border
+	 */
+	if (pspict->filter == PictFilterConvolution) {
+		if (pmpict)
+			NOUVEAU_FALLBACK("convolution with a mask\n");
+		if (pdpict->format == PICT_a8)
+			NOUVEAU_FALLBACK("convolution to a8\n");
+		if (!pspict->repeat && !PICT_FORMAT_A(pspict->format))
+			NOUVEAU_FALLBACK("convolution of XRGB without repeat\n");
+	}
+
+	/* the PFP_R* programs only take a radial gradient as the source,
+	 * alone or IN a plain mask
+	 */
+	if (NVC0EXAPictIsRadial(pspict)) {
+		if (pdpict->format == PICT_a8)
+			NOUVEAU_FALLBACK("radial gradient to a8\n");
+		if (pmpict && pmpict->componentAlpha &&
+		    PICT_FORMAT_RGB(pmpict->format))
+			NOUVEAU_FALLBACK("radial gradient with component-alpha\n");
+	}
+
 	if (pmpict) {
+		if (pmpict->filter == PictFilterConvolution)
+			NOUVEAU_FALLBACK("convolution filtered mask\n");
+
+		if (NVC0EXAPictIsRadial(pmpict))
+			NOUVEAU_FALLBACK("radial gradient mask\n");
+
 		if (pmpict->componentAlpha &&
 		    PICT_FORMAT_RGB(pmpict->format) &&
 		    NVC0EXABlendOp[op].src_alpha &&
@@ -822,20 +1175,73 @@ NVC0EXACheckComposite(int op,
 
 		if (!NVC0EXACheckTexture(pmpict, pdpict, op))
 			NOUVEAU_FALLBACK("mask picture invalid\n");
+
+		if (NVC0EXANeedBounds(pspict, pdpict, op) ||
+		    NVC0EXANeedBounds(pmpict, pdpict, op))
+			NOUVEAU_FALLBACK("REPEAT_NONE unsupported for XRGB source\n");
 	}
 
 	return TRUE;
 }
 
-Bool
-NVC0EXAPrepareComposite(int op,
-			PicturePtr pspict, PicturePtr pmpict, PicturePtr pdpict,
-			PixmapPtr pspix, PixmapPtr pmpix, PixmapPtr pdpix)
+/* Composite rects are queued as quads in a GART buffer and drawn with a
+ * single vertex array per batch, rather than being pushed one vertex
+ * attribute at a time.
+ */
+#define NVC0_COMPOSITE_BATCH 256
+
+struct nvc0_vtx {
+	int32_t dx, dy;
+	int32_t sx, sy;
+	int32_t mx, my;
+};
+
+static const uint32_t
+NVC0EXAVertexFormat[] = {
+	NVC0_3D_VERTEX_ATTRIB_FORMAT_TYPE_SSCALED |
+	NVC0_3D_VERTEX_ATTRIB_FORMAT_SIZE_32_32 |
+	(offsetof(struct nvc0_vtx, dx) << NVC0_3D_VERTEX_ATTRIB_FORMAT_OFFSET__SHIFT),
+	NVC0_3D_VERTEX_ATTRIB_FORMAT_TYPE_SSCALED |
+	NVC0_3D_VERTEX_ATTRIB_FORMAT_SIZE_32_32 |
+	(offsetof(struct nvc0_vtx, sx) << NVC0_3D_VERTEX_ATTRIB_FORMAT_OFFSET__SHIFT),
+	NVC0_3D_VERTEX_ATTRIB_FORMAT_TYPE_SSCALED |
+	NVC0_3D_VERTEX_ATTRIB_FORMAT_SIZE_32_32 |
+	(offsetof(struct nvc0_vtx, mx) << NVC0_3D_VERTEX_ATTRIB_FORMAT_OFFSET__SHIFT),
+};
+
+static __inline__ void
+NVC0EXAVertex(struct nvc0_vtx *v, int sx, int sy, int mx, int my,
+	      int dx, int dy)
+{
+	v->dx = dx;
+	v->dy = dy;
+	v->sx = sx;
+	v->sy = sy;
+	v->mx = mx;
+	v->my = my;
+}
+
+static Bool
+NVC0EXAPrepare3D(int op,
+		 PicturePtr pspict, PicturePtr pmpict, PicturePtr pdpict,
+		 PixmapPtr pspix, PixmapPtr pmpix, PixmapPtr pdpix)
 {
 	struct nouveau_bo *dst = nouveau_pixmap_bo(pdpix);
 	NVC0EXA_LOCALS(pdpix);
-
-	if (!PUSH_SPACE(push, 256))
+	uint32_t scissor[2];
+	uint32_t fp, solid;
+	int space = 256;
+
+	/* baked gradient ramps go through the pushbuf too */
+	if (!pspict->pDrawable)
+		space += NOUVEAU_GRADIENT_TEXELS;
+	if (pmpict && !pmpict->pDrawable)
+		space += NOUVEAU_GRADIENT_TEXELS;
+	/* and convolution taps */
+	if (pspict->filter == PictFilterConvolution)
+		space += 8 + 49 * 4;
+
+	if (!PUSH_SPACE(push, space))
 		NOUVEAU_FALLBACK("space\n");
 
 	BEGIN_NVC0(push, SUBC_2D(NV50_GRAPH_SERIALIZE), 1);
@@ -847,42 +1253,105 @@ NVC0EXAPrepareComposite(int op,
 	NVC0EXABlend(pdpix, pdpict, op, pmpict && pmpict->componentAlpha &&
 		     PICT_FORMAT_RGB(pmpict->format));
 
+	pNv->exa_bounds = !pmpict && NVC0EXANeedBounds(pspict, pdpict, op);
+
+	/* solid colour through a texture mask (or the reverse), the common
+	 * text case, takes the colour from the FP constants instead
+	 */
+	solid = 0;
+	if (pmpict && pdpict->format != PICT_a8 &&
+	    !(pmpict->componentAlpha && PICT_FORMAT_RGB(pmpict->format))) {
+		if (NVC0EXAPictIsSolid(pspict) && pmpict->pDrawable)
+			solid = PFP_C_SS;
+		else
+		if (NVC0EXAPictIsSolid(pmpict) && pspict->pDrawable)
+			solid = PFP_C_SM;
+	}
+
+	if (solid == PFP_C_SS)
+		NVC0EXAPictConst(pNv, pspict);
+	else
 	if (!NVC0EXAPicture(pNv, pspix, pspict, 0))
 		NOUVEAU_FALLBACK("src picture invalid\n");
 
 	if (pmpict) {
+		if (solid == PFP_C_SM)
+			NVC0EXAPictConst(pNv, pmpict);
+		else
 		if (!NVC0EXAPicture(pNv, pmpix, pmpict, 1))
 			NOUVEAU_FALLBACK("mask picture invalid\n");
 
-		BEGIN_NVC0(push, NVC0_3D(SP_START_ID(5)), 1);
+		if (solid) {
+			fp = solid;
+		} else
 		if (pdpict->format == PICT_a8) {
-			PUSH_DATA (push, PFP_C_A8);
+			fp = PFP_C_A8;
 		} else {
 			if (pmpict->componentAlpha &&
 			    PICT_FORMAT_RGB(pmpict->format)) {
 				if (NVC0EXABlendOp[op].src_alpha)
-					PUSH_DATA (push, PFP_CCASA);
+					fp = PFP_CCASA;
 				else
-					PUSH_DATA (push, PFP_CCA);
+					fp = PFP_CCA;
+			} else
+			if (NVC0EXAPictIsRadial(pspict)) {
+				fp = PFP_RC;
 			} else {
-				PUSH_DATA (push, PFP_C);
+				fp = PFP_C;
 			}
 		}
+	} else
+	if (pspict->filter == PictFilterConvolution) {
+		fp = NVC0EXAPictTaps(pNv, pspix, pspict);
+	} else
+	if (pNv->exa_bounds) {
+		NVC0EXAPictBounds(pNv, pspix, pspict, 1);
+		if (pdpict->format == PICT_a8)
+			fp = PFP_C_A8;
+		else
+			fp = PFP_C;
 	} else {
-		BEGIN_NVC0(push, NVC0_3D(SP_START_ID(5)), 1);
 		if (pdpict->format == PICT_a8)
-			PUSH_DATA (push, PFP_S_A8);
+			fp = PFP_S_A8;
 		else
-			PUSH_DATA (push, PFP_S);
+		if (NVC0EXAPictIsRadial(pspict))
+			fp = PFP_RS;
+		else
+			fp = PFP_S;
 	}
 
-	BEGIN_NVC0(push, NVC0_3D(TSC_FLUSH), 1);
-	PUSH_DATA (push, 0);
-	BEGIN_NVC0(push, NVC0_3D(TIC_FLUSH), 1);
-	PUSH_DATA (push, 0);
+	if (NVAccelState(pNv, NVC0_3D(SP_START_ID(5)), 1, &fp)) {
+		BEGIN_NVC0(push, NVC0_3D(SP_START_ID(5)), 1);
+		PUSH_DATA (push, fp);
+	}
+
+	/* the descriptor caches only need flushing if an entry was replaced,
+	 * texels may have been rendered since the last composite though
+	 */
+	if (pNv->tex_dirty) {
+		BEGIN_NVC0(push, NVC0_3D(TSC_FLUSH), 1);
+		PUSH_DATA (push, 0);
+		BEGIN_NVC0(push, NVC0_3D(TIC_FLUSH), 1);
+		PUSH_DATA (push, 0);
+		pNv->tex_dirty = FALSE;
+	}
 	BEGIN_NVC0(push, NVC0_3D(TEX_CACHE_CTL), 1);
 	PUSH_DATA (push, 0);
 
+	/* rects are drawn as quads, no need to scissor each one */
+	scissor[0] = pdpix->drawable.width << 16;
+	scissor[1] = pdpix->drawable.height << 16;
+	if (NVAccelState(pNv, NVC0_3D(SCISSOR_HORIZ(0)), 2, scissor)) {
+		BEGIN_NVC0(push, NVC0_3D(SCISSOR_HORIZ(0)), 2);
+		PUSH_DATAp(push, scissor, 2);
+	}
+	if (NVAccelState(pNv, NVC0_3D(VERTEX_ATTRIB_FORMAT(0)), 3,
+			 NVC0EXAVertexFormat)) {
+		BEGIN_NVC0(push, NVC0_3D(VERTEX_ATTRIB_FORMAT(0)), 3);
+		PUSH_DATAp(push, NVC0EXAVertexFormat, 3);
+	}
+	pNv->vtx_bo = NULL;
+
 	PUSH_RESET(push);
 	PUSH_REFN (push, pNv->scratch, NOUVEAU_BO_VRAM | NOUVEAU_BO_RDWR);
 	if (pspict->pDrawable)
@@ -894,7 +1363,7 @@ NVC0EXAPrepareComposite(int op,
 			   NOUVEAU_BO_VRAM | NOUVEAU_BO_RD);
 
 	nouveau_pushbuf_bufctx(push, pNv->bufctx);
-	if (nouveau_pushbuf_validate(push)) {
+	if (PUSH_VAL(push)) {
 		nouveau_pushbuf_bufctx(push, NULL);
 		NOUVEAU_FALLBACK("validate\n");
 	}
@@ -902,32 +1371,262 @@ NVC0EXAPrepareComposite(int op,
 	return TRUE;
 }
 
-void
-NVC0EXAComposite(PixmapPtr pdpix,
-		 int sx, int sy, int mx, int my,
-		 int dx, int dy, int w, int h)
+/* Composites that only copy scaled source texels skip the 3D engine, and
+ * go through the 2D engine's scaled blit instead, see nouveau_exa_blit().
+ * Rects that sample outside the source still need the 3D engine, it's
+ * only set up by the first of them, see NVC0EXABlit3D().  The formats were
+ * checked by CheckComposite, the tiling and bos are checked here, so that
+ * can't fail for any other reason than running out of pushbuf space.
+ */
+static Bool
+NVC0EXAPrepareBlit(int op, PicturePtr pspict, PicturePtr pmpict,
+		   PicturePtr pdpict, PixmapPtr pspix, PixmapPtr pdpix)
 {
 	NVC0EXA_LOCALS(pdpix);
+	uint32_t src, dst;
+
+	if (!nouveau_exa_blit(pNv, op, pspict, pmpict, pdpict, pspix))
+		return FALSE;
+	if (pspix == pdpix ||
+	    !nv50_style_tiled_pixmap(pspix) || !nv50_style_tiled_pixmap(pdpix))
+		return FALSE;
+	if (!NVC0EXA2DSurfaceFormat(pspix, &src) ||
+	    !NVC0EXA2DSurfaceFormat(pdpix, &dst))
+		return FALSE;
 
 	if (!PUSH_SPACE(push, 64))
+		return FALSE;
+	PUSH_RESET(push);
+
+	NVC0EXAAcquireSurface2D(pspix, 1, src);
+	NVC0EXAAcquireSurface2D(pdpix, 0, dst);
+	NVC0EXASetROP(pdpix, GXcopy, ~0);
+	/* the 2D surfaces are the 3D engine's texture and render target,
+	 * it only adds the scratch bo
+	 */
+	PUSH_REFN (push, pNv->scratch, NOUVEAU_BO_VRAM | NOUVEAU_BO_RDWR);
+
+	nouveau_pushbuf_bufctx(push, pNv->bufctx);
+	if (PUSH_VAL(push)) {
+		nouveau_pushbuf_bufctx(push, NULL);
+		return FALSE;
+	}
+
+	pNv->vtx_bo = NULL;
+	return TRUE;
+}
+
+Bool
+NVC0EXAPrepareComposite(int op,
+			PicturePtr pspict, PicturePtr pmpict, PicturePtr pdpict,
+			PixmapPtr pspix, PixmapPtr pmpix, PixmapPtr pdpix)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+
+	pNv->exa_blit = NVC0EXAPrepareBlit(op, pspict, pmpict, pdpict,
+					   pspix, pdpix);
+	if (pNv->exa_blit) {
+		pNv->blit.op = op;
+		pNv->blit.pspict = pspict;
+		pNv->blit.pdpict = pdpict;
+		pNv->blit.pspix = pspix;
+		pNv->blit.ready = FALSE;
+		return TRUE;
+	}
+
+	if (!NVC0EXAPrepare3D(op, pspict, pmpict, pdpict,
+			      pspix, pmpix, pdpix)) {
+		nouveau_pushbuf_bufctx(pNv->pushbuf, NULL);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+NVC0EXACompositeFlush(NVPtr pNv)
+{
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+	struct nouveau_bo *bo = pNv->vtx_bo;
+	uint64_t start, limit;
+	int nr = pNv->vtx_count * 4;
+
+	if (!bo)
+		return;
+	pNv->vtx_bo = NULL;
+	if (!nr || !PUSH_SPACE(push, 32))
 		return;
 
-	BEGIN_NVC0(push, NVC0_3D(SCISSOR_HORIZ(0)), 2);
-	PUSH_DATA (push, ((dx + w) << 16) | dx);
-	PUSH_DATA (push, ((dy + h) << 16) | dy);
+	start = bo->offset + pNv->vtx_offset;
+	limit = start + nr * sizeof(struct nvc0_vtx) - 1;
+
+	BEGIN_NVC0(push, NVC0_3D(VERTEX_ARRAY_FLUSH), 1);
+	PUSH_DATA (push, 0);
+	BEGIN_NVC0(push, NVC0_3D(VERTEX_ARRAY_FETCH(0)), 3);
+	PUSH_DATA (push, NVC0_3D_VERTEX_ARRAY_FETCH_ENABLE |
+			 sizeof(struct nvc0_vtx));
+	PUSH_DATA (push, start >> 32);
+	PUSH_DATA (push, start);
+	BEGIN_NVC0(push, NVC0_3D(VERTEX_ARRAY_LIMIT_HIGH(0)), 2);
+	PUSH_DATA (push, limit >> 32);
+	PUSH_DATA (push, limit);
 	BEGIN_NVC0(push, NVC0_3D(VERTEX_BEGIN_GL), 1);
-	PUSH_DATA (push, NVC0_3D_VERTEX_BEGIN_GL_PRIMITIVE_TRIANGLES);
-	PUSH_VTX2s(push, sx, sy + (h * 2), mx, my + (h * 2), dx, dy + (h * 2));
-	PUSH_VTX2s(push, sx, sy, mx, my, dx, dy);
-	PUSH_VTX2s(push, sx + (w * 2), sy, mx + (w * 2), my, dx + (w * 2), dy);
+	PUSH_DATA (push, NVC0_3D_VERTEX_BEGIN_GL_PRIMITIVE_QUADS);
+	BEGIN_NVC0(push, NVC0_3D(VERTEX_BUFFER_FIRST), 2);
+	PUSH_DATA (push, 0);
+	PUSH_DATA (push, nr);
 	BEGIN_NVC0(push, NVC0_3D(VERTEX_END_GL), 1);
 	PUSH_DATA (push, 0);
 }
 
+static struct nvc0_vtx *
+NVC0EXAVertices(NVPtr pNv)
+{
+	struct nouveau_pushbuf *push = pNv->pushbuf;
+	struct nvc0_vtx *v;
+
+	if (!pNv->vtx_bo) {
+		struct nouveau_bo *bo;
+		int offset;
+
+		if (nouveau_exa_scratch(pNv, NVC0_COMPOSITE_BATCH * 4 *
+					sizeof(struct nvc0_vtx), FALSE,
+					&bo, &offset))
+			return NULL;
+
+		/* the draw may be emitted after any number of kicks, keep
+		 * the array in the bufctx rather than on the pushbuf, the
+		 * previous one is on the pushbuf already
+		 */
+		nouveau_bufctx_reset(BUFCTX(push), NOUVEAU_BIN_VTX);
+		nouveau_bufctx_refn(BUFCTX(push), NOUVEAU_BIN_VTX, bo,
+				    NOUVEAU_BO_GART | NOUVEAU_BO_RD);
+		if (PUSH_VAL(push))
+			return NULL;
+
+		pNv->vtx_bo = bo;
+		pNv->vtx_offset = offset;
+		pNv->vtx_count = 0;
+	}
+
+	v = (struct nvc0_vtx *)((char *)pNv->vtx_bo->map + pNv->vtx_offset);
+	return v + pNv->vtx_count * 4;
+}
+
+static Bool
+NVC0EXABlit(PixmapPtr pdpix, int sx, int sy, int dx, int dy, int w, int h)
+{
+	NVC0EXA_LOCALS(pdpix);
+	uint32_t data[8];
+
+	if (!nouveau_exa_blit_rect(pNv, sx, sy, w, h, data))
+		return FALSE;
+
+	if (!PUSH_SPACE(push, 32))
+		return FALSE;
+
+	BEGIN_NVC0(push, SUBC_2D(NV50_GRAPH_SERIALIZE), 1);
+	PUSH_DATA (push, 0);
+	BEGIN_NVC0(push, NV50_2D(BLIT_CONTROL), 1);
+	PUSH_DATA (push, NV50_2D_BLIT_CONTROL_ORIGIN_CORNER |
+			 (pNv->blit.bilinear ?
+			  NV50_2D_BLIT_CONTROL_FILTER_BILINEAR :
+			  NV50_2D_BLIT_CONTROL_FILTER_POINT_SAMPLE));
+	BEGIN_NVC0(push, NV50_2D(BLIT_DST_X), 12);
+	PUSH_DATA (push, dx);
+	PUSH_DATA (push, dy);
+	PUSH_DATA (push, w);
+	PUSH_DATA (push, h);
+	PUSH_DATAp(push, data, 8);
+
+	NVAccelQueue(pNv, w * h);
+	return TRUE;
+}
+
+/* a rect of a blit composite that the 2D engine can't do, the 3D engine
+ * is set up for the rest of the composite on the first one
+ */
+static Bool
+NVC0EXABlit3D(PixmapPtr pdpix)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+	struct nouveau_blit *blit = &pNv->blit;
+
+	if (!blit->ready)
+		blit->ready = NVC0EXAPrepare3D(blit->op, blit->pspict, NULL,
+					       blit->pdpict, blit->pspix, NULL,
+					       pdpix);
+	return blit->ready;
+}
+
+void
+NVC0EXAComposite(PixmapPtr pdpix,
+		 int sx, int sy, int mx, int my,
+		 int dx, int dy, int w, int h)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+	struct nvc0_vtx *v;
+
+	if (pNv->exa_blit) {
+		if (NVC0EXABlit(pdpix, sx, sy, dx, dy, w, h))
+			return;
+		if (!NVC0EXABlit3D(pdpix))
+			return;
+	}
+
+	if (pNv->exa_bounds) {
+		mx = sx;
+		my = sy;
+	}
+
+	if (!(v = NVC0EXAVertices(pNv)))
+		return;
+
+	NVC0EXAVertex(&v[0], sx, sy, mx, my, dx, dy);
+	NVC0EXAVertex(&v[1], sx + w, sy, mx + w, my, dx + w, dy);
+	NVC0EXAVertex(&v[2], sx + w, sy + h, mx + w, my + h, dx + w, dy + h);
+	NVC0EXAVertex(&v[3], sx, sy + h, mx, my + h, dx, dy + h);
+
+	if (++pNv->vtx_count == NVC0_COMPOSITE_BATCH)
+		NVC0EXACompositeFlush(pNv);
+}
+
+/* Same as NVC0EXAComposite(), except the source and mask coordinates are
+ * given per corner (top-left, top-right, bottom-left) rather than derived
+ * from the destination position, the bottom-right one is extrapolated.
+ */
+void
+NVC0EXACompositeAffine(PixmapPtr pdpix, int dx, int dy, int w, int h,
+		       const int32_t *s, const int32_t *m)
+{
+	NVPtr pNv = NVPTR(xf86ScreenToScrn(pdpix->drawable.pScreen));
+	struct nvc0_vtx *v;
+
+	if (pNv->exa_blit && !NVC0EXABlit3D(pdpix))
+		return;
+
+	if (!(v = NVC0EXAVertices(pNv)))
+		return;
+
+	NVC0EXAVertex(&v[0], s[0], s[1], m[0], m[1], dx, dy);
+	NVC0EXAVertex(&v[1], s[2], s[3], m[2], m[3], dx + w, dy);
+	NVC0EXAVertex(&v[2], s[2] + s[4] - s[0], s[3] + s[5] - s[1],
+		      m[2] + m[4] - m[0], m[3] + m[5] - m[1], dx + w, dy + h);
+	NVC0EXAVertex(&v[3], s[4], s[5], m[4], m[5], dx, dy + h);
+
+	if (++pNv->vtx_count == NVC0_COMPOSITE_BATCH)
+		NVC0EXACompositeFlush(pNv);
+}
+
 void
 NVC0EXADoneComposite(PixmapPtr pdpix)
 {
 	NVC0EXA_LOCALS(pdpix);
+
+	/* the vertex array setup is left in place for the next composite,
+	 * Xv puts the immediate-mode defaults back itself
+	 */
+	NVC0EXACompositeFlush(pNv);
 	nouveau_pushbuf_bufctx(push, NULL);
 }
 
@@ -68,6 +68,7 @@ nvc0_xv_image_put(ScrnInfoPtr pScrn,
 {
 	NVPtr pNv = NVPTR(pScrn);
 	struct nouveau_bo *dst = nouveau_pixmap_bo(ppix);
+	uint64_t dst_offset = dst->offset + nouveau_pixmap_offset(ppix);
 	struct nouveau_pushbuf_refn refs[] = {
 		{ pNv->scratch, NOUVEAU_BO_VRAM | NOUVEAU_BO_RDWR },
 		{ src, NOUVEAU_BO_VRAM | NOUVEAU_BO_RD },
@@ -85,9 +86,28 @@ nvc0_xv_image_put(ScrnInfoPtr pScrn,
 	if (!PUSH_SPACE(push, 256))
 		return BadImplementation;
 
+	/* none of this goes through the EXA state shadow, and composite
+	 * leaves its vertex array bound
+	 */
+	NVAccelStateReset(pNv);
+	BEGIN_NVC0(push, NVC0_3D(VERTEX_ARRAY_FETCH(0)), 1);
+	PUSH_DATA (push, 0);
+	BEGIN_NVC0(push, NVC0_3D(VERTEX_ATTRIB_FORMAT(0)), 3);
+	PUSH_DATA (push, 0x25e00040);
+	PUSH_DATA (push, 0x25e00040);
+	PUSH_DATA (push, 0x25e00040);
+	if (pNv->tex_bound[0] != 0) {
+		PUSH_TEXBIND(push, pNv->scratch, 0, 0);
+		pNv->tex_bound[0] = 0;
+	}
+	if (pNv->tex_bound[1] != 1) {
+		PUSH_TEXBIND(push, pNv->scratch, 1, 1);
+		pNv->tex_bound[1] = 1;
+	}
+
 	BEGIN_NVC0(push, NVC0_3D(RT_ADDRESS_HIGH(0)), 8);
-	PUSH_DATA (push, dst->offset >> 32);
-	PUSH_DATA (push, dst->offset);
+	PUSH_DATA (push, dst_offset >> 32);
+	PUSH_DATA (push, dst_offset);
 	PUSH_DATA (push, ppix->drawable.width);
 	PUSH_DATA (push, ppix->drawable.height);
 	switch (ppix->drawable.bitsPerPixel) {
@@ -0,0 +1,38 @@
+#ifndef ENVYAS
+static uint32_t
+NVC0FP_CompositeSolid[] = {
+	0x00021462,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x80000000,
+	0x00000a0a,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x0000000f,
+	0x00000000,
+#include "exacsnvc0.fpc"
+};
+#else
+
+interp pass f32 $r0 a[0x7c] 0x0 0x0
+rcp f32 $r0 $r0
+interp mul f32 $r3 a[0x94] $r0 0x0
+interp mul f32 $r2 a[0x90] $r0 0x0
+tex t lauto live dfp #:#:#:$r4 t2d $t1 $s0 $r2:$r3 ()
+mul ftz rn f32 $r3 $r4 c0[0x34]
+mul ftz rn f32 $r2 $r4 c0[0x30]
+mul ftz rn f32 $r1 $r4 c0[0x2c]
+mul ftz rn f32 $r0 $r4 c0[0x28]
+exit
+#endif
@@ -0,0 +1,56 @@
+#ifndef ENVYAS
+static uint32_t
+NV110FP_RadialComposite[] = {
+	0x00001462,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x80000000,
+	0x00000a0a,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x0000000f,
+	0x00000000,
+#include "exarcnv110.fpc"
+};
+#else
+
+sched (st 0x2 wr 0x0) (st 0x2 wr 0x0 wt 0x1) (st 0x1 wr 0x0 rd 0x1 wt 0x1)
+ipa pass $r0 a[0x7c] 0x0 0x0 1
+mufu rcp $r0 $r0
+ipa $r5 a[0x94] $r0 0x0 1
+sched (st 0x2 wr 0x2 rd 0x3) (st 0x1 wr 0x0 rd 0x2 wt 0x5) (st 0x2 wr 0x4 rd 0x5)
+ipa $r4 a[0x90] $r0 0x0 1
+tex t2d #:#:#:$r4 $r4:$r5 0x1
+ipa $r1 a[0x84] $r0 0x0 1
+sched (st 0x2 wr 0x1 wt 0x2a) (st 0x6 wt 0x2) (st 0x6 wt 0x10)
+ipa $r0 a[0x80] $r0 0x0 1
+fmul ftz $r2 $r0 $r0
+ffma ftz $r2 $r1 $r1 $r2
+sched (st 0x2 wr 0x1) (st 0x2 wr 0x1 wt 0x2) (st 0x6 wt 0x2)
+mufu rsq $r2 $r2
+mufu rcp $r2 $r2
+ffma ftz $r2 $r0 c0[0x38] $r2
+sched (st 0x6) (st 0x2 wr 0x1) (st 0x1 wt 0x3)
+fadd ftz $r0 $r2 c0[0x3c]
+tex t2d $r0:$r1:$r2:$r3 $r0:$r1 0x0
+fmul ftz $r3 $r3 $r4
+sched (st 0x1) (st 0x1) (st 0x1)
+fmul ftz $r2 $r2 $r4
+fmul ftz $r1 $r1 $r4
+fmul ftz $r0 $r0 $r4
+sched (st 0xf wt 0x3f) (st 0xf) (st 0xf)
+exit
+nop
+nop
+#endif
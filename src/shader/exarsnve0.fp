@@ -0,0 +1,41 @@
+#ifndef ENVYAS
+static uint32_t
+NVE0FP_RadialSource[] = {
+	0x00021462,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x80000000,
+	0x0000000a,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x0000000f,
+	0x00000000,
+#include "exarsnve0.fpc"
+};
+#else
+
+interp pass f32 $r0 a[0x7c] 0x0 0x0
+rcp f32 $r0 $r0
+interp mul f32 $r1 a[0x84] $r0 0x0
+interp mul f32 $r0 a[0x80] $r0 0x0
+mul ftz rn f32 $r2 $r0 $r0
+fma ftz rn f32 $r2 $r1 $r1 $r2
+rsqrt f32 $r2 $r2
+rcp f32 $r2 $r2
+fma ftz rn f32 $r2 $r0 c0[0x38] $r2
+add ftz rn f32 $r0 $r2 c0[0x3c]
+tex t lauto live dfp $r0:$r1:$r2:$r3 t2d $t0 $s0 $r0:$r1 ()
+texbar 0x0
+long exit
+#endif
@@ -0,0 +1,96 @@
+#ifndef ENVYAS
+static uint32_t
+NVC0FP_Convolution3x3[] = {
+	0x00021462,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x80000000,
+	0x0000000a,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x0000000f,
+	0x00000000,
+#include "exav3nvc0.fpc"
+};
+#else
+
+interp pass f32 $r2 a[0x7c] 0x0 0x0
+rcp f32 $r2 $r2
+interp mul f32 $r8 a[0x80] $r2 0x0
+interp mul f32 $r9 a[0x84] $r2 0x0
+add ftz rn f32 $r4 $r8 c0[0x40]
+add ftz rn f32 $r5 $r9 c0[0x44]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d $t0 $s0 $r4:$r5 ()
+mul ftz rn f32 $r0 $r4 c0[0x48]
+mul ftz rn f32 $r1 $r5 c0[0x48]
+mul ftz rn f32 $r2 $r6 c0[0x48]
+mul ftz rn f32 $r3 $r7 c0[0x48]
+add ftz rn f32 $r4 $r8 c0[0x50]
+add ftz rn f32 $r5 $r9 c0[0x54]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d $t0 $s0 $r4:$r5 ()
+fma ftz rn f32 $r0 $r4 c0[0x58] $r0
+fma ftz rn f32 $r1 $r5 c0[0x58] $r1
+fma ftz rn f32 $r2 $r6 c0[0x58] $r2
+fma ftz rn f32 $r3 $r7 c0[0x58] $r3
+add ftz rn f32 $r4 $r8 c0[0x60]
+add ftz rn f32 $r5 $r9 c0[0x64]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d $t0 $s0 $r4:$r5 ()
+fma ftz rn f32 $r0 $r4 c0[0x68] $r0
+fma ftz rn f32 $r1 $r5 c0[0x68] $r1
+fma ftz rn f32 $r2 $r6 c0[0x68] $r2
+fma ftz rn f32 $r3 $r7 c0[0x68] $r3
+add ftz rn f32 $r4 $r8 c0[0x70]
+add ftz rn f32 $r5 $r9 c0[0x74]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d $t0 $s0 $r4:$r5 ()
+fma ftz rn f32 $r0 $r4 c0[0x78] $r0
+fma ftz rn f32 $r1 $r5 c0[0x78] $r1
+fma ftz rn f32 $r2 $r6 c0[0x78] $r2
+fma ftz rn f32 $r3 $r7 c0[0x78] $r3
+add ftz rn f32 $r4 $r8 c0[0x80]
+add ftz rn f32 $r5 $r9 c0[0x84]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d $t0 $s0 $r4:$r5 ()
+fma ftz rn f32 $r0 $r4 c0[0x88] $r0
+fma ftz rn f32 $r1 $r5 c0[0x88] $r1
+fma ftz rn f32 $r2 $r6 c0[0x88] $r2
+fma ftz rn f32 $r3 $r7 c0[0x88] $r3
+add ftz rn f32 $r4 $r8 c0[0x90]
+add ftz rn f32 $r5 $r9 c0[0x94]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d $t0 $s0 $r4:$r5 ()
+fma ftz rn f32 $r0 $r4 c0[0x98] $r0
+fma ftz rn f32 $r1 $r5 c0[0x98] $r1
+fma ftz rn f32 $r2 $r6 c0[0x98] $r2
+fma ftz rn f32 $r3 $r7 c0[0x98] $r3
+add ftz rn f32 $r4 $r8 c0[0xa0]
+add ftz rn f32 $r5 $r9 c0[0xa4]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d $t0 $s0 $r4:$r5 ()
+fma ftz rn f32 $r0 $r4 c0[0xa8] $r0
+fma ftz rn f32 $r1 $r5 c0[0xa8] $r1
+fma ftz rn f32 $r2 $r6 c0[0xa8] $r2
+fma ftz rn f32 $r3 $r7 c0[0xa8] $r3
+add ftz rn f32 $r4 $r8 c0[0xb0]
+add ftz rn f32 $r5 $r9 c0[0xb4]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d $t0 $s0 $r4:$r5 ()
+fma ftz rn f32 $r0 $r4 c0[0xb8] $r0
+fma ftz rn f32 $r1 $r5 c0[0xb8] $r1
+fma ftz rn f32 $r2 $r6 c0[0xb8] $r2
+fma ftz rn f32 $r3 $r7 c0[0xb8] $r3
+add ftz rn f32 $r4 $r8 c0[0xc0]
+add ftz rn f32 $r5 $r9 c0[0xc4]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d $t0 $s0 $r4:$r5 ()
+fma ftz rn f32 $r0 $r4 c0[0xc8] $r0
+fma ftz rn f32 $r1 $r5 c0[0xc8] $r1
+fma ftz rn f32 $r2 $r6 c0[0xc8] $r2
+fma ftz rn f32 $r3 $r7 c0[0xc8] $r3
+exit
+#endif
@@ -0,0 +1,268 @@
+#ifndef ENVYAS
+static uint32_t
+NV110FP_Convolution5x5[] = {
+	0x00001462,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x80000000,
+	0x0000000a,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x0000000f,
+	0x00000000,
+#include "exav5nv110.fpc"
+};
+#else
+
+sched (st 0x2 wr 0x0) (st 0x2 wr 0x0 wt 0x1) (st 0x1 wr 0x0 rd 0x1 wt 0x1)
+ipa pass $r2 a[0x7c] 0x0 0x0 1
+mufu rcp $r2 $r2
+ipa $r8 a[0x80] $r2 0x0 1
+sched (st 0x1 wr 0x2 rd 0x3) (st 0x1 wt 0x1) (st 0x6 wt 0x4)
+ipa $r9 a[0x84] $r2 0x0 1
+fadd ftz $r4 $r8 c0[0x40]
+fadd ftz $r5 $r9 c0[0x44]
+sched (st 0x2 wr 0x0) (st 0x1 wt 0x1) (st 0x1)
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+fmul ftz $r0 $r4 c0[0x48]
+fmul ftz $r1 $r5 c0[0x48]
+sched (st 0x1 wt 0xa) (st 0x1) (st 0x1)
+fmul ftz $r2 $r6 c0[0x48]
+fmul ftz $r3 $r7 c0[0x48]
+fadd ftz $r4 $r8 c0[0x50]
+sched (st 0x6) (st 0x2 wr 0x0) (st 0x1 wt 0x1)
+fadd ftz $r5 $r9 c0[0x54]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0x58] $r0
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r1 $r5 c0[0x58] $r1
+ffma ftz $r2 $r6 c0[0x58] $r2
+ffma ftz $r3 $r7 c0[0x58] $r3
+sched (st 0x1) (st 0x6) (st 0x2 wr 0x0)
+fadd ftz $r4 $r8 c0[0x60]
+fadd ftz $r5 $r9 c0[0x64]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+sched (st 0x1 wt 0x1) (st 0x1) (st 0x1)
+ffma ftz $r0 $r4 c0[0x68] $r0
+ffma ftz $r1 $r5 c0[0x68] $r1
+ffma ftz $r2 $r6 c0[0x68] $r2
+sched (st 0x1) (st 0x1) (st 0x6)
+ffma ftz $r3 $r7 c0[0x68] $r3
+fadd ftz $r4 $r8 c0[0x70]
+fadd ftz $r5 $r9 c0[0x74]
+sched (st 0x2 wr 0x0) (st 0x1 wt 0x1) (st 0x1)
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0x78] $r0
+ffma ftz $r1 $r5 c0[0x78] $r1
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r2 $r6 c0[0x78] $r2
+ffma ftz $r3 $r7 c0[0x78] $r3
+fadd ftz $r4 $r8 c0[0x80]
+sched (st 0x6) (st 0x2 wr 0x0) (st 0x1 wt 0x1)
+fadd ftz $r5 $r9 c0[0x84]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0x88] $r0
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r1 $r5 c0[0x88] $r1
+ffma ftz $r2 $r6 c0[0x88] $r2
+ffma ftz $r3 $r7 c0[0x88] $r3
+sched (st 0x1) (st 0x6) (st 0x2 wr 0x0)
+fadd ftz $r4 $r8 c0[0x90]
+fadd ftz $r5 $r9 c0[0x94]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+sched (st 0x1 wt 0x1) (st 0x1) (st 0x1)
+ffma ftz $r0 $r4 c0[0x98] $r0
+ffma ftz $r1 $r5 c0[0x98] $r1
+ffma ftz $r2 $r6 c0[0x98] $r2
+sched (st 0x1) (st 0x1) (st 0x6)
+ffma ftz $r3 $r7 c0[0x98] $r3
+fadd ftz $r4 $r8 c0[0xa0]
+fadd ftz $r5 $r9 c0[0xa4]
+sched (st 0x2 wr 0x0) (st 0x1 wt 0x1) (st 0x1)
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0xa8] $r0
+ffma ftz $r1 $r5 c0[0xa8] $r1
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r2 $r6 c0[0xa8] $r2
+ffma ftz $r3 $r7 c0[0xa8] $r3
+fadd ftz $r4 $r8 c0[0xb0]
+sched (st 0x6) (st 0x2 wr 0x0) (st 0x1 wt 0x1)
+fadd ftz $r5 $r9 c0[0xb4]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0xb8] $r0
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r1 $r5 c0[0xb8] $r1
+ffma ftz $r2 $r6 c0[0xb8] $r2
+ffma ftz $r3 $r7 c0[0xb8] $r3
+sched (st 0x1) (st 0x6) (st 0x2 wr 0x0)
+fadd ftz $r4 $r8 c0[0xc0]
+fadd ftz $r5 $r9 c0[0xc4]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+sched (st 0x1 wt 0x1) (st 0x1) (st 0x1)
+ffma ftz $r0 $r4 c0[0xc8] $r0
+ffma ftz $r1 $r5 c0[0xc8] $r1
+ffma ftz $r2 $r6 c0[0xc8] $r2
+sched (st 0x1) (st 0x1) (st 0x6)
+ffma ftz $r3 $r7 c0[0xc8] $r3
+fadd ftz $r4 $r8 c0[0xd0]
+fadd ftz $r5 $r9 c0[0xd4]
+sched (st 0x2 wr 0x0) (st 0x1 wt 0x1) (st 0x1)
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0xd8] $r0
+ffma ftz $r1 $r5 c0[0xd8] $r1
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r2 $r6 c0[0xd8] $r2
+ffma ftz $r3 $r7 c0[0xd8] $r3
+fadd ftz $r4 $r8 c0[0xe0]
+sched (st 0x6) (st 0x2 wr 0x0) (st 0x1 wt 0x1)
+fadd ftz $r5 $r9 c0[0xe4]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0xe8] $r0
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r1 $r5 c0[0xe8] $r1
+ffma ftz $r2 $r6 c0[0xe8] $r2
+ffma ftz $r3 $r7 c0[0xe8] $r3
+sched (st 0x1) (st 0x6) (st 0x2 wr 0x0)
+fadd ftz $r4 $r8 c0[0xf0]
+fadd ftz $r5 $r9 c0[0xf4]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+sched (st 0x1 wt 0x1) (st 0x1) (st 0x1)
+ffma ftz $r0 $r4 c0[0xf8] $r0
+ffma ftz $r1 $r5 c0[0xf8] $r1
+ffma ftz $r2 $r6 c0[0xf8] $r2
+sched (st 0x1) (st 0x1) (st 0x6)
+ffma ftz $r3 $r7 c0[0xf8] $r3
+fadd ftz $r4 $r8 c0[0x100]
+fadd ftz $r5 $r9 c0[0x104]
+sched (st 0x2 wr 0x0) (st 0x1 wt 0x1) (st 0x1)
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0x108] $r0
+ffma ftz $r1 $r5 c0[0x108] $r1
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r2 $r6 c0[0x108] $r2
+ffma ftz $r3 $r7 c0[0x108] $r3
+fadd ftz $r4 $r8 c0[0x110]
+sched (st 0x6) (st 0x2 wr 0x0) (st 0x1 wt 0x1)
+fadd ftz $r5 $r9 c0[0x114]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0x118] $r0
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r1 $r5 c0[0x118] $r1
+ffma ftz $r2 $r6 c0[0x118] $r2
+ffma ftz $r3 $r7 c0[0x118] $r3
+sched (st 0x1) (st 0x6) (st 0x2 wr 0x0)
+fadd ftz $r4 $r8 c0[0x120]
+fadd ftz $r5 $r9 c0[0x124]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+sched (st 0x1 wt 0x1) (st 0x1) (st 0x1)
+ffma ftz $r0 $r4 c0[0x128] $r0
+ffma ftz $r1 $r5 c0[0x128] $r1
+ffma ftz $r2 $r6 c0[0x128] $r2
+sched (st 0x1) (st 0x1) (st 0x6)
+ffma ftz $r3 $r7 c0[0x128] $r3
+fadd ftz $r4 $r8 c0[0x130]
+fadd ftz $r5 $r9 c0[0x134]
+sched (st 0x2 wr 0x0) (st 0x1 wt 0x1) (st 0x1)
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0x138] $r0
+ffma ftz $r1 $r5 c0[0x138] $r1
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r2 $r6 c0[0x138] $r2
+ffma ftz $r3 $r7 c0[0x138] $r3
+fadd ftz $r4 $r8 c0[0x140]
+sched (st 0x6) (st 0x2 wr 0x0) (st 0x1 wt 0x1)
+fadd ftz $r5 $r9 c0[0x144]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0x148] $r0
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r1 $r5 c0[0x148] $r1
+ffma ftz $r2 $r6 c0[0x148] $r2
+ffma ftz $r3 $r7 c0[0x148] $r3
+sched (st 0x1) (st 0x6) (st 0x2 wr 0x0)
+fadd ftz $r4 $r8 c0[0x150]
+fadd ftz $r5 $r9 c0[0x154]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+sched (st 0x1 wt 0x1) (st 0x1) (st 0x1)
+ffma ftz $r0 $r4 c0[0x158] $r0
+ffma ftz $r1 $r5 c0[0x158] $r1
+ffma ftz $r2 $r6 c0[0x158] $r2
+sched (st 0x1) (st 0x1) (st 0x6)
+ffma ftz $r3 $r7 c0[0x158] $r3
+fadd ftz $r4 $r8 c0[0x160]
+fadd ftz $r5 $r9 c0[0x164]
+sched (st 0x2 wr 0x0) (st 0x1 wt 0x1) (st 0x1)
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0x168] $r0
+ffma ftz $r1 $r5 c0[0x168] $r1
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r2 $r6 c0[0x168] $r2
+ffma ftz $r3 $r7 c0[0x168] $r3
+fadd ftz $r4 $r8 c0[0x170]
+sched (st 0x6) (st 0x2 wr 0x0) (st 0x1 wt 0x1)
+fadd ftz $r5 $r9 c0[0x174]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0x178] $r0
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r1 $r5 c0[0x178] $r1
+ffma ftz $r2 $r6 c0[0x178] $r2
+ffma ftz $r3 $r7 c0[0x178] $r3
+sched (st 0x1) (st 0x6) (st 0x2 wr 0x0)
+fadd ftz $r4 $r8 c0[0x180]
+fadd ftz $r5 $r9 c0[0x184]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+sched (st 0x1 wt 0x1) (st 0x1) (st 0x1)
+ffma ftz $r0 $r4 c0[0x188] $r0
+ffma ftz $r1 $r5 c0[0x188] $r1
+ffma ftz $r2 $r6 c0[0x188] $r2
+sched (st 0x1) (st 0x1) (st 0x6)
+ffma ftz $r3 $r7 c0[0x188] $r3
+fadd ftz $r4 $r8 c0[0x190]
+fadd ftz $r5 $r9 c0[0x194]
+sched (st 0x2 wr 0x0) (st 0x1 wt 0x1) (st 0x1)
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0x198] $r0
+ffma ftz $r1 $r5 c0[0x198] $r1
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r2 $r6 c0[0x198] $r2
+ffma ftz $r3 $r7 c0[0x198] $r3
+fadd ftz $r4 $r8 c0[0x1a0]
+sched (st 0x6) (st 0x2 wr 0x0) (st 0x1 wt 0x1)
+fadd ftz $r5 $r9 c0[0x1a4]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0x1a8] $r0
+sched (st 0x1) (st 0x1) (st 0x1)
+ffma ftz $r1 $r5 c0[0x1a8] $r1
+ffma ftz $r2 $r6 c0[0x1a8] $r2
+ffma ftz $r3 $r7 c0[0x1a8] $r3
+sched (st 0x1) (st 0x6) (st 0x2 wr 0x0)
+fadd ftz $r4 $r8 c0[0x1b0]
+fadd ftz $r5 $r9 c0[0x1b4]
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+sched (st 0x1 wt 0x1) (st 0x1) (st 0x1)
+ffma ftz $r0 $r4 c0[0x1b8] $r0
+ffma ftz $r1 $r5 c0[0x1b8] $r1
+ffma ftz $r2 $r6 c0[0x1b8] $r2
+sched (st 0x1) (st 0x1) (st 0x6)
+ffma ftz $r3 $r7 c0[0x1b8] $r3
+fadd ftz $r4 $r8 c0[0x1c0]
+fadd ftz $r5 $r9 c0[0x1c4]
+sched (st 0x2 wr 0x0) (st 0x1 wt 0x1) (st 0x1)
+tex t2d $r4:$r5:$r6:$r7 $r4:$r5 0x0
+ffma ftz $r0 $r4 c0[0x1c8] $r0
+ffma ftz $r1 $r5 c0[0x1c8] $r1
+sched (st 0x1) (st 0x1) (st 0xf wt 0x3f)
+ffma ftz $r2 $r6 c0[0x1c8] $r2
+ffma ftz $r3 $r7 c0[0x1c8] $r3
+exit
+#endif
@@ -0,0 +1,233 @@
+#ifndef ENVYAS
+static uint32_t
+NVF0FP_Convolution5x5[] = {
+	0x00001462,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x80000000,
+	0x0000000a,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x0000000f,
+	0x00000000,
+#include "exav5nvf0.fpc"
+};
+#else
+
+interp pass f32 $r2 a[0x7c] 0x0 0x0 0x0
+rcp f32 $r2 $r2
+interp mul f32 $r8 a[0x80] $r2 0x0 0x0
+interp mul f32 $r9 a[0x84] $r2 0x0 0x0
+add ftz rn f32 $r4 $r8 c0[0x40]
+add ftz rn f32 $r5 $r9 c0[0x44]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+mul ftz rn f32 $r0 $r4 c0[0x48]
+mul ftz rn f32 $r1 $r5 c0[0x48]
+mul ftz rn f32 $r2 $r6 c0[0x48]
+mul ftz rn f32 $r3 $r7 c0[0x48]
+add ftz rn f32 $r4 $r8 c0[0x50]
+add ftz rn f32 $r5 $r9 c0[0x54]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x58] $r0
+fma ftz rn f32 $r1 $r5 c0[0x58] $r1
+fma ftz rn f32 $r2 $r6 c0[0x58] $r2
+fma ftz rn f32 $r3 $r7 c0[0x58] $r3
+add ftz rn f32 $r4 $r8 c0[0x60]
+add ftz rn f32 $r5 $r9 c0[0x64]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x68] $r0
+fma ftz rn f32 $r1 $r5 c0[0x68] $r1
+fma ftz rn f32 $r2 $r6 c0[0x68] $r2
+fma ftz rn f32 $r3 $r7 c0[0x68] $r3
+add ftz rn f32 $r4 $r8 c0[0x70]
+add ftz rn f32 $r5 $r9 c0[0x74]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x78] $r0
+fma ftz rn f32 $r1 $r5 c0[0x78] $r1
+fma ftz rn f32 $r2 $r6 c0[0x78] $r2
+fma ftz rn f32 $r3 $r7 c0[0x78] $r3
+add ftz rn f32 $r4 $r8 c0[0x80]
+add ftz rn f32 $r5 $r9 c0[0x84]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x88] $r0
+fma ftz rn f32 $r1 $r5 c0[0x88] $r1
+fma ftz rn f32 $r2 $r6 c0[0x88] $r2
+fma ftz rn f32 $r3 $r7 c0[0x88] $r3
+add ftz rn f32 $r4 $r8 c0[0x90]
+add ftz rn f32 $r5 $r9 c0[0x94]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x98] $r0
+fma ftz rn f32 $r1 $r5 c0[0x98] $r1
+fma ftz rn f32 $r2 $r6 c0[0x98] $r2
+fma ftz rn f32 $r3 $r7 c0[0x98] $r3
+add ftz rn f32 $r4 $r8 c0[0xa0]
+add ftz rn f32 $r5 $r9 c0[0xa4]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0xa8] $r0
+fma ftz rn f32 $r1 $r5 c0[0xa8] $r1
+fma ftz rn f32 $r2 $r6 c0[0xa8] $r2
+fma ftz rn f32 $r3 $r7 c0[0xa8] $r3
+add ftz rn f32 $r4 $r8 c0[0xb0]
+add ftz rn f32 $r5 $r9 c0[0xb4]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0xb8] $r0
+fma ftz rn f32 $r1 $r5 c0[0xb8] $r1
+fma ftz rn f32 $r2 $r6 c0[0xb8] $r2
+fma ftz rn f32 $r3 $r7 c0[0xb8] $r3
+add ftz rn f32 $r4 $r8 c0[0xc0]
+add ftz rn f32 $r5 $r9 c0[0xc4]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0xc8] $r0
+fma ftz rn f32 $r1 $r5 c0[0xc8] $r1
+fma ftz rn f32 $r2 $r6 c0[0xc8] $r2
+fma ftz rn f32 $r3 $r7 c0[0xc8] $r3
+add ftz rn f32 $r4 $r8 c0[0xd0]
+add ftz rn f32 $r5 $r9 c0[0xd4]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0xd8] $r0
+fma ftz rn f32 $r1 $r5 c0[0xd8] $r1
+fma ftz rn f32 $r2 $r6 c0[0xd8] $r2
+fma ftz rn f32 $r3 $r7 c0[0xd8] $r3
+add ftz rn f32 $r4 $r8 c0[0xe0]
+add ftz rn f32 $r5 $r9 c0[0xe4]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0xe8] $r0
+fma ftz rn f32 $r1 $r5 c0[0xe8] $r1
+fma ftz rn f32 $r2 $r6 c0[0xe8] $r2
+fma ftz rn f32 $r3 $r7 c0[0xe8] $r3
+add ftz rn f32 $r4 $r8 c0[0xf0]
+add ftz rn f32 $r5 $r9 c0[0xf4]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0xf8] $r0
+fma ftz rn f32 $r1 $r5 c0[0xf8] $r1
+fma ftz rn f32 $r2 $r6 c0[0xf8] $r2
+fma ftz rn f32 $r3 $r7 c0[0xf8] $r3
+add ftz rn f32 $r4 $r8 c0[0x100]
+add ftz rn f32 $r5 $r9 c0[0x104]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x108] $r0
+fma ftz rn f32 $r1 $r5 c0[0x108] $r1
+fma ftz rn f32 $r2 $r6 c0[0x108] $r2
+fma ftz rn f32 $r3 $r7 c0[0x108] $r3
+add ftz rn f32 $r4 $r8 c0[0x110]
+add ftz rn f32 $r5 $r9 c0[0x114]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x118] $r0
+fma ftz rn f32 $r1 $r5 c0[0x118] $r1
+fma ftz rn f32 $r2 $r6 c0[0x118] $r2
+fma ftz rn f32 $r3 $r7 c0[0x118] $r3
+add ftz rn f32 $r4 $r8 c0[0x120]
+add ftz rn f32 $r5 $r9 c0[0x124]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x128] $r0
+fma ftz rn f32 $r1 $r5 c0[0x128] $r1
+fma ftz rn f32 $r2 $r6 c0[0x128] $r2
+fma ftz rn f32 $r3 $r7 c0[0x128] $r3
+add ftz rn f32 $r4 $r8 c0[0x130]
+add ftz rn f32 $r5 $r9 c0[0x134]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x138] $r0
+fma ftz rn f32 $r1 $r5 c0[0x138] $r1
+fma ftz rn f32 $r2 $r6 c0[0x138] $r2
+fma ftz rn f32 $r3 $r7 c0[0x138] $r3
+add ftz rn f32 $r4 $r8 c0[0x140]
+add ftz rn f32 $r5 $r9 c0[0x144]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x148] $r0
+fma ftz rn f32 $r1 $r5 c0[0x148] $r1
+fma ftz rn f32 $r2 $r6 c0[0x148] $r2
+fma ftz rn f32 $r3 $r7 c0[0x148] $r3
+add ftz rn f32 $r4 $r8 c0[0x150]
+add ftz rn f32 $r5 $r9 c0[0x154]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x158] $r0
+fma ftz rn f32 $r1 $r5 c0[0x158] $r1
+fma ftz rn f32 $r2 $r6 c0[0x158] $r2
+fma ftz rn f32 $r3 $r7 c0[0x158] $r3
+add ftz rn f32 $r4 $r8 c0[0x160]
+add ftz rn f32 $r5 $r9 c0[0x164]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x168] $r0
+fma ftz rn f32 $r1 $r5 c0[0x168] $r1
+fma ftz rn f32 $r2 $r6 c0[0x168] $r2
+fma ftz rn f32 $r3 $r7 c0[0x168] $r3
+add ftz rn f32 $r4 $r8 c0[0x170]
+add ftz rn f32 $r5 $r9 c0[0x174]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x178] $r0
+fma ftz rn f32 $r1 $r5 c0[0x178] $r1
+fma ftz rn f32 $r2 $r6 c0[0x178] $r2
+fma ftz rn f32 $r3 $r7 c0[0x178] $r3
+add ftz rn f32 $r4 $r8 c0[0x180]
+add ftz rn f32 $r5 $r9 c0[0x184]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x188] $r0
+fma ftz rn f32 $r1 $r5 c0[0x188] $r1
+fma ftz rn f32 $r2 $r6 c0[0x188] $r2
+fma ftz rn f32 $r3 $r7 c0[0x188] $r3
+add ftz rn f32 $r4 $r8 c0[0x190]
+add ftz rn f32 $r5 $r9 c0[0x194]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x198] $r0
+fma ftz rn f32 $r1 $r5 c0[0x198] $r1
+fma ftz rn f32 $r2 $r6 c0[0x198] $r2
+fma ftz rn f32 $r3 $r7 c0[0x198] $r3
+add ftz rn f32 $r4 $r8 c0[0x1a0]
+add ftz rn f32 $r5 $r9 c0[0x1a4]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x1a8] $r0
+fma ftz rn f32 $r1 $r5 c0[0x1a8] $r1
+fma ftz rn f32 $r2 $r6 c0[0x1a8] $r2
+fma ftz rn f32 $r3 $r7 c0[0x1a8] $r3
+add ftz rn f32 $r4 $r8 c0[0x1b0]
+add ftz rn f32 $r5 $r9 c0[0x1b4]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x1b8] $r0
+fma ftz rn f32 $r1 $r5 c0[0x1b8] $r1
+fma ftz rn f32 $r2 $r6 c0[0x1b8] $r2
+fma ftz rn f32 $r3 $r7 c0[0x1b8] $r3
+add ftz rn f32 $r4 $r8 c0[0x1c0]
+add ftz rn f32 $r5 $r9 c0[0x1c4]
+tex t lauto live dfp $r4:$r5:$r6:$r7 t2d c[0x0] xy__ $r4:$r5 0x0
+texbar 0x0
+fma ftz rn f32 $r0 $r4 c0[0x1c8] $r0
+fma ftz rn f32 $r1 $r5 c0[0x1c8] $r1
+fma ftz rn f32 $r2 $r6 c0[0x1c8] $r2
+fma ftz rn f32 $r3 $r7 c0[0x1c8] $r3
+exit
+#endif
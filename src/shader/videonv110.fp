@@ -0,0 +1,52 @@
+#ifndef ENVYAS
+static uint32_t
+NV110FP_NV12[] = {
+	0x00001462,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x80000000,
+	0x0000000a,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x00000000,
+	0x0000000f,
+	0x00000000,
+#include "videonv110.fpc"
+};
+#else
+
+sched (st 0x2 wr 0x0) (st 0x2 wr 0x0 wt 0x1) (st 0x1 wr 0x0 rd 0x1 wt 0x1)
+ipa pass $r2 a[0x7c] 0x0 0x0 1
+mufu rcp $r2 $r2
+ipa $r0 a[0x80] $r2 0x0 1
+sched (st 0x2 wr 0x2 rd 0x3) (st 0x2 wr 0x0 rd 0x2 wt 0x5) (st 0x1 wr 0x2 wt 0x4)
+ipa $r1 a[0x84] $r2 0x0 1
+tex t2d #:#:#:$r4 $r0:$r1 0x0
+tex t2d #:#:$r0:$r1 $r0:$r1 0x1
+sched (st 0x6 wt 0x1) (st 0x1) (st 0x1)
+fmul ftz $r5 $r4 c0[0x0]
+fadd ftz $r3 $r5 c0[0x4]
+fadd ftz $r4 $r5 c0[0x8]
+sched (st 0x4) (st 0x1 wt 0x4) (st 0x1)
+fadd ftz $r5 $r5 c0[0xc]
+ffma ftz $r3 $r0 c0[0x10] $r3
+ffma ftz $r4 $r0 c0[0x14] $r4
+sched (st 0x4) (st 0x2) (st 0x1 wt 0xa)
+ffma ftz $r5 $r0 c0[0x18] $r5
+ffma ftz $r0 $r1 c0[0x1c] $r3
+ffma ftz $r2 $r1 c0[0x24] $r5
+sched (st 0x1) (st 0xf wt 0x3f) (st 0xf)
+ffma ftz $r1 $r1 c0[0x20] $r4
+exit
+nop
+#endif
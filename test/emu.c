@@ -0,0 +1,1071 @@
+/*
+ * Copyright 2014 Nouveau Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "emu.h"
+
+#include "hwdefs/nv50_2d.xml.h"
+#include "hwdefs/nv50_defs.xml.h"
+#include "hwdefs/nv_m2mf.xml.h"
+#include "hwdefs/nvc0_m2mf.xml.h"
+
+/* A CPU model of the NV50+ engines behind EXA's solid fills, blits and
+ * transfers
+ *
+ * Every method written to a subchannel lands in a copy of its registers,
+ * and the few methods that make an engine do something read what they
+ * need back from there, which is about how the hardware sees it too.
+ * Only what the driver uses is there: rectangles for the 2D engine, the
+ * SRCCOPY and ROP operations with a mono pattern, blits, SIFC, and
+ * byte-granular copies for M2MF, P2MF and the copy engines.  Whatever
+ * doesn't fit is reported as an error rather than guessed at.
+ *
+ * Pixels are kept in host byte order, which is assumed to be little
+ * endian, as it is on the GPU.
+ *
+ * The tiled layout
+ *
+ * Tiled surfaces are cut into blocks 64 bytes wide and some number of
+ * GOBs high (4 lines each on NV50, 8 on NVC0+, 2^(tile_mode >> 4) of them
+ * per block), stored left to right, then top to bottom, and each block is
+ * stored line by line.  The real thing swizzles bytes inside a GOB and
+ * differs between generations, this doesn't try to.  Nothing looks at
+ * tiled memory except through emu_tiled(), so all that matters is that
+ * every engine (and the CPU) agrees on it, and that a copy which gets the
+ * pitch, block height or position of a surface wrong ends up somewhere
+ * else than it should.
+ */
+
+#define EMU_SUBCS 8
+#define EMU_MTHDS (0x8000 / 4)
+#define EMU_MAX_REPORTS 16
+
+struct emu_surface {
+	uint64_t addr;
+	uint8_t *map;
+	uint64_t size;		/* from map to the end of the bo */
+	bool linear;
+	uint32_t pitch;
+	uint32_t tile_mode;
+};
+
+/* one side of a transfer, x in bytes */
+struct emu_xfer {
+	struct emu_surface s;
+	uint32_t x, y;
+};
+
+struct emu_subc {
+	uint32_t oclass;
+	uint32_t mthd[EMU_MTHDS];
+};
+
+/* M2MF/P2MF data that comes through the FIFO */
+struct emu_stream {
+	bool active;
+	struct emu_xfer dst;
+	uint32_t line_length, line_count;
+	uint32_t col, row;
+};
+
+struct emu_channel {
+	struct nouveau_object *object;
+	struct emu_subc subc[EMU_SUBCS];
+	int points;
+	int64_t point[2];
+	uint32_t sifc_pos;
+	struct emu_stream stream;
+	struct emu_channel *next;
+};
+
+struct emu {
+	bool nvc0;
+	uint32_t gob_height;
+	int errors;
+	struct emu_channel *channels;
+};
+
+#define R(sc, m) ((sc)->mthd[(m) >> 2])
+
+static void
+emu_error(struct emu *emu, const char *fmt, ...)
+{
+	va_list args;
+
+	if (emu->errors++ >= EMU_MAX_REPORTS)
+		return;
+
+	fprintf(stderr, "emu: ");
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+}
+
+static uint64_t
+emu_tiled(struct emu *emu, uint32_t pitch, uint32_t tile_mode,
+	  uint32_t x, uint32_t y)
+{
+	uint32_t block_h = emu->gob_height << ((tile_mode >> 4) & 0xf);
+	uint64_t block = (uint64_t)(y / block_h) * (pitch / 64) + x / 64;
+
+	return block * 64 * block_h + (y % block_h) * 64 + x % 64;
+}
+
+static bool
+emu_surface(struct emu *emu, struct emu_surface *s, uint64_t addr,
+	    bool linear, uint32_t pitch, uint32_t tile_mode)
+{
+	struct nouveau_bo *bo;
+	uint64_t offset;
+
+	bo = mock_bo_find(addr, &offset);
+	if (!bo) {
+		emu_error(emu, "no bo at 0x%010" PRIx64 "\n", addr);
+		return false;
+	}
+
+	if (!linear && (pitch & 63)) {
+		emu_error(emu, "tiled surface at 0x%010" PRIx64 " has a "
+			  "pitch of %u\n", addr, pitch);
+		return false;
+	}
+
+	nouveau_bo_map(bo, 0, NULL);
+	s->addr = addr;
+	s->map = (uint8_t *)bo->map + offset;
+	s->size = bo->size - offset;
+	s->linear = linear;
+	s->pitch = pitch;
+	s->tile_mode = tile_mode;
+	return true;
+}
+
+/* Host address of byte x of line y of a surface, *len is trimmed to the
+ * number of bytes that are contiguous from there.
+ */
+static uint8_t *
+emu_span(struct emu *emu, const struct emu_surface *s, uint32_t x, uint32_t y,
+	 uint32_t *len)
+{
+	uint64_t offset;
+
+	if (s->linear) {
+		offset = (uint64_t)y * s->pitch + x;
+	} else {
+		offset = emu_tiled(emu, s->pitch, s->tile_mode, x, y);
+		if (*len > 64 - x % 64)
+			*len = 64 - x % 64;
+	}
+
+	if (offset + *len > s->size) {
+		emu_error(emu, "%s access to (%u, %u) at 0x%010" PRIx64
+			  " is past the end of the bo\n",
+			  s->linear ? "linear" : "tiled", x, y,
+			  s->addr + offset);
+		return NULL;
+	}
+
+	return s->map + offset;
+}
+
+static void
+emu_copy(struct emu *emu, const struct emu_xfer *src,
+	 const struct emu_xfer *dst, uint32_t w, uint32_t h)
+{
+	uint32_t x, y;
+
+	for (y = 0; y < h; y++) {
+		for (x = 0; x < w; ) {
+			uint32_t n = w - x;
+			uint8_t *s, *d;
+
+			s = emu_span(emu, &src->s, src->x + x, src->y + y, &n);
+			d = emu_span(emu, &dst->s, dst->x + x, dst->y + y, &n);
+			if (!s || !d)
+				return;
+
+			memmove(d, s, n);
+			x += n;
+		}
+	}
+}
+
+static void
+emu_stream_begin(struct emu *emu, struct emu_channel *ch,
+		 const struct emu_xfer *dst, uint32_t line_length,
+		 uint32_t line_count)
+{
+	struct emu_stream *st = &ch->stream;
+
+	if (st->active)
+		emu_error(emu, "transfer started with %u lines of the "
+			  "last one left\n", st->line_count - st->row);
+
+	st->active = line_length && line_count;
+	st->dst = *dst;
+	st->line_length = line_length;
+	st->line_count = line_count;
+	st->col = st->row = 0;
+}
+
+/* each line starts on a new dword, the rest of the last one is dropped */
+static void
+emu_stream_data(struct emu *emu, struct emu_channel *ch, uint32_t data)
+{
+	struct emu_stream *st = &ch->stream;
+	int i;
+
+	if (!st->active) {
+		emu_error(emu, "data 0x%08x outside of a transfer\n", data);
+		return;
+	}
+
+	for (i = 0; i < 4 && st->col + i < st->line_length; i++) {
+		uint32_t n = 1;
+		uint8_t *d = emu_span(emu, &st->dst.s, st->dst.x + st->col + i,
+				      st->dst.y + st->row, &n);
+		if (d)
+			*d = data >> (i * 8);
+	}
+
+	st->col += 4;
+	if (st->col >= st->line_length) {
+		st->col = 0;
+		if (++st->row == st->line_count)
+			st->active = false;
+	}
+}
+
+/*
+ * 2D
+ */
+
+static int
+emu_2d_cpp(uint32_t format)
+{
+	switch (format) {
+	case NV50_SURFACE_FORMAT_BGRA8_UNORM:
+	case NV50_SURFACE_FORMAT_BGRX8_UNORM:
+	case NV50_SURFACE_FORMAT_RGBA8_UNORM:
+	case NV50_SURFACE_FORMAT_RGBX8_UNORM:
+	case NV50_SURFACE_FORMAT_RGB10_A2_UNORM:
+	case NV50_SURFACE_FORMAT_BGR10_A2_UNORM:
+		return 4;
+	case NV50_SURFACE_FORMAT_B5G6R5_UNORM:
+	case NV50_SURFACE_FORMAT_BGR5_A1_UNORM:
+	case NV50_SURFACE_FORMAT_BGR5_X1_UNORM:
+		return 2;
+	case NV50_SURFACE_FORMAT_R8_UNORM:
+	case NV50_SURFACE_FORMAT_A8_UNORM:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/* DST_FORMAT or SRC_FORMAT and the methods after it */
+static bool
+emu_2d_surface(struct emu *emu, struct emu_subc *sc, uint32_t base,
+	       struct emu_surface *s, int *cpp, uint32_t *w, uint32_t *h)
+{
+	uint32_t format = R(sc, base);
+	uint64_t addr = ((uint64_t)R(sc, base + 0x20) << 32) |
+			R(sc, base + 0x24);
+	bool linear = R(sc, base + 0x04) & 1;
+	uint32_t pitch;
+
+	*cpp = emu_2d_cpp(format);
+	if (!*cpp) {
+		emu_error(emu, "2D surface format 0x%02x\n", format);
+		return false;
+	}
+
+	*w = R(sc, base + 0x18);
+	*h = R(sc, base + 0x1c);
+
+	/* a tiled surface's pitch comes from its width */
+	if (linear)
+		pitch = R(sc, base + 0x14);
+	else
+		pitch = (*w * *cpp + 63) & ~63;
+
+	return emu_surface(emu, s, addr, linear, pitch, R(sc, base + 0x08));
+}
+
+/* the destination surface, clipped: x1, y1, x2, y2 */
+static bool
+emu_2d_dst(struct emu *emu, struct emu_subc *sc, struct emu_surface *s,
+	   int *cpp, int64_t clip[4])
+{
+	uint32_t w, h;
+
+	if (!emu_2d_surface(emu, sc, NV50_2D_DST_FORMAT, s, cpp, &w, &h))
+		return false;
+
+	clip[0] = 0;
+	clip[1] = 0;
+	clip[2] = w;
+	clip[3] = h;
+
+	if (R(sc, NV50_2D_CLIP_ENABLE)) {
+		int64_t x1 = (int32_t)R(sc, NV50_2D_CLIP_X);
+		int64_t y1 = (int32_t)R(sc, NV50_2D_CLIP_Y);
+		int64_t x2 = x1 + R(sc, NV50_2D_CLIP_W);
+		int64_t y2 = y1 + R(sc, NV50_2D_CLIP_H);
+
+		if (clip[0] < x1) clip[0] = x1;
+		if (clip[1] < y1) clip[1] = y1;
+		if (clip[2] > x2) clip[2] = x2;
+		if (clip[3] > y2) clip[3] = y2;
+	}
+
+	return true;
+}
+
+/* the _AND variants combine with a beta the driver never sets */
+static bool
+emu_2d_operation(struct emu *emu, struct emu_subc *sc, bool *rop)
+{
+	switch (R(sc, NV50_2D_OPERATION)) {
+	case NV50_2D_OPERATION_SRCCOPY_AND:
+	case NV50_2D_OPERATION_SRCCOPY:
+		*rop = false;
+		return true;
+	case NV50_2D_OPERATION_ROP_AND:
+	case NV50_2D_OPERATION_ROP:
+		*rop = true;
+		return true;
+	default:
+		emu_error(emu, "2D operation %u\n", R(sc, NV50_2D_OPERATION));
+		return false;
+	}
+}
+
+/* a ROP3 on pattern, source and destination, the pattern being the 8x8
+ * mono bitmap, bit y * 8 + x picking PATTERN_COLOR(1) over (0)
+ */
+static uint32_t
+emu_2d_rop(struct emu_subc *sc, int64_t x, int64_t y, uint32_t s, uint32_t d)
+{
+	uint64_t bitmap = ((uint64_t)R(sc, NV50_2D_PATTERN_BITMAP(1)) << 32) |
+			  R(sc, NV50_2D_PATTERN_BITMAP(0));
+	uint32_t rop = R(sc, NV50_2D_ROP) & 0xff;
+	uint32_t p, r = 0;
+	int i;
+
+	if ((bitmap >> ((y & 7) * 8 + (x & 7))) & 1)
+		p = R(sc, NV50_2D_PATTERN_COLOR(1));
+	else
+		p = R(sc, NV50_2D_PATTERN_COLOR(0));
+
+	for (i = 0; i < 8; i++) {
+		if (rop & (1 << i))
+			r |= ((i & 4) ? p : ~p) & ((i & 2) ? s : ~s) &
+			     ((i & 1) ? d : ~d);
+	}
+
+	return r;
+}
+
+static void
+emu_2d_put(struct emu *emu, struct emu_subc *sc, const struct emu_surface *s,
+	   int cpp, bool rop, int64_t x, int64_t y, uint32_t src)
+{
+	uint32_t n = cpp, dst = 0;
+	uint8_t *d;
+
+	d = emu_span(emu, s, x * cpp, y, &n);
+	if (!d)
+		return;
+
+	if (rop) {
+		memcpy(&dst, d, cpp);
+		src = emu_2d_rop(sc, x, y, src, dst);
+	}
+	memcpy(d, &src, cpp);
+}
+
+static void
+emu_2d_rect(struct emu *emu, struct emu_subc *sc, int64_t x1, int64_t y1,
+	    int64_t x2, int64_t y2)
+{
+	struct emu_surface s;
+	int64_t clip[4], x, y, t;
+	int cpp;
+	bool rop;
+
+	if (R(sc, NV50_2D_DRAW_SHAPE) != NV50_2D_DRAW_SHAPE_RECTANGLES) {
+		emu_error(emu, "2D draw shape %u\n", R(sc, NV50_2D_DRAW_SHAPE));
+		return;
+	}
+
+	if (!emu_2d_dst(emu, sc, &s, &cpp, clip) ||
+	    !emu_2d_operation(emu, sc, &rop))
+		return;
+
+	if (x1 > x2) { t = x1; x1 = x2; x2 = t; }
+	if (y1 > y2) { t = y1; y1 = y2; y2 = t; }
+	if (x1 < clip[0]) x1 = clip[0];
+	if (y1 < clip[1]) y1 = clip[1];
+	if (x2 > clip[2]) x2 = clip[2];
+	if (y2 > clip[3]) y2 = clip[3];
+
+	for (y = y1; y < y2; y++) {
+		for (x = x1; x < x2; x++)
+			emu_2d_put(emu, sc, &s, cpp, rop, x, y,
+				   R(sc, NV50_2D_DRAW_COLOR));
+	}
+}
+
+/* each pair of points is a rectangle, the second one exclusive */
+static void
+emu_2d_point(struct emu *emu, struct emu_channel *ch, struct emu_subc *sc,
+	     uint32_t mthd)
+{
+	int64_t x = (int32_t)R(sc, mthd - 4);
+	int64_t y = (int32_t)R(sc, mthd);
+
+	if (!(ch->points++ & 1)) {
+		ch->point[0] = x;
+		ch->point[1] = y;
+		return;
+	}
+
+	emu_2d_rect(emu, sc, ch->point[0], ch->point[1], x, y);
+}
+
+static int64_t
+emu_fixed(struct emu_subc *sc, uint32_t fract, uint32_t integer)
+{
+	return (int64_t)((uint64_t)R(sc, integer) << 32) + R(sc, fract);
+}
+
+/* point sampled, the source read before anything's written so overlapping
+ * blits within a surface come out right
+ */
+static void
+emu_2d_blit(struct emu *emu, struct emu_subc *sc)
+{
+	int64_t du = emu_fixed(sc, NV50_2D_BLIT_DU_DX_FRACT,
+			       NV50_2D_BLIT_DU_DX_INT);
+	int64_t dv = emu_fixed(sc, NV50_2D_BLIT_DV_DY_FRACT,
+			       NV50_2D_BLIT_DV_DY_INT);
+	int64_t u = emu_fixed(sc, NV50_2D_BLIT_SRC_X_FRACT,
+			      NV50_2D_BLIT_SRC_X_INT);
+	int64_t v = emu_fixed(sc, NV50_2D_BLIT_SRC_Y_FRACT,
+			      NV50_2D_BLIT_SRC_Y_INT);
+	int64_t dx = (int32_t)R(sc, NV50_2D_BLIT_DST_X);
+	int64_t dy = (int32_t)R(sc, NV50_2D_BLIT_DST_Y);
+	uint32_t w = R(sc, NV50_2D_BLIT_DST_W);
+	uint32_t h = R(sc, NV50_2D_BLIT_DST_H);
+	struct emu_surface src, dst;
+	uint32_t sw, sh, x, y, *tmp;
+	int64_t clip[4];
+	int cpp, src_cpp;
+	bool rop;
+
+	if (!emu_2d_surface(emu, sc, NV50_2D_SRC_FORMAT, &src, &src_cpp,
+			    &sw, &sh) ||
+	    !emu_2d_dst(emu, sc, &dst, &cpp, clip) ||
+	    !emu_2d_operation(emu, sc, &rop))
+		return;
+
+	if (cpp != src_cpp) {
+		emu_error(emu, "blit from %d to %d bytes per pixel\n",
+			  src_cpp, cpp);
+		return;
+	}
+
+	tmp = calloc((size_t)w * h, sizeof(*tmp));
+	if (!tmp && w && h) {
+		emu_error(emu, "out of memory for a %ux%u blit\n", w, h);
+		return;
+	}
+
+	for (y = 0; y < h; y++) {
+		int64_t sy = (v + y * dv) >> 32;
+
+		for (x = 0; x < w; x++) {
+			int64_t sx = (u + x * du) >> 32;
+			uint32_t n = cpp;
+			uint8_t *s;
+
+			if (sx < 0 || sy < 0 || sx >= sw || sy >= sh) {
+				emu_error(emu, "blit source (%" PRId64 ", %"
+					  PRId64 ") outside of %ux%u\n",
+					  sx, sy, sw, sh);
+				goto out;
+			}
+
+			s = emu_span(emu, &src, sx * cpp, sy, &n);
+			if (!s)
+				goto out;
+			memcpy(&tmp[y * w + x], s, cpp);
+		}
+	}
+
+	for (y = 0; y < h; y++) {
+		if (dy + y < clip[1] || dy + y >= clip[3])
+			continue;
+
+		for (x = 0; x < w; x++) {
+			if (dx + x < clip[0] || dx + x >= clip[2])
+				continue;
+
+			emu_2d_put(emu, sc, &dst, cpp, rop, dx + x, dy + y,
+				   tmp[y * w + x]);
+		}
+	}
+
+out:
+	free(tmp);
+}
+
+static void
+emu_2d_sifc_begin(struct emu *emu, struct emu_channel *ch,
+		  struct emu_subc *sc)
+{
+	ch->sifc_pos = 0;
+
+	if (R(sc, NV50_2D_SIFC_BITMAP_ENABLE))
+		emu_error(emu, "SIFC bitmaps\n");
+	if (R(sc, NV50_2D_SIFC_DX_DU_FRACT) || R(sc, NV50_2D_SIFC_DX_DU_INT) != 1 ||
+	    R(sc, NV50_2D_SIFC_DY_DV_FRACT) || R(sc, NV50_2D_SIFC_DY_DV_INT) != 1)
+		emu_error(emu, "scaled SIFC\n");
+	if (R(sc, NV50_2D_SIFC_DST_X_FRACT) || R(sc, NV50_2D_SIFC_DST_Y_FRACT))
+		emu_error(emu, "SIFC at a fractional position\n");
+}
+
+/* pixels are packed, SIFC_WIDTH of them to a line */
+static void
+emu_2d_sifc_data(struct emu *emu, struct emu_channel *ch, struct emu_subc *sc,
+		 uint32_t data)
+{
+	uint32_t width = R(sc, NV50_2D_SIFC_WIDTH);
+	uint32_t height = R(sc, NV50_2D_SIFC_HEIGHT);
+	int64_t x0 = (int32_t)R(sc, NV50_2D_SIFC_DST_X_INT);
+	int64_t y0 = (int32_t)R(sc, NV50_2D_SIFC_DST_Y_INT);
+	int cpp = emu_2d_cpp(R(sc, NV50_2D_SIFC_FORMAT));
+	struct emu_surface s;
+	int64_t clip[4];
+	int dst_cpp, i;
+	bool rop;
+
+	if (!cpp) {
+		emu_error(emu, "SIFC format 0x%02x\n",
+			  R(sc, NV50_2D_SIFC_FORMAT));
+		return;
+	}
+
+	if (!emu_2d_dst(emu, sc, &s, &dst_cpp, clip) ||
+	    !emu_2d_operation(emu, sc, &rop))
+		return;
+
+	if (cpp != dst_cpp) {
+		emu_error(emu, "SIFC from %d to %d bytes per pixel\n",
+			  cpp, dst_cpp);
+		return;
+	}
+
+	for (i = 0; i < 4; i += cpp) {
+		uint32_t pos = ch->sifc_pos++;
+		uint32_t pixel = data >> (i * 8);
+		int64_t x, y;
+
+		if (!width || pos / width >= height) {
+			emu_error(emu, "SIFC data past the end of %ux%u\n",
+				  width, height);
+			return;
+		}
+
+		x = x0 + pos % width;
+		y = y0 + pos / width;
+
+		if (x < clip[0] || x >= clip[2] || y < clip[1] || y >= clip[3])
+			continue;
+		emu_2d_put(emu, sc, &s, cpp, rop, x, y, pixel);
+	}
+}
+
+static void
+emu_2d(struct emu *emu, struct emu_channel *ch, struct emu_subc *sc,
+       uint32_t mthd, uint32_t data)
+{
+	if (mthd >= NV50_2D_DRAW_POINT32_X(0) &&
+	    mthd < NV50_2D_DRAW_POINT32_X(NV50_2D_DRAW_POINT32_X__LEN)) {
+		if (mthd & 4)
+			emu_2d_point(emu, ch, sc, mthd);
+		return;
+	}
+
+	switch (mthd) {
+	case NV50_2D_DRAW_SHAPE:
+		ch->points = 0;
+		break;
+	case NV50_2D_BLIT_SRC_Y_INT:
+		emu_2d_blit(emu, sc);
+		break;
+	case NV50_2D_SIFC_DST_Y_INT:
+		emu_2d_sifc_begin(emu, ch, sc);
+		break;
+	case NV50_2D_SIFC_DATA:
+		emu_2d_sifc_data(emu, ch, sc, data);
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * M2MF, P2MF and the copy engines
+ */
+
+static bool
+emu_xfer(struct emu *emu, struct emu_xfer *xfer, uint64_t addr, bool linear,
+	 uint32_t pitch, uint32_t tile_mode, uint32_t x, uint32_t y)
+{
+	/* linear ones have the position added to the address already */
+	xfer->x = linear ? 0 : x;
+	xfer->y = linear ? 0 : y;
+	return emu_surface(emu, &xfer->s, addr, linear, pitch, tile_mode);
+}
+
+/* the transfer starts with a write to BUF_NOTIFY */
+static void
+emu_m2mf_nv50(struct emu *emu, struct emu_subc *sc, uint32_t mthd)
+{
+	bool linear_in = R(sc, NV50_M2MF_LINEAR_IN) & 1;
+	bool linear_out = R(sc, NV50_M2MF_LINEAR_OUT) & 1;
+	uint32_t pos_in = R(sc, NV50_M2MF_TILING_POSITION_IN);
+	uint32_t pos_out = R(sc, NV50_M2MF_TILING_POSITION_OUT);
+	struct emu_xfer src, dst;
+
+	if (mthd != NV03_M2MF_BUF_NOTIFY)
+		return;
+
+	if (R(sc, NV03_M2MF_FORMAT) != 0x101) {
+		emu_error(emu, "M2MF format 0x%x\n", R(sc, NV03_M2MF_FORMAT));
+		return;
+	}
+
+	if (!emu_xfer(emu, &src,
+		      ((uint64_t)R(sc, NV50_M2MF_OFFSET_IN_HIGH) << 32) |
+		      R(sc, NV03_M2MF_OFFSET_IN), linear_in,
+		      linear_in ? R(sc, NV03_M2MF_PITCH_IN) :
+				  R(sc, NV50_M2MF_TILING_PITCH_IN),
+		      R(sc, NV50_M2MF_TILING_MODE_IN),
+		      pos_in & 0xffff, pos_in >> 16) ||
+	    !emu_xfer(emu, &dst,
+		      ((uint64_t)R(sc, NV50_M2MF_OFFSET_OUT_HIGH) << 32) |
+		      R(sc, NV03_M2MF_OFFSET_OUT), linear_out,
+		      linear_out ? R(sc, NV03_M2MF_PITCH_OUT) :
+				   R(sc, NV50_M2MF_TILING_PITCH_OUT),
+		      R(sc, NV50_M2MF_TILING_MODE_OUT),
+		      pos_out & 0xffff, pos_out >> 16))
+		return;
+
+	emu_copy(emu, &src, &dst, R(sc, NV03_M2MF_LINE_LENGTH_IN),
+		 R(sc, NV03_M2MF_LINE_COUNT));
+}
+
+static void
+emu_m2mf_nvc0(struct emu *emu, struct emu_channel *ch, struct emu_subc *sc,
+	      uint32_t mthd, uint32_t data)
+{
+	bool linear_in = data & NVC0_M2MF_EXEC_LINEAR_IN;
+	bool linear_out = data & NVC0_M2MF_EXEC_LINEAR_OUT;
+	struct emu_xfer src, dst;
+
+	if (mthd == NVC0_M2MF_DATA) {
+		emu_stream_data(emu, ch, data);
+		return;
+	}
+
+	if (mthd != NVC0_M2MF_EXEC)
+		return;
+
+	if (!emu_xfer(emu, &dst,
+		      ((uint64_t)R(sc, NVC0_M2MF_OFFSET_OUT_HIGH) << 32) |
+		      R(sc, NVC0_M2MF_OFFSET_OUT_LOW), linear_out,
+		      linear_out ? R(sc, NVC0_M2MF_PITCH_OUT) :
+				   R(sc, NVC0_M2MF_TILING_PITCH_OUT),
+		      R(sc, NVC0_M2MF_TILING_MODE_OUT),
+		      R(sc, NVC0_M2MF_TILING_POSITION_OUT_X),
+		      R(sc, NVC0_M2MF_TILING_POSITION_OUT_Y)))
+		return;
+
+	if (data & NVC0_M2MF_EXEC_PUSH) {
+		emu_stream_begin(emu, ch, &dst, R(sc, NVC0_M2MF_LINE_LENGTH_IN),
+				 R(sc, NVC0_M2MF_LINE_COUNT));
+		return;
+	}
+
+	if (!emu_xfer(emu, &src,
+		      ((uint64_t)R(sc, NVC0_M2MF_OFFSET_IN_HIGH) << 32) |
+		      R(sc, NVC0_M2MF_OFFSET_IN_LOW), linear_in,
+		      linear_in ? R(sc, NVC0_M2MF_PITCH_IN) :
+				  R(sc, NVC0_M2MF_TILING_PITCH_IN),
+		      R(sc, NVC0_M2MF_TILING_MODE_IN),
+		      R(sc, NVC0_M2MF_TILING_POSITION_IN_X),
+		      R(sc, NVC0_M2MF_TILING_POSITION_IN_Y)))
+		return;
+
+	emu_copy(emu, &src, &dst, R(sc, NVC0_M2MF_LINE_LENGTH_IN),
+		 R(sc, NVC0_M2MF_LINE_COUNT));
+}
+
+/* 0x180: line length, line count, address high/low, pitch
+ * 0x1b0: exec (bit 0: linear), 0x1b4: data
+ *
+ * Only linear destinations, which is all PUSH_DATAu() does.
+ */
+static void
+emu_p2mf(struct emu *emu, struct emu_channel *ch, struct emu_subc *sc,
+	 uint32_t mthd, uint32_t data)
+{
+	struct emu_xfer dst;
+
+	if (mthd == 0x01b4) {
+		emu_stream_data(emu, ch, data);
+		return;
+	}
+
+	if (mthd != 0x01b0)
+		return;
+
+	if (!(data & 0x00000001)) {
+		emu_error(emu, "P2MF to a tiled surface\n");
+		return;
+	}
+
+	if (!emu_xfer(emu, &dst, ((uint64_t)R(sc, 0x0188) << 32) |
+		      R(sc, 0x018c), true, R(sc, 0x0190), 0, 0, 0))
+		return;
+
+	emu_stream_begin(emu, ch, &dst, R(sc, 0x0180), R(sc, 0x0184));
+}
+
+/* 0x200: src tile mode, pitch, height, depth, layer, x (bytes), y
+ * 0x220: the same for dst
+ * 0x300: exec (0x10: src linear, 0x100: dst linear)
+ * 0x30c: src address high/low, dst address high/low, src pitch, dst pitch,
+ *	  line length, line count
+ */
+static void
+emu_copy85b5(struct emu *emu, struct emu_subc *sc, uint32_t mthd,
+	     uint32_t data)
+{
+	bool linear_in = data & 0x00000010;
+	bool linear_out = data & 0x00000100;
+	struct emu_xfer src, dst;
+
+	if (mthd != 0x0300)
+		return;
+
+	if (!emu_xfer(emu, &src, ((uint64_t)R(sc, 0x030c) << 32) |
+		      R(sc, 0x0310), linear_in,
+		      linear_in ? R(sc, 0x031c) : R(sc, 0x0204),
+		      R(sc, 0x0200), R(sc, 0x0214), R(sc, 0x0218)) ||
+	    !emu_xfer(emu, &dst, ((uint64_t)R(sc, 0x0314) << 32) |
+		      R(sc, 0x0318), linear_out,
+		      linear_out ? R(sc, 0x0320) : R(sc, 0x0224),
+		      R(sc, 0x0220), R(sc, 0x0234), R(sc, 0x0238)))
+		return;
+
+	emu_copy(emu, &src, &dst, R(sc, 0x0324), R(sc, 0x0328));
+}
+
+/* 0x300: exec (0x80: src linear, 0x100: dst linear)
+ * 0x400: src address high/low, dst address high/low, src pitch, dst pitch,
+ *	  line length, line count
+ * 0x70c: dst block size, pitch, height, depth, layer, position (y << 16 | x)
+ * 0x728: the same for src
+ */
+static void
+emu_copya0b5(struct emu *emu, struct emu_subc *sc, uint32_t mthd,
+	     uint32_t data)
+{
+	bool linear_in = data & 0x00000080;
+	bool linear_out = data & 0x00000100;
+	struct emu_xfer src, dst;
+
+	if (mthd != 0x0300)
+		return;
+
+	if (!emu_xfer(emu, &src, ((uint64_t)R(sc, 0x0400) << 32) |
+		      R(sc, 0x0404), linear_in,
+		      linear_in ? R(sc, 0x0410) : R(sc, 0x072c),
+		      R(sc, 0x0728), R(sc, 0x073c) & 0xffff,
+		      R(sc, 0x073c) >> 16) ||
+	    !emu_xfer(emu, &dst, ((uint64_t)R(sc, 0x0408) << 32) |
+		      R(sc, 0x040c), linear_out,
+		      linear_out ? R(sc, 0x0414) : R(sc, 0x0710),
+		      R(sc, 0x070c), R(sc, 0x0720) & 0xffff,
+		      R(sc, 0x0720) >> 16))
+		return;
+
+	emu_copy(emu, &src, &dst, R(sc, 0x0418), R(sc, 0x041c));
+}
+
+/*
+ * Command stream
+ */
+
+static struct emu_channel *
+emu_channel(struct emu *emu, struct nouveau_object *object)
+{
+	struct emu_channel *ch;
+
+	for (ch = emu->channels; ch; ch = ch->next) {
+		if (ch->object == object)
+			return ch;
+	}
+
+	ch = calloc(1, sizeof(*ch));
+	if (!ch)
+		return NULL;
+
+	ch->object = object;
+	ch->next = emu->channels;
+	emu->channels = ch;
+	return ch;
+}
+
+static void
+emu_method(struct emu *emu, struct emu_channel *ch, int subc, uint32_t mthd,
+	   uint32_t data)
+{
+	struct emu_subc *sc = &ch->subc[subc];
+
+	if (mthd >= EMU_MTHDS * 4) {
+		emu_error(emu, "method 0x%04x on subchannel %d\n", mthd, subc);
+		return;
+	}
+
+	if (mthd == 0x0000) {
+		struct nouveau_object *obj = mock_object_find(ch->object, data);
+
+		sc->oclass = obj ? obj->oclass : data;
+		return;
+	}
+
+	sc->mthd[mthd >> 2] = data;
+
+	switch (sc->oclass) {
+	case 0x502d:
+	case 0x902d:
+		emu_2d(emu, ch, sc, mthd, data);
+		break;
+	case 0x5039:
+		emu_m2mf_nv50(emu, sc, mthd);
+		break;
+	case 0x9039:
+		emu_m2mf_nvc0(emu, ch, sc, mthd, data);
+		break;
+	case 0xa040:
+	case 0xa140:
+		emu_p2mf(emu, ch, sc, mthd, data);
+		break;
+	case 0x85b5:
+	case 0x90b5:
+		emu_copy85b5(emu, sc, mthd, data);
+		break;
+	case 0xa0b5:
+		emu_copya0b5(emu, sc, mthd, data);
+		break;
+	default:
+		break;
+	}
+}
+
+static void
+emu_sink(void *priv, struct nouveau_pushbuf *push, const uint32_t *p,
+	 const uint32_t *end)
+{
+	struct emu *emu = priv;
+	struct emu_channel *ch = emu_channel(emu, push->channel);
+
+	if (!ch) {
+		emu_error(emu, "out of memory for a channel\n");
+		return;
+	}
+
+	while (p < end) {
+		uint32_t hdr = *p++;
+		int subc = (hdr >> 13) & 7;
+		uint32_t mthd, size, incr, i;
+
+		if (emu->nvc0) {
+			mthd = (hdr & 0x1fff) << 2;
+			size = (hdr >> 16) & 0x1fff;
+
+			switch (hdr >> 29) {
+			case 1: incr = size; break;
+			case 3: incr = 0; break;
+			case 5: incr = 1; break;
+			case 4:
+				emu_method(emu, ch, subc, mthd, size);
+				continue;
+			default:
+				emu_error(emu, "header 0x%08x\n", hdr);
+				return;
+			}
+		} else {
+			mthd = hdr & 0x1ffc;
+			size = (hdr >> 18) & 0x7ff;
+
+			switch (hdr & 0xe0000003) {
+			case 0x00000000: incr = size; break;
+			case 0x40000000: incr = 0; break;
+			default:
+				emu_error(emu, "header 0x%08x\n", hdr);
+				return;
+			}
+		}
+
+		if (size > end - p) {
+			emu_error(emu, "header 0x%08x runs past the end of "
+				  "the submission\n", hdr);
+			return;
+		}
+
+		for (i = 0; i < size; i++)
+			emu_method(emu, ch, subc, mthd + 4 * (i < incr ? i : incr),
+				   *p++);
+	}
+}
+
+struct emu *
+emu_new(uint32_t chipset)
+{
+	struct emu *emu = calloc(1, sizeof(*emu));
+
+	if (!emu)
+		return NULL;
+
+	emu->nvc0 = chipset >= 0xc0;
+	emu->gob_height = emu->nvc0 ? 8 : 4;
+	mock_set_sink(emu_sink, emu);
+	return emu;
+}
+
+void
+emu_del(struct emu **pemu)
+{
+	struct emu *emu = *pemu;
+
+	if (!emu)
+		return;
+
+	mock_set_sink(NULL, NULL);
+	while (emu->channels) {
+		struct emu_channel *ch = emu->channels;
+
+		emu->channels = ch->next;
+		free(ch);
+	}
+
+	free(emu);
+	*pemu = NULL;
+}
+
+int
+emu_errors(struct emu *emu)
+{
+	return emu->errors;
+}
+
+static bool
+emu_bo_surface(struct emu *emu, struct nouveau_bo *bo, uint32_t offset,
+	       uint32_t pitch, struct emu_surface *s)
+{
+	bool tiled;
+	uint32_t tile_mode;
+
+	if (emu->nvc0) {
+		tiled = bo->config.nvc0.memtype != 0;
+		tile_mode = bo->config.nvc0.tile_mode;
+	} else {
+		tiled = bo->config.nv50.memtype != 0;
+		tile_mode = bo->config.nv50.tile_mode;
+	}
+
+	return emu_surface(emu, s, bo->offset + offset, !tiled, pitch,
+			   tile_mode);
+}
+
+void
+emu_read(struct emu *emu, struct nouveau_bo *bo, uint32_t offset,
+	 uint32_t pitch, int x, int y, int w, int h, void *dst, int dst_pitch)
+{
+	struct emu_surface s;
+	int i, j;
+
+	if (!emu_bo_surface(emu, bo, offset, pitch, &s))
+		return;
+
+	for (j = 0; j < h; j++) {
+		uint8_t *d = (uint8_t *)dst + j * dst_pitch;
+
+		for (i = 0; i < w; ) {
+			uint32_t n = w - i;
+			uint8_t *p = emu_span(emu, &s, x + i, y + j, &n);
+
+			if (!p)
+				return;
+			memcpy(d + i, p, n);
+			i += n;
+		}
+	}
+}
+
+void
+emu_write(struct emu *emu, struct nouveau_bo *bo, uint32_t offset,
+	  uint32_t pitch, int x, int y, int w, int h, const void *src,
+	  int src_pitch)
+{
+	struct emu_surface s;
+	int i, j;
+
+	if (!emu_bo_surface(emu, bo, offset, pitch, &s))
+		return;
+
+	for (j = 0; j < h; j++) {
+		const uint8_t *d = (const uint8_t *)src + j * src_pitch;
+
+		for (i = 0; i < w; ) {
+			uint32_t n = w - i;
+			uint8_t *p = emu_span(emu, &s, x + i, y + j, &n);
+
+			if (!p)
+				return;
+			memcpy(p, d + i, n);
+			i += n;
+		}
+	}
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2014 Nouveau Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __NOUVEAU_EMU_H__
+#define __NOUVEAU_EMU_H__
+
+#include "mock.h"
+
+/* Executes what's submitted to the mock channels on the CPU, into the
+ * memory of the mock bos.  Only the NV50+ engines EXA's hooks use for
+ * solid fills, blits and transfers are there: 2D, M2MF, P2MF and the copy
+ * engines.  Anything else (3D, software methods) is ignored.
+ *
+ * Hooks into the mock's sink, there can be only one at a time, and it
+ * has to be there before the channels are so it sees objects bound.
+ */
+struct emu;
+
+struct emu *emu_new(uint32_t chipset);
+void emu_del(struct emu **);
+
+/* Number of things the emulator couldn't make sense of so far, each is
+ * also printed when it happens.
+ */
+int emu_errors(struct emu *);
+
+/* Read or write a rectangle of a bo directly, through the same tiled
+ * layout the engines use (the bo's memtype says whether it's tiled).
+ * x and w are in bytes.
+ */
+void emu_read(struct emu *, struct nouveau_bo *, uint32_t offset,
+	      uint32_t pitch, int x, int y, int w, int h,
+	      void *dst, int dst_pitch);
+void emu_write(struct emu *, struct nouveau_bo *, uint32_t offset,
+	       uint32_t pitch, int x, int y, int w, int h,
+	       const void *src, int src_pitch);
+
+#endif
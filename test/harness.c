@@ -0,0 +1,262 @@
+/*
+ * Copyright 2014 Nouveau Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "harness.h"
+#include "nouveau_copy.h"
+
+/* The parts of the X server and of EXA that the driver's acceleration code
+ * expects around it: a screen to hang off, pixmaps with driver privates,
+ * and private keys.  Just enough to call the EXA hooks the way EXA would.
+ */
+
+struct harness_pixmap {
+	PixmapRec base;
+	void *priv;
+};
+
+static struct harness *current;
+
+ClientPtr serverClient;
+DevPrivateKeyRec PictureScreenPrivateKeyRec;
+
+ScrnInfoPtr
+xf86ScreenToScrn(ScreenPtr pScreen)
+{
+	return &current->scrn;
+}
+
+void *
+xf86LoadSubModule(ScrnInfoPtr pScrn, const char *name)
+{
+	return pScrn;
+}
+
+Bool
+dixRegisterPrivateKey(DevPrivateKey key, DevPrivateType type, unsigned size)
+{
+	key->initialized = TRUE;
+	key->size = size;
+	key->type = type;
+	return TRUE;
+}
+
+ExaDriverPtr
+exaDriverAlloc(void)
+{
+	return calloc(1, sizeof(ExaDriverRec));
+}
+
+Bool
+exaDriverInit(ScreenPtr pScreen, ExaDriverPtr pScreenInfo)
+{
+	current->exa = pScreenInfo;
+	return TRUE;
+}
+
+void
+exaMarkSync(ScreenPtr pScreen)
+{
+}
+
+void
+exaMoveInPixmap(PixmapPtr pPixmap)
+{
+}
+
+void *
+exaGetPixmapDriverPrivate(PixmapPtr pPixmap)
+{
+	return ((struct harness_pixmap *)pPixmap)->priv;
+}
+
+unsigned long
+exaGetPixmapPitch(PixmapPtr pPixmap)
+{
+	return pPixmap->devKind;
+}
+
+Bool
+exaDrawableIsOffscreen(DrawablePtr pDrawable)
+{
+	return pDrawable->type == DRAWABLE_PIXMAP &&
+	       current->exa->PixmapIsOffscreen((PixmapPtr)pDrawable);
+}
+
+static PixmapPtr
+harness_get_screen_pixmap(ScreenPtr pScreen)
+{
+	return NULL;
+}
+
+static Bool
+harness_create_gc(GCPtr pGC)
+{
+	return TRUE;
+}
+
+static uint32_t
+harness_architecture(uint32_t chipset)
+{
+	switch (chipset & ~0xf) {
+	case 0x00:
+		return NV_ARCH_04;
+	case 0x10:
+		return NV_ARCH_10;
+	case 0x20:
+		return NV_ARCH_20;
+	case 0x30:
+		return NV_ARCH_30;
+	case 0x40:
+	case 0x60:
+		return NV_ARCH_40;
+	case 0x50:
+	case 0x80:
+	case 0x90:
+	case 0xa0:
+		return NV_TESLA;
+	case 0xc0:
+	case 0xd0:
+		return NV_FERMI;
+	case 0xe0:
+	case 0xf0:
+	case 0x100:
+		return NV_KEPLER;
+	default:
+		return NV_MAXWELL;
+	}
+}
+
+Bool
+harness_init(struct harness *h, const char *name, uint32_t chipset, Bool ce)
+{
+	ScrnInfoPtr pScrn = &h->scrn;
+	ScreenPtr pScreen = &h->screen;
+	NVPtr pNv = &h->nv;
+
+	memset(h, 0, sizeof(*h));
+	current = h;
+	h->name = name;
+
+	pScrn->driverPrivate = pNv;
+	pScrn->pScreen = pScreen;
+	pScrn->depth = 24;
+	pScrn->bitsPerPixel = 32;
+	pScrn->virtualX = pScrn->displayWidth = 1024;
+	pScrn->virtualY = 768;
+	pScreen->GetScreenPixmap = harness_get_screen_pixmap;
+	pScreen->CreateGC = harness_create_gc;
+
+	pNv->dev = mock_device_new(chipset);
+	if (!pNv->dev)
+		return FALSE;
+	pNv->client = mock_client_new(pNv->dev);
+	if (!pNv->client)
+		return FALSE;
+
+	pNv->Architecture = harness_architecture(chipset);
+	pNv->AccelMethod = EXA;
+	pNv->ce_enabled = ce;
+
+	if (!NVAccelCommonInit(pScrn))
+		return FALSE;
+	nouveau_copy_init(pScreen);
+	return nouveau_exa_init(pScreen);
+}
+
+void
+harness_fini(struct harness *h)
+{
+	NVPtr pNv = &h->nv;
+
+	nouveau_copy_fini(&h->screen);
+	NVAccelCommonFini(&h->scrn);
+	free(h->exa);
+	mock_client_del(&pNv->client);
+	mock_device_del(&pNv->dev);
+	current = NULL;
+}
+
+PixmapPtr
+harness_pixmap(struct harness *h, int w, int h_, int depth, int usage_hint)
+{
+	struct harness_pixmap *hpix = calloc(1, sizeof(*hpix));
+	PixmapPtr ppix = &hpix->base;
+	int bpp, pitch = 0;
+
+	if (!hpix)
+		return NULL;
+
+	bpp = (depth > 16) ? 32 : (depth > 8) ? 16 : depth;
+	hpix->priv = h->exa->CreatePixmap2(&h->screen, w, h_, depth,
+					   usage_hint, bpp, &pitch);
+	if (!hpix->priv) {
+		free(hpix);
+		return NULL;
+	}
+
+	ppix->drawable.type = DRAWABLE_PIXMAP;
+	ppix->drawable.pScreen = &h->screen;
+	ppix->drawable.width = w;
+	ppix->drawable.height = h_;
+	ppix->drawable.depth = depth;
+	ppix->drawable.bitsPerPixel = bpp;
+	ppix->devKind = pitch;
+	ppix->refcnt = 1;
+	ppix->usage_hint = usage_hint;
+	return ppix;
+}
+
+void
+harness_pixmap_destroy(struct harness *h, PixmapPtr ppix)
+{
+	struct harness_pixmap *hpix = (struct harness_pixmap *)ppix;
+
+	h->exa->DestroyPixmap(&h->screen, hpix->priv);
+	free(hpix);
+}
+
+struct nouveau_bo *
+harness_pixmap_bo(PixmapPtr ppix)
+{
+	return nouveau_pixmap_bo(ppix);
+}
+
+PicturePtr
+harness_picture(PixmapPtr ppix, CARD32 format)
+{
+	PicturePtr ppict = calloc(1, sizeof(*ppict));
+
+	if (!ppict)
+		return NULL;
+
+	ppict->pDrawable = &ppix->drawable;
+	ppict->format = format;
+	ppict->filter = PictFilterNearest;
+	ppict->repeatType = RepeatNone;
+	return ppict;
+}
+
+void
+harness_picture_destroy(PicturePtr ppict)
+{
+	free(ppict);
+}
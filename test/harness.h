@@ -0,0 +1,52 @@
+/*
+ * Copyright 2014 Nouveau Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __NOUVEAU_HARNESS_H__
+#define __NOUVEAU_HARNESS_H__
+
+#include "nv_include.h"
+#include "mock.h"
+
+/* One screen on a mock device, with the channel, the copy engine and EXA
+ * set up the way ScreenInit does it.  Only one can exist at a time.
+ */
+struct harness {
+	const char *name;
+	ScrnInfoRec scrn;
+	ScreenRec screen;
+	NVRec nv;
+	ExaDriverPtr exa;
+};
+
+Bool harness_init(struct harness *, const char *name, uint32_t chipset,
+		  Bool ce);
+void harness_fini(struct harness *);
+
+PixmapPtr harness_pixmap(struct harness *, int w, int h, int depth,
+			 int usage_hint);
+void harness_pixmap_destroy(struct harness *, PixmapPtr);
+struct nouveau_bo *harness_pixmap_bo(PixmapPtr);
+
+PicturePtr harness_picture(PixmapPtr, CARD32 format);
+void harness_picture_destroy(PicturePtr);
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2014 Nouveau Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __NOUVEAU_MOCK_H__
+#define __NOUVEAU_MOCK_H__
+
+#include <stdint.h>
+#include <nouveau.h>
+
+/* What the driver asked libdrm_nouveau to do, summed over all channels.
+ * Dwords are counted when they're submitted, mock_counters_read() adds
+ * the ones still sitting in the pushbufs.
+ */
+struct mock_counters {
+	uint64_t dwords;
+	uint64_t kicks;
+	uint64_t validates;
+	uint64_t relocs;
+};
+
+/* Called for every submission with the dwords of one pushbuf, before
+ * it's reset.  This is the only place the command stream can be seen,
+ * whatever wants to look at it (or execute it) hooks in here.
+ */
+typedef void (*mock_sink)(void *priv, struct nouveau_pushbuf *push,
+			  const uint32_t *p, const uint32_t *end);
+
+struct nouveau_device *mock_device_new(uint32_t chipset);
+void mock_device_del(struct nouveau_device **);
+struct nouveau_client *mock_client_new(struct nouveau_device *);
+void mock_client_del(struct nouveau_client **);
+
+void mock_counters_read(struct mock_counters *);
+void mock_set_sink(mock_sink, void *priv);
+
+/* The bo that's mapped at a GPU virtual address, and the offset into it. */
+struct nouveau_bo *mock_bo_find(uint64_t addr, uint64_t *offset);
+/* The object behind a handle the driver bound to a subchannel, NULL if
+ * there isn't one, in which case the handle is the class (NVC0+).
+ */
+struct nouveau_object *mock_object_find(struct nouveau_object *chan,
+					uint32_t handle);
+
+#endif
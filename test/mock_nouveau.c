@@ -0,0 +1,688 @@
+/*
+ * Copyright 2014 Nouveau Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mock.h"
+
+/* A stand-in for libdrm_nouveau, so the acceleration code can be run
+ * without a GPU, or a kernel.
+ *
+ * Buffer objects are plain host memory, at made up GPU virtual addresses.
+ * Pushbufs are host memory too, submitting one hands its dwords to the
+ * sink (if there is one) and throws them away.  Nothing is executed here,
+ * so nothing is ever busy, waiting only has to submit whatever refers to
+ * the bo, which is what libdrm does before it asks the kernel.
+ *
+ * libdrm's behaviour that shows up in the counters is kept: a pushbuf
+ * that runs out of space is submitted, kick_notify is called for every
+ * submission, and the bufctx bound to a pushbuf is validated again after
+ * each one.
+ */
+
+struct mock_bo {
+	struct nouveau_bo base;
+	int refcnt;
+	void *mem;
+	struct nouveau_pushbuf *pending;
+	struct mock_bo *next;
+};
+
+struct mock_object {
+	struct nouveau_object base;
+	struct mock_object *next;
+};
+
+struct mock_bin {
+	struct nouveau_bufref *refs;
+	int nr, max;
+};
+
+struct mock_bufctx {
+	struct nouveau_bufctx base;
+	struct mock_bin *bin;
+	int bins;
+	struct mock_bufctx *next;
+};
+
+struct mock_pushbuf {
+	struct nouveau_pushbuf base;
+	uint32_t *start;
+	uint32_t size;
+	struct mock_pushbuf *next;
+};
+
+static struct mock_counters counters;
+static mock_sink sink;
+static void *sink_priv;
+
+static struct mock_bo *bos;
+static struct mock_object *objects;
+static struct mock_bufctx *bufctxs;
+static struct mock_pushbuf *pushbufs;
+static uint64_t next_addr = 0x100000;
+static uint32_t next_handle = 1;
+
+static inline struct mock_bo *
+mock_bo(struct nouveau_bo *bo)
+{
+	return (struct mock_bo *)bo;
+}
+
+static inline struct mock_bufctx *
+mock_bufctx(struct nouveau_bufctx *bctx)
+{
+	return (struct mock_bufctx *)bctx;
+}
+
+static inline struct mock_pushbuf *
+mock_pushbuf(struct nouveau_pushbuf *push)
+{
+	return (struct mock_pushbuf *)push;
+}
+
+struct nouveau_device *
+mock_device_new(uint32_t chipset)
+{
+	struct nouveau_device *dev = calloc(1, sizeof(*dev));
+
+	if (!dev)
+		return NULL;
+
+	dev->object.oclass = NOUVEAU_DEVICE_CLASS;
+	dev->fd = -1;
+	dev->drm_version = 0x01000300;
+	dev->chipset = chipset;
+	dev->vram_size = dev->vram_limit = 1024 * 1024 * 1024;
+	dev->gart_size = dev->gart_limit = 512 * 1024 * 1024;
+	return dev;
+}
+
+void
+mock_device_del(struct nouveau_device **pdev)
+{
+	free(*pdev);
+	*pdev = NULL;
+}
+
+struct nouveau_client *
+mock_client_new(struct nouveau_device *dev)
+{
+	struct nouveau_client *client = calloc(1, sizeof(*client));
+
+	if (client)
+		client->device = dev;
+	return client;
+}
+
+void
+mock_client_del(struct nouveau_client **pclient)
+{
+	free(*pclient);
+	*pclient = NULL;
+}
+
+void
+mock_counters_read(struct mock_counters *c)
+{
+	struct mock_pushbuf *mpush;
+
+	*c = counters;
+	for (mpush = pushbufs; mpush; mpush = mpush->next)
+		c->dwords += mpush->base.cur - mpush->start;
+}
+
+void
+mock_set_sink(mock_sink func, void *priv)
+{
+	sink = func;
+	sink_priv = priv;
+}
+
+struct nouveau_bo *
+mock_bo_find(uint64_t addr, uint64_t *offset)
+{
+	struct mock_bo *nvbo;
+
+	for (nvbo = bos; nvbo; nvbo = nvbo->next) {
+		if (addr >= nvbo->base.offset &&
+		    addr < nvbo->base.offset + nvbo->base.size) {
+			*offset = addr - nvbo->base.offset;
+			return &nvbo->base;
+		}
+	}
+
+	return NULL;
+}
+
+struct nouveau_object *
+mock_object_find(struct nouveau_object *chan, uint32_t handle)
+{
+	struct mock_object *obj;
+
+	for (obj = objects; obj; obj = obj->next) {
+		if (obj->base.parent == chan && obj->base.handle == handle)
+			return &obj->base;
+	}
+
+	return NULL;
+}
+
+/*
+ * Objects
+ */
+
+/* the copy engine classes each generation has, everything else exists */
+static bool
+mock_object_supported(struct nouveau_object *parent, uint32_t oclass)
+{
+	struct nouveau_object *dev = parent;
+	uint32_t chipset;
+
+	while (dev->parent)
+		dev = dev->parent;
+	chipset = ((struct nouveau_device *)dev)->chipset;
+
+	switch (oclass) {
+	case 0x85b5:
+		return chipset >= 0xa3 && chipset < 0xc0;
+	case 0x90b5:
+		return chipset >= 0xc0 && chipset < 0xe0;
+	case 0x90b8:
+		return false;
+	case 0xa0b5:
+		return chipset >= 0xe0;
+	default:
+		return true;
+	}
+}
+
+int
+nouveau_object_new(struct nouveau_object *parent, uint64_t handle,
+		   uint32_t oclass, void *data, uint32_t length,
+		   struct nouveau_object **pobj)
+{
+	struct mock_object *obj;
+
+	if (!mock_object_supported(parent, oclass))
+		return -ENODEV;
+
+	obj = calloc(1, sizeof(*obj));
+	if (!obj)
+		return -ENOMEM;
+
+	obj->base.parent = parent;
+	obj->base.handle = handle;
+	obj->base.oclass = oclass;
+	if (length) {
+		obj->base.data = malloc(length);
+		if (!obj->base.data) {
+			free(obj);
+			return -ENOMEM;
+		}
+		memcpy(obj->base.data, data, length);
+		obj->base.length = length;
+	}
+
+	obj->next = objects;
+	objects = obj;
+	*pobj = &obj->base;
+	return 0;
+}
+
+void
+nouveau_object_del(struct nouveau_object **pobj)
+{
+	struct mock_object **pobj_list, *obj = (struct mock_object *)*pobj;
+
+	if (!obj)
+		return;
+
+	for (pobj_list = &objects; *pobj_list; pobj_list = &(*pobj_list)->next) {
+		if (*pobj_list == obj) {
+			*pobj_list = obj->next;
+			break;
+		}
+	}
+
+	free(obj->base.data);
+	free(obj);
+	*pobj = NULL;
+}
+
+/*
+ * Buffer objects
+ */
+
+int
+nouveau_bo_new(struct nouveau_device *dev, uint32_t flags, uint32_t align,
+	       uint64_t size, union nouveau_bo_config *config,
+	       struct nouveau_bo **pbo)
+{
+	struct mock_bo *nvbo;
+
+	if (!size)
+		return -EINVAL;
+
+	nvbo = calloc(1, sizeof(*nvbo));
+	if (!nvbo)
+		return -ENOMEM;
+
+	nvbo->mem = calloc(1, size);
+	if (!nvbo->mem) {
+		free(nvbo);
+		return -ENOMEM;
+	}
+
+	/* big pages, like the kernel uses for anything tiled */
+	next_addr = (next_addr + 0xffff) & ~0xffffULL;
+	nvbo->base.offset = next_addr;
+	next_addr += size;
+
+	nvbo->base.device = dev;
+	nvbo->base.handle = next_handle++;
+	nvbo->base.size = size;
+	nvbo->base.flags = flags;
+	if (config)
+		nvbo->base.config = *config;
+	nvbo->refcnt = 1;
+
+	nvbo->next = bos;
+	bos = nvbo;
+	*pbo = &nvbo->base;
+	return 0;
+}
+
+static void
+mock_bo_del(struct mock_bo *nvbo)
+{
+	struct mock_bufctx *bctx;
+	struct mock_bo **pnvbo;
+	int i, j;
+
+	/* libdrm would trip over these later, make it obvious instead */
+	for (bctx = bufctxs; bctx; bctx = bctx->next) {
+		for (i = 0; i < bctx->bins; i++) {
+			for (j = 0; j < bctx->bin[i].nr; j++) {
+				if (bctx->bin[i].refs[j].bo == &nvbo->base)
+					bctx->bin[i].refs[j].bo = NULL;
+			}
+		}
+	}
+
+	for (pnvbo = &bos; *pnvbo; pnvbo = &(*pnvbo)->next) {
+		if (*pnvbo == nvbo) {
+			*pnvbo = nvbo->next;
+			break;
+		}
+	}
+
+	free(nvbo->mem);
+	free(nvbo);
+}
+
+void
+nouveau_bo_ref(struct nouveau_bo *bo, struct nouveau_bo **pref)
+{
+	struct nouveau_bo *ref = *pref;
+
+	if (bo)
+		mock_bo(bo)->refcnt++;
+	if (ref && --mock_bo(ref)->refcnt == 0)
+		mock_bo_del(mock_bo(ref));
+	*pref = bo;
+}
+
+int
+nouveau_bo_wait(struct nouveau_bo *bo, uint32_t access,
+		struct nouveau_client *client)
+{
+	struct nouveau_pushbuf *push = mock_bo(bo)->pending;
+
+	if (push)
+		nouveau_pushbuf_kick(push, push->channel);
+	return 0;
+}
+
+int
+nouveau_bo_map(struct nouveau_bo *bo, uint32_t access,
+	       struct nouveau_client *client)
+{
+	bo->map = mock_bo(bo)->mem;
+	if (access)
+		return nouveau_bo_wait(bo, access, client);
+	return 0;
+}
+
+int
+nouveau_bo_set_prime(struct nouveau_bo *bo, int *prime_fd)
+{
+	return -ENOSYS;
+}
+
+int
+nouveau_bo_prime_handle_ref(struct nouveau_device *dev, int prime_fd,
+			    struct nouveau_bo **pbo)
+{
+	return -ENOSYS;
+}
+
+/*
+ * Buffer contexts
+ */
+
+int
+nouveau_bufctx_new(struct nouveau_client *client, int bins,
+		   struct nouveau_bufctx **pbctx)
+{
+	struct mock_bufctx *bctx = calloc(1, sizeof(*bctx));
+
+	if (!bctx)
+		return -ENOMEM;
+
+	bctx->bin = calloc(bins, sizeof(*bctx->bin));
+	if (!bctx->bin) {
+		free(bctx);
+		return -ENOMEM;
+	}
+
+	bctx->base.client = client;
+	bctx->bins = bins;
+
+	bctx->next = bufctxs;
+	bufctxs = bctx;
+	*pbctx = &bctx->base;
+	return 0;
+}
+
+void
+nouveau_bufctx_del(struct nouveau_bufctx **pbctx)
+{
+	struct mock_bufctx **pbctx_list, *bctx = mock_bufctx(*pbctx);
+	int i;
+
+	if (!bctx)
+		return;
+
+	for (pbctx_list = &bufctxs; *pbctx_list;
+	     pbctx_list = &(*pbctx_list)->next) {
+		if (*pbctx_list == bctx) {
+			*pbctx_list = bctx->next;
+			break;
+		}
+	}
+
+	for (i = 0; i < bctx->bins; i++)
+		free(bctx->bin[i].refs);
+	free(bctx->bin);
+	free(bctx);
+	*pbctx = NULL;
+}
+
+static struct nouveau_bufref *
+mock_bufctx_add(struct nouveau_bufctx *bctx, int bin, struct nouveau_bo *bo,
+		uint32_t flags)
+{
+	struct mock_bin *b = &mock_bufctx(bctx)->bin[bin];
+	struct nouveau_bufref *ref;
+
+	if (b->nr == b->max) {
+		int max = b->max ? b->max * 2 : 16;
+
+		ref = realloc(b->refs, max * sizeof(*ref));
+		if (!ref)
+			return NULL;
+		b->refs = ref;
+		b->max = max;
+	}
+
+	ref = &b->refs[b->nr++];
+	memset(ref, 0, sizeof(*ref));
+	ref->bo = bo;
+	ref->flags = flags;
+	return ref;
+}
+
+struct nouveau_bufref *
+nouveau_bufctx_refn(struct nouveau_bufctx *bctx, int bin,
+		    struct nouveau_bo *bo, uint32_t flags)
+{
+	return mock_bufctx_add(bctx, bin, bo, flags);
+}
+
+struct nouveau_bufref *
+nouveau_bufctx_mthd(struct nouveau_bufctx *bctx, int bin, uint32_t packet,
+		    struct nouveau_bo *bo, uint64_t data, uint32_t flags,
+		    uint32_t vor, uint32_t tor)
+{
+	struct nouveau_bufref *ref = mock_bufctx_add(bctx, bin, bo, flags);
+
+	if (ref) {
+		ref->packet = packet;
+		ref->data = data;
+		ref->vor = vor;
+		ref->tor = tor;
+	}
+
+	counters.relocs++;
+	return ref;
+}
+
+void
+nouveau_bufctx_reset(struct nouveau_bufctx *bctx, int bin)
+{
+	mock_bufctx(bctx)->bin[bin].nr = 0;
+}
+
+/*
+ * Pushbufs
+ */
+
+int
+nouveau_pushbuf_new(struct nouveau_client *client,
+		    struct nouveau_object *chan, int nr, uint32_t size,
+		    bool immediate, struct nouveau_pushbuf **ppush)
+{
+	struct mock_pushbuf *mpush = calloc(1, sizeof(*mpush));
+
+	if (!mpush)
+		return -ENOMEM;
+
+	mpush->size = size / 4;
+	mpush->start = malloc(mpush->size * 4);
+	if (!mpush->start) {
+		free(mpush);
+		return -ENOMEM;
+	}
+
+	mpush->base.client = client;
+	mpush->base.channel = chan;
+	mpush->base.cur = mpush->start;
+	mpush->base.end = mpush->start + mpush->size;
+
+	mpush->next = pushbufs;
+	pushbufs = mpush;
+	*ppush = &mpush->base;
+	return 0;
+}
+
+void
+nouveau_pushbuf_del(struct nouveau_pushbuf **ppush)
+{
+	struct mock_pushbuf **pmpush, *mpush = mock_pushbuf(*ppush);
+	struct mock_bo *nvbo;
+
+	if (!mpush)
+		return;
+
+	for (nvbo = bos; nvbo; nvbo = nvbo->next) {
+		if (nvbo->pending == &mpush->base)
+			nvbo->pending = NULL;
+	}
+
+	for (pmpush = &pushbufs; *pmpush; pmpush = &(*pmpush)->next) {
+		if (*pmpush == mpush) {
+			*pmpush = mpush->next;
+			break;
+		}
+	}
+
+	free(mpush->start);
+	free(mpush);
+	*ppush = NULL;
+}
+
+/* what libdrm would put on the validation list of the next submission */
+static void
+mock_pushbuf_pend(struct nouveau_pushbuf *push)
+{
+	struct mock_bufctx *bctx = mock_bufctx(push->bufctx);
+	int i, j;
+
+	if (!bctx)
+		return;
+
+	for (i = 0; i < bctx->bins; i++) {
+		for (j = 0; j < bctx->bin[i].nr; j++) {
+			struct nouveau_bo *bo = bctx->bin[i].refs[j].bo;
+
+			if (!bo)
+				abort();
+			mock_bo(bo)->pending = push;
+		}
+	}
+}
+
+static void
+mock_pushbuf_flush(struct nouveau_pushbuf *push)
+{
+	struct mock_pushbuf *mpush = mock_pushbuf(push);
+	struct mock_bo *nvbo;
+
+	if (push->kick_notify)
+		push->kick_notify(push);
+	counters.kicks++;
+
+	if (push->cur != mpush->start) {
+		if (sink)
+			sink(sink_priv, push, mpush->start, push->cur);
+		counters.dwords += push->cur - mpush->start;
+	}
+
+	for (nvbo = bos; nvbo; nvbo = nvbo->next) {
+		if (nvbo->pending == push)
+			nvbo->pending = NULL;
+	}
+
+	push->cur = mpush->start;
+	push->end = mpush->start + mpush->size;
+}
+
+int
+nouveau_pushbuf_space(struct nouveau_pushbuf *push, uint32_t dwords,
+		      uint32_t relocs, uint32_t pushes)
+{
+	if (dwords > mock_pushbuf(push)->size)
+		return -EINVAL;
+
+	if (push->end - push->cur < dwords) {
+		mock_pushbuf_flush(push);
+		mock_pushbuf_pend(push);
+	}
+
+	return 0;
+}
+
+void
+nouveau_pushbuf_data(struct nouveau_pushbuf *push, struct nouveau_bo *bo,
+		     uint64_t offset, uint64_t length)
+{
+	/* the driver only ever writes to the pushbuf directly */
+	abort();
+}
+
+int
+nouveau_pushbuf_refn(struct nouveau_pushbuf *push,
+		     struct nouveau_pushbuf_refn *refs, int nr)
+{
+	int i;
+
+	for (i = 0; i < nr; i++)
+		mock_bo(refs[i].bo)->pending = push;
+	return 0;
+}
+
+void
+nouveau_pushbuf_reloc(struct nouveau_pushbuf *push, struct nouveau_bo *bo,
+		      uint32_t data, uint32_t flags, uint32_t vor, uint32_t tor)
+{
+	uint64_t addr = bo->offset + data;
+
+	if (flags & NOUVEAU_BO_LOW)
+		data = addr;
+	else
+	if (flags & NOUVEAU_BO_HIGH)
+		data = addr >> 32;
+
+	if (flags & NOUVEAU_BO_OR)
+		data |= (bo->flags & NOUVEAU_BO_VRAM) ? vor : tor;
+
+	mock_bo(bo)->pending = push;
+	counters.relocs++;
+	*push->cur++ = data;
+}
+
+int
+nouveau_pushbuf_validate(struct nouveau_pushbuf *push)
+{
+	counters.validates++;
+	mock_pushbuf_pend(push);
+	return 0;
+}
+
+uint32_t
+nouveau_pushbuf_refd(struct nouveau_pushbuf *push, struct nouveau_bo *bo)
+{
+	return mock_bo(bo)->pending == push ? NOUVEAU_BO_RDWR : 0;
+}
+
+int
+nouveau_pushbuf_kick(struct nouveau_pushbuf *push,
+		     struct nouveau_object *chan)
+{
+	mock_pushbuf_flush(push);
+	mock_pushbuf_pend(push);
+	return 0;
+}
+
+struct nouveau_bufctx *
+nouveau_pushbuf_bufctx(struct nouveau_pushbuf *push,
+		       struct nouveau_bufctx *bctx)
+{
+	struct nouveau_bufctx *prev = push->bufctx;
+
+	push->bufctx = bctx;
+	return prev;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2014 Nouveau Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Server functions the acceleration code links against.
+ *
+ * None of the X server headers are included here: the functions that are
+ * reached only need their arguments passed through, and the ones that
+ * aren't (glyphs, trapezoids, windows, the CRTC code of the other source
+ * files) abort, so neither has to follow the prototypes of every
+ * server version.  The ones that look inside server structures are in
+ * harness.c.
+ */
+
+#define UNREACHED(name) void name(void) { abort(); }
+
+void
+ErrorF(const char *f, ...)
+{
+	va_list args;
+
+	va_start(args, f);
+	vfprintf(stderr, f, args);
+	va_end(args);
+}
+
+void
+xf86DrvMsg(int scrnIndex, int type, const char *format, ...)
+{
+	va_list args;
+
+	if (!getenv("NOUVEAU_TEST_VERBOSE"))
+		return;
+
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+}
+
+uint32_t
+GetTimeInMillis(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* the bo cache expires entries from a timer, they just stay around here */
+void *
+TimerSet(void *timer, int flags, uint32_t millis, void *func, void *arg)
+{
+	return timer;
+}
+
+void
+TimerFree(void *timer)
+{
+}
+
+/* the Xv filter table NV30/NV40 put in the scratch bo, from nouveau_xv.c */
+void
+NVXVComputeBicubicFilter(void *bo, unsigned offset, unsigned size)
+{
+}
+
+UNREACHED(CompositePicture)
+UNREACHED(CreatePicture)
+UNREACHED(FreePicture)
+UNREACHED(FreeScratchGC)
+UNREACHED(GetGlyphPicture)
+UNREACHED(GetScratchGC)
+UNREACHED(GlyphExtents)
+UNREACHED(MakeAtom)
+UNREACHED(PictureMatchFormat)
+UNREACHED(RegionDestroy)
+UNREACHED(RegionFromRects)
+UNREACHED(RegionTranslate)
+UNREACHED(SetPictureFilter)
+UNREACHED(SetPictureTransform)
+UNREACHED(ValidateGC)
+UNREACHED(dixChangeWindowProperty)
+UNREACHED(miTrapezoidBounds)
+
+UNREACHED(drmmode_head)
+UNREACHED(nouveau_pick_best_crtc)
@@ -0,0 +1,300 @@
+/*
+ * Copyright 2014 Nouveau Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "harness.h"
+
+/* Submission cost of the EXA hooks, per generation
+ *
+ * Every op is run through the hooks EXA would call, against the mock
+ * libdrm_nouveau, and charged for the dwords, kicks, validates and
+ * relocations it caused, along with the CPU time it took.  None of it
+ * says anything about how long the GPU would take; it's meant for
+ * comparing the CPU side of submission paths between changes.
+ *
+ * Fails if a hook the driver installed refuses an op it's expected to
+ * accelerate.
+ */
+
+#define BENCH_SIZE 256
+
+struct bench {
+	struct harness *h;
+	PixmapPtr src, dst, src32, dst32;
+	char *mem;
+};
+
+struct bench_op {
+	const char *name;
+	Bool (*run)(struct bench *);
+};
+
+static Bool
+bench_solid(struct bench *b)
+{
+	ExaDriverPtr exa = b->h->exa;
+
+	if (!exa->PrepareSolid(b->dst, GXcopy, ~0, 0x00ff8000))
+		return FALSE;
+	exa->Solid(b->dst, 16, 16, 80, 80);
+	exa->DoneSolid(b->dst);
+	return TRUE;
+}
+
+/* PolyFillRect, one Prepare for a batch of small boxes */
+static Bool
+bench_solid_batch(struct bench *b)
+{
+	ExaDriverPtr exa = b->h->exa;
+	int i;
+
+	if (!exa->PrepareSolid(b->dst, GXcopy, ~0, 0x00ff8000))
+		return FALSE;
+	for (i = 0; i < 32; i++)
+		exa->Solid(b->dst, i * 8, i * 4, i * 8 + 6, i * 4 + 3);
+	exa->DoneSolid(b->dst);
+	return TRUE;
+}
+
+static Bool
+bench_copy(struct bench *b)
+{
+	ExaDriverPtr exa = b->h->exa;
+
+	if (!exa->PrepareCopy(b->src, b->dst, 1, 1, GXcopy, ~0))
+		return FALSE;
+	exa->Copy(b->dst, 0, 0, 32, 32, 64, 64);
+	exa->DoneCopy(b->dst);
+	return TRUE;
+}
+
+static Bool
+bench_composite(struct bench *b, int op, int nr)
+{
+	ExaDriverPtr exa = b->h->exa;
+	PicturePtr pspict = harness_picture(b->src32, PICT_a8r8g8b8);
+	PicturePtr pdpict = harness_picture(b->dst32, PICT_a8r8g8b8);
+	Bool ret = FALSE;
+	int i;
+
+	if (exa->CheckComposite(op, pspict, NULL, pdpict) &&
+	    exa->PrepareComposite(op, pspict, NULL, pdpict,
+				  b->src32, NULL, b->dst32)) {
+		if (nr == 1) {
+			exa->Composite(b->dst32, 0, 0, 0, 0, 32, 32, 64, 64);
+		} else {
+			for (i = 0; i < nr; i++)
+				exa->Composite(b->dst32, i * 4, 0, 0, 0,
+					       i * 8, i * 4, 7, 12);
+		}
+		exa->DoneComposite(b->dst32);
+		ret = TRUE;
+	}
+
+	harness_picture_destroy(pspict);
+	harness_picture_destroy(pdpict);
+	return ret;
+}
+
+static Bool
+bench_composite_over(struct bench *b)
+{
+	return bench_composite(b, PictOpOver, 1);
+}
+
+/* a run of glyph-sized rects, like a line of text */
+static Bool
+bench_composite_batch(struct bench *b)
+{
+	return bench_composite(b, PictOpOver, 32);
+}
+
+/* 2D engine blit on NV50+, see nouveau_exa_blit_rect() */
+static Bool
+bench_composite_src(struct bench *b)
+{
+	return bench_composite(b, PictOpSrc, 1);
+}
+
+static Bool
+bench_upload(struct bench *b, int w, int h)
+{
+	return b->h->exa->UploadToScreen(b->dst, 0, 0, w, h, b->mem,
+					 BENCH_SIZE * 4);
+}
+
+static Bool
+bench_upload_small(struct bench *b)
+{
+	return bench_upload(b, 32, 32);
+}
+
+static Bool
+bench_upload_large(struct bench *b)
+{
+	return bench_upload(b, BENCH_SIZE, BENCH_SIZE);
+}
+
+static Bool
+bench_download(struct bench *b)
+{
+	return b->h->exa->DownloadFromScreen(b->src, 0, 0, BENCH_SIZE,
+					     BENCH_SIZE, b->mem,
+					     BENCH_SIZE * 4);
+}
+
+static const struct bench_op
+bench_ops[] = {
+	{ "solid", bench_solid },
+	{ "solid x32", bench_solid_batch },
+	{ "copy", bench_copy },
+	{ "composite over", bench_composite_over },
+	{ "composite x32", bench_composite_batch },
+	{ "composite src", bench_composite_src },
+	{ "upload 4KiB", bench_upload_small },
+	{ "upload 256KiB", bench_upload_large },
+	{ "download 256KiB", bench_download },
+	{}
+};
+
+static const struct {
+	const char *name;
+	uint32_t chipset;
+} bench_chipsets[] = {
+	{ "NV05", 0x05 },
+	{ "NV11", 0x11 },
+	{ "NV34", 0x34 },
+	{ "NV43", 0x43 },
+	{ "NV50", 0x50 },
+	{ "NVA3", 0xa3 },
+	{ "NVC0", 0xc0 },
+	{ "NVE4", 0xe4 },
+	{ "GM107", 0x117 },
+	{}
+};
+
+static double
+bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static Bool
+bench_run(struct harness *h, int iterations)
+{
+	struct bench b = { .h = h };
+	const struct bench_op *op;
+	Bool ret = TRUE;
+	int i;
+
+	b.src = harness_pixmap(h, BENCH_SIZE, BENCH_SIZE, 24, 0);
+	b.dst = harness_pixmap(h, BENCH_SIZE, BENCH_SIZE, 24, 0);
+	b.src32 = harness_pixmap(h, BENCH_SIZE, BENCH_SIZE, 32, 0);
+	b.dst32 = harness_pixmap(h, BENCH_SIZE, BENCH_SIZE, 32, 0);
+	b.mem = calloc(BENCH_SIZE * BENCH_SIZE, 4);
+	if (!b.src || !b.dst || !b.src32 || !b.dst32 || !b.mem) {
+		printf("%s: out of memory\n", h->name);
+		return FALSE;
+	}
+
+	printf("\n%s\n", h->name);
+	printf("%-16s %10s %10s %10s %10s %10s\n", "op", "dw/op",
+	       "kicks/op", "valid/op", "relocs/op", "ns/op");
+
+	for (op = bench_ops; op->name; op++) {
+		struct mock_counters c0, c1;
+		double t0, t1;
+
+		if (!h->exa->PrepareComposite && !strncmp(op->name, "composite", 9))
+			continue;
+
+		mock_counters_read(&c0);
+		t0 = bench_now();
+		for (i = 0; i < iterations; i++) {
+			if (!op->run(&b))
+				break;
+		}
+		t1 = bench_now();
+		mock_counters_read(&c1);
+
+		if (i < iterations) {
+			printf("%-16s refused\n", op->name);
+			ret = FALSE;
+			continue;
+		}
+
+		printf("%-16s %10.2f %10.3f %10.3f %10.2f %10.0f\n", op->name,
+		       (double)(c1.dwords - c0.dwords) / iterations,
+		       (double)(c1.kicks - c0.kicks) / iterations,
+		       (double)(c1.validates - c0.validates) / iterations,
+		       (double)(c1.relocs - c0.relocs) / iterations,
+		       (t1 - t0) / iterations);
+	}
+
+	free(b.mem);
+	harness_pixmap_destroy(h, b.dst32);
+	harness_pixmap_destroy(h, b.src32);
+	harness_pixmap_destroy(h, b.dst);
+	harness_pixmap_destroy(h, b.src);
+	return ret;
+}
+
+int
+main(int argc, char *argv[])
+{
+	int iterations = (argc > 1) ? atoi(argv[1]) : 1000;
+	Bool ret = TRUE;
+	int i, ce;
+
+	for (i = 0; bench_chipsets[i].name; i++) {
+		for (ce = 0; ce < 2; ce++) {
+			struct harness h;
+			char name[32];
+
+			snprintf(name, sizeof(name), "%s%s",
+				 bench_chipsets[i].name, ce ? ", copy engine" : "");
+			if (!harness_init(&h, name, bench_chipsets[i].chipset,
+					  ce)) {
+				printf("%s: init failed\n", name);
+				ret = FALSE;
+				continue;
+			}
+
+			/* no copy engine on this one, nothing to compare */
+			if (ce && !h.nv.ce_rect) {
+				harness_fini(&h);
+				continue;
+			}
+
+			if (!bench_run(&h, iterations))
+				ret = FALSE;
+			harness_fini(&h);
+		}
+	}
+
+	return ret ? 0 : 1;
+}
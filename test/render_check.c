@@ -0,0 +1,727 @@
+/*
+ * Copyright 2014 Nouveau Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#include "harness.h"
+#include "emu.h"
+#include "nvc0_accel.h"
+
+/* What the NV50+ EXA hooks draw, against images drawn on the CPU
+ *
+ * Each hook is run on the mock channels with the engines emulated (see
+ * emu.c), on tiled and linear pixmaps filled with noise, and the result
+ * is compared against the same operation done on a copy of the pixmap in
+ * host memory.  Solid fills go through the batched exa_solid_boxes()
+ * as well as Solid(), copies through the 2D engine, and uploads and
+ * downloads through every path the driver has: SIFC, M2MF (P2MF's the
+ * Kepler equivalent for small inline writes), and the copy engines.
+ * CPU access to tiled pixmaps goes through their linear mirror.
+ *
+ * The 3D engine isn't emulated, radial gradients are checked by running
+ * what the PFP_R* fragment programs compute on the CPU instead.
+ */
+
+#define CHECK_W 200
+#define CHECK_H 150
+
+/* all of it, then a small rectangle at an odd position on top */
+static const BoxRec check_rects[] = {
+	{ 0, 0, CHECK_W, CHECK_H },
+	{ 33, 17, 33 + 45, 17 + 20 },
+};
+#define CHECK_RECTS (sizeof(check_rects) / sizeof(check_rects[0]))
+
+#define CHECK_PUSH_DWORDS 37
+
+/* the upload paths, in nouveau_exa.c's order */
+enum {
+	CHECK_UPLOAD_INLINE = 0,
+	CHECK_UPLOAD_M2MF,
+	CHECK_UPLOAD_COPY,
+};
+
+struct check {
+	struct harness *h;
+	struct emu *emu;
+	uint32_t seed;
+	int errors;
+	int failed;
+};
+
+struct image {
+	PixmapPtr ppix;
+	int cpp, pitch;
+	uint8_t *ref;
+};
+
+static uint32_t
+check_rand(struct check *c)
+{
+	c->seed = c->seed * 1103515245 + 12345;
+	return c->seed >> 8;
+}
+
+static void
+check_kick(struct check *c)
+{
+	NVPtr pNv = &c->h->nv;
+
+	PUSH_KICK(pNv->pushbuf);
+	if (pNv->ce_pushbuf)
+		PUSH_KICK(pNv->ce_pushbuf);
+}
+
+static void
+check_result(struct check *c, const char *what, Bool ok)
+{
+	int errors = emu_errors(c->emu);
+
+	if (errors != c->errors) {
+		c->errors = errors;
+		printf("%s: %-32s emulation failed\n", c->h->name, what);
+		ok = FALSE;
+	} else {
+		printf("%s: %-32s %s\n", c->h->name, what, ok ? "ok" : "FAIL");
+	}
+
+	if (!ok)
+		c->failed++;
+}
+
+static uint32_t
+image_get(struct image *img, int x, int y)
+{
+	uint32_t v = 0;
+
+	memcpy(&v, img->ref + y * img->pitch + x * img->cpp, img->cpp);
+	return v;
+}
+
+static void
+image_put(struct image *img, int x, int y, uint32_t v)
+{
+	memcpy(img->ref + y * img->pitch + x * img->cpp, &v, img->cpp);
+}
+
+/* a pixmap, and its reference copy, full of noise */
+static Bool
+image_new(struct check *c, struct image *img, int depth, int usage_hint)
+{
+	int i;
+
+	img->ppix = harness_pixmap(c->h, CHECK_W, CHECK_H, depth, usage_hint);
+	if (!img->ppix)
+		return FALSE;
+
+	img->cpp = img->ppix->drawable.bitsPerPixel / 8;
+	img->pitch = CHECK_W * img->cpp;
+	img->ref = malloc(img->pitch * CHECK_H);
+	if (!img->ref) {
+		harness_pixmap_destroy(c->h, img->ppix);
+		return FALSE;
+	}
+
+	for (i = 0; i < img->pitch * CHECK_H; i++)
+		img->ref[i] = check_rand(c);
+
+	emu_write(c->emu, harness_pixmap_bo(img->ppix), 0,
+		  exaGetPixmapPitch(img->ppix), 0, 0, img->pitch, CHECK_H,
+		  img->ref, img->pitch);
+	return TRUE;
+}
+
+static void
+image_del(struct check *c, struct image *img)
+{
+	free(img->ref);
+	harness_pixmap_destroy(c->h, img->ppix);
+}
+
+/* what's in the pixmap after everything queued has run, against the
+ * reference
+ */
+static Bool
+image_compare(struct check *c, struct image *img)
+{
+	uint8_t *mem = malloc(img->pitch * CHECK_H);
+	Bool ok = TRUE;
+	int x, y;
+
+	if (!mem)
+		return FALSE;
+
+	check_kick(c);
+	emu_read(c->emu, harness_pixmap_bo(img->ppix), 0,
+		 exaGetPixmapPitch(img->ppix), 0, 0, img->pitch, CHECK_H,
+		 mem, img->pitch);
+
+	for (y = 0; y < CHECK_H && ok; y++) {
+		for (x = 0; x < CHECK_W && ok; x++) {
+			uint32_t want = image_get(img, x, y), got = 0;
+
+			memcpy(&got, mem + y * img->pitch + x * img->cpp,
+			       img->cpp);
+			if (got != want) {
+				printf("  (%d, %d) is 0x%08x, should be "
+				       "0x%08x\n", x, y, got, want);
+				ok = FALSE;
+			}
+		}
+	}
+
+	free(mem);
+	return ok;
+}
+
+/* X's raster op on source and destination, then the planemask */
+static uint32_t
+check_alu(int alu, Pixel planemask, uint32_t s, uint32_t d)
+{
+	uint32_t r = 0;
+	int i;
+
+	/* bit 3 - (s << 1 | d) of alu is the result for one pair of bits */
+	for (i = 0; i < 4; i++) {
+		if (alu & (1 << i))
+			r |= ((i & 2) ? ~s : s) & ((i & 1) ? ~d : d);
+	}
+
+	return (r & planemask) | (d & ~planemask);
+}
+
+static void
+check_box(struct check *c, BoxPtr box)
+{
+	box->x1 = check_rand(c) % CHECK_W;
+	box->y1 = check_rand(c) % CHECK_H;
+	box->x2 = box->x1 + 1 + check_rand(c) % (CHECK_W - box->x1);
+	box->y2 = box->y1 + 1 + check_rand(c) % (CHECK_H - box->y1);
+}
+
+static void
+check_fill_ref(struct image *img, BoxPtr box, int alu, Pixel planemask,
+	       Pixel fg)
+{
+	uint32_t mask = (img->cpp == 4) ? ~0 : (1 << (img->cpp * 8)) - 1;
+	int x, y;
+
+	for (y = box->y1; y < box->y2; y++) {
+		for (x = box->x1; x < box->x2; x++) {
+			uint32_t d = image_get(img, x, y);
+
+			image_put(img, x, y,
+				  check_alu(alu, planemask, fg, d) & mask);
+		}
+	}
+}
+
+/* more boxes than fit in one method group, then single ones with a
+ * raster op and planemask
+ */
+static void
+check_fill(struct check *c, const char *what, int depth, int usage_hint)
+{
+	ExaDriverPtr exa = c->h->exa;
+	NVPtr pNv = &c->h->nv;
+	Pixel fg, planemask = (depth == 16) ? 0xf81f : 0x00ff00ff;
+	struct image img;
+	BoxRec box[100];
+	Bool ok;
+	int i;
+
+	if (!image_new(c, &img, depth, usage_hint)) {
+		check_result(c, what, FALSE);
+		return;
+	}
+
+	fg = check_rand(c);
+	ok = exa->PrepareSolid(img.ppix, GXcopy, ~0, fg);
+	if (ok) {
+		for (i = 0; i < 100; i++) {
+			check_box(c, &box[i]);
+			check_fill_ref(&img, &box[i], GXcopy, ~0, fg);
+		}
+		pNv->exa_solid_boxes(img.ppix, box, 100);
+		exa->DoneSolid(img.ppix);
+	}
+
+	fg = check_rand(c);
+	if (ok)
+		ok = exa->PrepareSolid(img.ppix, GXxor, planemask, fg);
+	if (ok) {
+		for (i = 0; i < 8; i++) {
+			check_box(c, &box[i]);
+			check_fill_ref(&img, &box[i], GXxor, planemask, fg);
+			exa->Solid(img.ppix, box[i].x1, box[i].y1,
+				   box[i].x2, box[i].y2);
+		}
+		exa->DoneSolid(img.ppix);
+	}
+
+	check_result(c, what, ok && image_compare(c, &img));
+	image_del(c, &img);
+}
+
+static void
+check_copy_ref(struct image *src, struct image *dst, int sx, int sy,
+	       int dx, int dy, int w, int h)
+{
+	uint32_t *tmp = malloc(w * h * sizeof(*tmp));
+	int x, y;
+
+	for (y = 0; y < h; y++) {
+		for (x = 0; x < w; x++)
+			tmp[y * w + x] = image_get(src, sx + x, sy + y);
+	}
+
+	for (y = 0; y < h; y++) {
+		for (x = 0; x < w; x++)
+			image_put(dst, dx + x, dy + y, tmp[y * w + x]);
+	}
+
+	free(tmp);
+}
+
+/* between pixmaps, tiled to linear and back, and within one */
+static void
+check_copy(struct check *c, const char *what, int src_hint, int dst_hint)
+{
+	ExaDriverPtr exa = c->h->exa;
+	struct image src, dst;
+	Bool ok;
+	int i;
+
+	if (!image_new(c, &src, 24, src_hint)) {
+		check_result(c, what, FALSE);
+		return;
+	}
+	if (!image_new(c, &dst, 24, dst_hint)) {
+		image_del(c, &src);
+		check_result(c, what, FALSE);
+		return;
+	}
+
+	ok = exa->PrepareCopy(src.ppix, dst.ppix, 1, 1, GXcopy, ~0);
+	if (ok) {
+		for (i = 0; i < 16; i++) {
+			BoxRec box;
+			int dx, dy;
+
+			check_box(c, &box);
+			dx = check_rand(c) % (CHECK_W - (box.x2 - box.x1) + 1);
+			dy = check_rand(c) % (CHECK_H - (box.y2 - box.y1) + 1);
+			check_copy_ref(&src, &dst, box.x1, box.y1, dx, dy,
+				       box.x2 - box.x1, box.y2 - box.y1);
+			exa->Copy(dst.ppix, box.x1, box.y1, dx, dy,
+				  box.x2 - box.x1, box.y2 - box.y1);
+		}
+		exa->DoneCopy(dst.ppix);
+	}
+
+	if (ok)
+		ok = exa->PrepareCopy(dst.ppix, dst.ppix, 1, 1, GXcopy, ~0);
+	if (ok) {
+		check_copy_ref(&dst, &dst, 10, 10, 13, 17, 120, 90);
+		exa->Copy(dst.ppix, 10, 10, 13, 17, 120, 90);
+		exa->DoneCopy(dst.ppix);
+	}
+
+	check_result(c, what, ok && image_compare(c, &src) &&
+			      image_compare(c, &dst));
+	image_del(c, &dst);
+	image_del(c, &src);
+}
+
+static void
+check_upload(struct check *c, const char *what, int method, int usage_hint)
+{
+	ExaDriverPtr exa = c->h->exa;
+	NVPtr pNv = &c->h->nv;
+	struct image img;
+	Bool ok = TRUE;
+	uint8_t *mem;
+	int i, j;
+
+	memset(pNv->upload_method, method, sizeof(pNv->upload_method));
+
+	if (!image_new(c, &img, 24, usage_hint)) {
+		check_result(c, what, FALSE);
+		return;
+	}
+
+	mem = malloc(img.pitch * CHECK_H);
+	for (i = 0; mem && ok && i < CHECK_RECTS; i++) {
+		const BoxRec *r = &check_rects[i];
+		int w = r->x2 - r->x1, h = r->y2 - r->y1;
+
+		for (j = 0; j < img.pitch * h; j++)
+			mem[j] = check_rand(c);
+		for (j = 0; j < h; j++)
+			memcpy(img.ref + (r->y1 + j) * img.pitch +
+			       r->x1 * img.cpp, mem + j * img.pitch,
+			       w * img.cpp);
+
+		ok = exa->UploadToScreen(img.ppix, r->x1, r->y1, w, h,
+					 (char *)mem, img.pitch);
+	}
+
+	check_result(c, what, mem && ok && image_compare(c, &img));
+	free(mem);
+	image_del(c, &img);
+}
+
+static void
+check_download(struct check *c, const char *what, int usage_hint)
+{
+	ExaDriverPtr exa = c->h->exa;
+	struct image img;
+	Bool ok = TRUE;
+	uint8_t *mem;
+	int i, j;
+
+	if (!image_new(c, &img, 24, usage_hint)) {
+		check_result(c, what, FALSE);
+		return;
+	}
+
+	mem = malloc(img.pitch * CHECK_H);
+	for (i = 0; mem && ok && i < CHECK_RECTS; i++) {
+		const BoxRec *r = &check_rects[i];
+		int w = r->x2 - r->x1, h = r->y2 - r->y1;
+
+		ok = exa->DownloadFromScreen(img.ppix, r->x1, r->y1, w, h,
+					     (char *)mem, img.pitch);
+		for (j = 0; ok && j < h; j++) {
+			if (memcmp(img.ref + (r->y1 + j) * img.pitch +
+				   r->x1 * img.cpp, mem + j * img.pitch,
+				   w * img.cpp)) {
+				printf("  line %d of (%d, %d) %dx%d differs\n",
+				       j, r->x1, r->y1, w, h);
+				ok = FALSE;
+			}
+		}
+	}
+
+	check_result(c, what, mem && ok);
+	free(mem);
+	image_del(c, &img);
+}
+
+/* CPU access to a tiled pixmap through its linear mirror, twice so the
+ * second time round it's the mirror kept from the first
+ */
+static void
+check_mirror(struct check *c, const char *what)
+{
+	ExaDriverPtr exa = c->h->exa;
+	NVPtr pNv = &c->h->nv;
+	struct image img;
+	Bool ok = TRUE;
+	int i, y;
+
+	pNv->linear_mirror = TRUE;
+	if (!image_new(c, &img, 24, 0)) {
+		check_result(c, what, FALSE);
+		return;
+	}
+
+	for (i = 0; ok && i < 2; i++) {
+		char *map;
+
+		ok = exa->PrepareAccess(img.ppix, EXA_PREPARE_DEST);
+		map = img.ppix->devPrivate.ptr;
+		for (y = 0; ok && y < CHECK_H; y++) {
+			if (memcmp(map + y * exaGetPixmapPitch(img.ppix),
+				   img.ref + y * img.pitch, img.pitch)) {
+				printf("  line %d of the mirror differs\n", y);
+				ok = FALSE;
+			}
+		}
+
+		if (ok) {
+			for (y = 20; y < 20 + 10 * (i + 1); y++) {
+				uint32_t v = check_rand(c);
+
+				image_put(&img, 3 * y, y, v);
+				memcpy(map + y * exaGetPixmapPitch(img.ppix) +
+				       3 * y * img.cpp, &v, img.cpp);
+			}
+			exa->FinishAccess(img.ppix, EXA_PREPARE_DEST);
+			ok = image_compare(c, &img);
+		}
+	}
+
+	image_del(c, &img);
+	check_result(c, what, ok && !pNv->mirrors && !pNv->mirror_size);
+	pNv->linear_mirror = FALSE;
+}
+
+/* PUSH_DATAu(), through M2MF on Fermi and P2MF after */
+static void
+check_push_data(struct check *c)
+{
+	struct nouveau_pushbuf *push = c->h->nv.pushbuf;
+	struct nouveau_bo *bo = NULL;
+	uint32_t data[CHECK_PUSH_DWORDS];
+	Bool ok = FALSE;
+	int i;
+
+	for (i = 0; i < CHECK_PUSH_DWORDS; i++)
+		data[i] = check_rand(c);
+
+	if (!nouveau_bo_new(c->h->nv.dev, NOUVEAU_BO_GART | NOUVEAU_BO_MAP,
+			    0, 4096, NULL, &bo) &&
+	    PUSH_SPACE(push, 64)) {
+		PUSH_DATAu(push, bo, 1024, CHECK_PUSH_DWORDS);
+		PUSH_DATAp(push, data, CHECK_PUSH_DWORDS);
+		check_kick(c);
+
+		nouveau_bo_map(bo, 0, NULL);
+		ok = !memcmp((char *)bo->map + 1024, data, sizeof(data));
+	}
+
+	check_result(c, "push data", ok);
+	nouveau_bo_ref(NULL, &bo);
+}
+
+static xFixed
+check_fixed(double v)
+{
+	return (xFixed)(v * 65536.0);
+}
+
+/* t as pixman finds it: the larger root of the circle equation with a
+ * radius >= 0
+ */
+static Bool
+check_radial_ref(double x, double y, double x1, double y1, double r1,
+		 double x2, double y2, double r2, double *t)
+{
+	double cdx = x2 - x1, cdy = y2 - y1, dr = r2 - r1;
+	double px = x - x1, py = y - y1;
+	double a = cdx * cdx + cdy * cdy - dr * dr;
+	double b = px * cdx + py * cdy + r1 * dr;
+	double cc = px * px + py * py - r1 * r1;
+	double d = b * b - a * cc, t0, t1;
+
+	if (d < 0.0)
+		return FALSE;
+
+	t0 = (b + sqrt(d)) / a;
+	t1 = (b - sqrt(d)) / a;
+	if (t1 > t0) {
+		double tmp = t0;
+		t0 = t1;
+		t1 = tmp;
+	}
+
+	if (r1 + t0 * dr >= 0.0)
+		*t = t0;
+	else
+	if (r1 + t1 * dr >= 0.0)
+		*t = t1;
+	else
+		return FALSE;
+	return TRUE;
+}
+
+/* nouveau_exa_gradient() for a radial gradient, through a scaling
+ * transform, then the PFP_R* programs' math at each sample point, and the
+ * ramp texel that lands on against the stops
+ */
+static void
+check_radial(struct check *c, const char *what, double x1, double y1,
+	     double r1, double x2, double y2, double r2)
+{
+	PictGradientStop stops[2] = {
+		{ .x = 0x00000, .color = { 0xffff, 0x0000, 0x0000, 0xffff } },
+		{ .x = 0x10000, .color = { 0x0000, 0x0000, 0xffff, 0xffff } },
+	};
+	PictTransform transform = { .matrix = {
+		{ 0x20000, 0, 0 }, { 0, 0x20000, 0 }, { 0, 0, 0x10000 },
+	} };
+	SourcePict sp = { .type = SourcePictTypeRadial };
+	PictureRec pict = { .pSourcePict = &sp, .transform = &transform };
+	uint32_t ramp[NOUVEAU_GRADIENT_TEXELS];
+	float m[9], k[2];
+	Bool upload, ok;
+	int x, y, slot;
+
+	sp.radial.nstops = 2;
+	sp.radial.stops = stops;
+	sp.radial.c1.x = check_fixed(x1);
+	sp.radial.c1.y = check_fixed(y1);
+	sp.radial.c1.radius = check_fixed(r1);
+	sp.radial.c2.x = check_fixed(x2);
+	sp.radial.c2.y = check_fixed(y2);
+	sp.radial.c2.radius = check_fixed(r2);
+
+	ok = nouveau_exa_gradient(&pict, ramp, m, k);
+	for (y = 0; ok && y < CHECK_H; y += 3) {
+		for (x = 0; ok && x < CHECK_W; x += 3) {
+			double w = m[6] * x + m[7] * y + m[8];
+			double u = (m[0] * x + m[1] * y + m[2]) / w;
+			double v = (m[3] * x + m[4] * y + m[5]) / w;
+			double t = k[0] * u + k[1] + sqrt(u * u + v * v), ref;
+			int i = floor(t * NOUVEAU_GRADIENT_TEXELS);
+			uint32_t blue;
+
+			if (!check_radial_ref(x * 2.0, y * 2.0, x1, y1, r1,
+					      x2, y2, r2, &ref) ||
+			    fabs(t - (r2 < r1 ? 1.0 - ref : ref)) > 1e-3) {
+				ok = FALSE;
+				break;
+			}
+
+			/* the ramp goes from red to blue */
+			if (ref < 0.0 || ref >= 1.0 || i < 0 ||
+			    i >= NOUVEAU_GRADIENT_TEXELS)
+				continue;
+			blue = ramp[i] & 0xff;
+			if (fabs(blue / 255.0 - ref) >
+			    2.0 / NOUVEAU_GRADIENT_TEXELS + 1.0 / 255.0)
+				ok = FALSE;
+		}
+	}
+
+	/* and the second time round it's still in the same slot */
+	if (ok) {
+		slot = nouveau_exa_gradient_slot(&c->h->nv, ramp, &upload);
+		ok = nouveau_exa_gradient_slot(&c->h->nv, ramp, &upload) ==
+		     slot && !upload;
+	}
+
+	check_result(c, what, ok);
+}
+
+static void
+check_run(struct check *c)
+{
+	NVPtr pNv = &c->h->nv;
+
+	check_fill(c, "fill, tiled", 24, 0);
+	check_fill(c, "fill, linear", 24, NOUVEAU_CREATE_PIXMAP_SCANOUT);
+	check_fill(c, "fill, 16bpp tiled", 16, 0);
+	check_copy(c, "copy, tiled to tiled", 0, 0);
+	check_copy(c, "copy, tiled to linear", 0,
+		   NOUVEAU_CREATE_PIXMAP_SCANOUT);
+	check_copy(c, "copy, linear to tiled", NOUVEAU_CREATE_PIXMAP_SCANOUT,
+		   0);
+
+	check_upload(c, "upload inline, tiled", CHECK_UPLOAD_INLINE, 0);
+	check_upload(c, "upload inline, linear", CHECK_UPLOAD_INLINE,
+		     NOUVEAU_CREATE_PIXMAP_SCANOUT);
+	if (pNv->ce_enabled) {
+		check_upload(c, "upload copy engine, tiled",
+			     CHECK_UPLOAD_COPY, 0);
+		check_upload(c, "upload copy engine, linear",
+			     CHECK_UPLOAD_COPY, NOUVEAU_CREATE_PIXMAP_SCANOUT);
+		check_download(c, "download copy engine, tiled", 0);
+		check_download(c, "download copy engine, linear",
+			       NOUVEAU_CREATE_PIXMAP_SCANOUT);
+	} else {
+		check_upload(c, "upload m2mf, tiled", CHECK_UPLOAD_M2MF, 0);
+		check_upload(c, "upload m2mf, linear", CHECK_UPLOAD_M2MF,
+			     NOUVEAU_CREATE_PIXMAP_SCANOUT);
+		check_download(c, "download m2mf, tiled", 0);
+		check_download(c, "download m2mf, linear",
+			       NOUVEAU_CREATE_PIXMAP_SCANOUT);
+	}
+
+	check_mirror(c, "linear mirror");
+
+	if (pNv->Architecture >= NV_FERMI)
+		check_push_data(c);
+
+	check_radial(c, "radial gradient, concentric",
+		     150.0, 100.0, 0.0, 150.0, 100.0, 250.0);
+	check_radial(c, "radial gradient, focal",
+		     120.0, 90.0, 10.0, 180.0, 150.0, 300.0);
+	check_radial(c, "radial gradient, shrinking",
+		     200.0, 150.0, 320.0, 170.0, 120.0, 40.0);
+}
+
+static const struct {
+	const char *name;
+	uint32_t chipset;
+} check_chipsets[] = {
+	{ "NV50", 0x50 },
+	{ "NVA3", 0xa3 },
+	{ "NVC0", 0xc0 },
+	{ "NVE4", 0xe4 },
+	{ "GM107", 0x117 },
+	{}
+};
+
+int
+main(int argc, char *argv[])
+{
+	int failed = 0;
+	int i, ce;
+
+	for (i = 0; check_chipsets[i].name; i++) {
+		for (ce = 0; ce < 2; ce++) {
+			struct check c = { .seed = i * 2 + ce + 1 };
+			struct harness h;
+			char name[32];
+
+			snprintf(name, sizeof(name), "%s%s",
+				 check_chipsets[i].name, ce ? ", copy engine" : "");
+
+			/* before the channels are set up, so it sees the
+			 * objects being bound
+			 */
+			c.emu = emu_new(check_chipsets[i].chipset);
+			if (!c.emu) {
+				printf("%s: out of memory\n", name);
+				failed++;
+				continue;
+			}
+
+			if (!harness_init(&h, name, check_chipsets[i].chipset,
+					  ce)) {
+				printf("%s: init failed\n", name);
+				failed++;
+				emu_del(&c.emu);
+				continue;
+			}
+
+			/* no copy engine on this one, nothing to check */
+			if (ce && !h.nv.ce_rect) {
+				harness_fini(&h);
+				emu_del(&c.emu);
+				continue;
+			}
+
+			c.h = &h;
+			check_run(&c);
+			failed += c.failed;
+
+			harness_fini(&h);
+			emu_del(&c.emu);
+		}
+	}
+
+	return failed ? 1 : 0;
+}